@@ -1,5 +1,27 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <new>         // Para ::operator new / placement new
+#include <type_traits> // Para std::is_trivially_destructible
+#include <algorithm>   // Para std::max e std::shuffle
+#include <random>      // Para sortear prioridades e embaralhar entradas
+#include <chrono>      // Para medir tempos no comparativo
+#include <climits>     // Para INT_MAX (preenchimento dos layouts congelados)
+#include <thread>      // Para a ordenação paralela da construção em lote
+#include <iterator>    // Para as categorias de iterador
+#include <cstddef>     // Para ptrdiff_t
+#include <atomic>      // Para a variante concorrente
+#include <mutex>       // Para a referência com trava global
+#include <stdexcept>   // Para runtime_error
+#include <cstdint>     // Para uint32_t (variante indexada)
+#include <cstdio>      // Para FILE* (gravação e carga em arquivo)
+#include <cstring>     // Para memcpy / memcmp
+#ifndef _WIN32
+#include <fcntl.h>     // Para open (ArvoreMapeada)
+#include <sys/mman.h>  // Para mmap / munmap
+#include <sys/stat.h>  // Para fstat
+#include <unistd.h>    // Para close
+#endif
 
 // Usar 'using namespace std;' é comum em exercícios acadêmicos para simplificar.
 using namespace std;
@@ -18,168 +40,2772 @@ struct No {
     }
 };
 
+// -----------------------------------------------------------------
+// ALOCADOR DE NÓS (Arena / Slab com lista livre intrusiva)
+// -----------------------------------------------------------------
+
+/**
+ * @brief Pool de nós alocados em blocos (slabs) contíguos.
+ *
+ * Em vez de um 'new' por nó, os nós são retirados sequencialmente de
+ * blocos grandes, de modo que nós inseridos em sequência ficam vizinhos
+ * na memória (compartilham linhas de cache). Nós liberados entram numa
+ * lista livre intrusiva (o próprio espaço do nó guarda o ponteiro para o
+ * próximo livre) e são reaproveitados nas próximas alocações.
+ * A destruição libera bloco a bloco: O(#blocos), e não O(#nós).
+ */
+template <typename T>
+class PoolDeNos {
+private:
+    static const size_t NOS_POR_BLOCO = 4096;
+
+    // Um nó livre reaproveita o próprio armazenamento como elo da lista.
+    struct Livre {
+        Livre* proximo;
+    };
+
+    static_assert(sizeof(T) >= sizeof(Livre), "No pequeno demais para a lista livre");
+    static_assert(is_trivially_destructible<T>::value,
+                  "PoolDeNos libera blocos inteiros sem chamar destrutores");
+
+    vector<T*> blocos; // Todos os blocos alocados
+    T* cursor;         // Próxima posição nunca usada do bloco atual
+    T* fimBloco;       // Fim do bloco atual
+    Livre* livres;     // Topo da lista livre
+
+    void novoBloco() {
+        T* bloco = static_cast<T*>(::operator new(sizeof(T) * NOS_POR_BLOCO));
+        blocos.push_back(bloco);
+        cursor = bloco;
+        fimBloco = bloco + NOS_POR_BLOCO;
+    }
+
+public:
+    PoolDeNos() : cursor(nullptr), fimBloco(nullptr), livres(nullptr) {}
+
+    // O pool é dono dos blocos: não pode ser copiado.
+    PoolDeNos(const PoolDeNos&) = delete;
+    PoolDeNos& operator=(const PoolDeNos&) = delete;
+
+    ~PoolDeNos() {
+        liberarTudo();
+    }
+
+    /**
+     * @brief Constrói um nó, reaproveitando um espaço livre se houver.
+     */
+    template <typename... Args>
+    T* alocar(Args&&... args) {
+        void* espaco;
+        if (livres != nullptr) {
+            espaco = livres;
+            livres = livres->proximo;
+        } else {
+            if (cursor == fimBloco) {
+                novoBloco();
+            }
+            espaco = cursor++;
+        }
+        return new (espaco) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Devolve um nó ao pool (entra no topo da lista livre).
+     */
+    void liberar(T* no) {
+        Livre* livre = reinterpret_cast<Livre*>(no);
+        livre->proximo = livres;
+        livres = livre;
+    }
+
+    /**
+     * @brief Reserva um bloco próprio com 'quantidade' posições contíguas
+     * (ainda não construídas), usado pela construção em lote.
+     */
+    T* reservarContiguos(size_t quantidade) {
+        T* bloco = static_cast<T*>(::operator new(sizeof(T) * quantidade));
+        blocos.push_back(bloco);
+        return bloco;
+    }
+
+    /**
+     * @brief Libera todos os blocos de uma vez, em O(#blocos).
+     */
+    void liberarTudo() {
+        for (T* bloco : blocos) {
+            ::operator delete(bloco);
+        }
+        blocos.clear();
+        cursor = fimBloco = nullptr;
+        livres = nullptr;
+    }
+};
+
+// -----------------------------------------------------------------
+// ORDENAÇÃO PARALELA (usada pela construção em lote)
+// -----------------------------------------------------------------
+
+/**
+ * @brief Ordena 'v' dividindo-o em uma fatia por núcleo: cada thread
+ * ordena a sua fatia e depois as fatias são mescladas aos pares, também
+ * em paralelo. Para vetores pequenos usa só std::sort.
+ */
+void ordenarEmParalelo(vector<int>& v) {
+    unsigned nucleos = thread::hardware_concurrency();
+    if (nucleos < 2 || v.size() < (1u << 16)) {
+        sort(v.begin(), v.end());
+        return;
+    }
+    // Número de fatias em potência de 2, para as mesclas aos pares.
+    unsigned partes = 1;
+    while (partes * 2 <= nucleos) {
+        partes *= 2;
+    }
+    vector<size_t> limites(partes + 1);
+    for (unsigned i = 0; i <= partes; i++) {
+        limites[i] = v.size() * i / partes;
+    }
+
+    vector<thread> threads;
+    for (unsigned i = 0; i < partes; i++) {
+        threads.emplace_back([&v, &limites, i] {
+            sort(v.begin() + limites[i], v.begin() + limites[i + 1]);
+        });
+    }
+    for (thread& t : threads) t.join();
+
+    for (unsigned largura = 1; largura < partes; largura *= 2) {
+        threads.clear();
+        for (unsigned i = 0; i < partes; i += 2 * largura) {
+            threads.emplace_back([&v, &limites, i, largura] {
+                inplace_merge(v.begin() + limites[i],
+                              v.begin() + limites[i + largura],
+                              v.begin() + limites[i + 2 * largura]);
+            });
+        }
+        for (thread& t : threads) t.join();
+    }
+}
+
+// -----------------------------------------------------------------
+// ARQUIVO BINÁRIO (cabeçalho, escrita em fluxo e leitura conferida)
+// -----------------------------------------------------------------
+
+// Formatos do conteúdo que segue o cabeçalho.
+const uint32_t VERSAO_ARQUIVO = 2; // 2: o checksum cobre também o cabeçalho
+const uint32_t FORMATO_PRE_ORDEM = 1;        // Registros dos nós em Pré-Ordem
+const uint32_t FORMATO_ARRAY_INDEXADO = 2;   // Array de NoIndexado tal como está na memória
+
+/**
+ * @brief Cabeçalho de tamanho fixo no início de todo arquivo de árvore.
+ * Os inteiros são gravados na ordem de bytes da máquina (o arquivo não é
+ * portável entre arquiteturas de endianness diferente).
+ */
+struct CabecalhoArquivo {
+    char magica[4];        // "ABB1"
+    uint32_t versao;
+    uint32_t formato;
+    uint32_t raiz;         // Só no formato de array: índice da raiz
+    uint32_t livres;       // Só no formato de array: topo da lista livre
+    uint32_t reservado;
+    uint64_t registros;    // Nós na Pré-Ordem ou posições do array
+    uint64_t vivos;        // Nós vivos (valores distintos)
+    uint64_t ocorrencias;  // Soma dos contadores (= vivos sem contador)
+    uint64_t checksum;     // FNV-1a de 64 bits do conteúdo e do cabeçalho
+};
+
+static_assert(sizeof(CabecalhoArquivo) == 56, "Cabecalho com preenchimento inesperado");
+
+const uint64_t FNV_BASE = 14695981039346656037ull;
+const uint64_t FNV_PRIMO = 1099511628211ull;
+
+uint64_t fnv1a(uint64_t h, const void* dados, size_t n) {
+    const unsigned char* p = static_cast<const unsigned char*>(dados);
+    for (size_t i = 0; i < n; i++) {
+        h = (h ^ p[i]) * FNV_PRIMO;
+    }
+    return h;
+}
+
+/**
+ * @brief Checksum final do arquivo: continua o FNV-1a do conteúdo sobre o
+ * cabeçalho com o campo checksum zerado. Assim raiz, lista livre e
+ * contagens também são protegidos, e não só os registros.
+ */
+uint64_t checksumDoArquivo(uint64_t checksumDoConteudo, CabecalhoArquivo cabecalho) {
+    cabecalho.checksum = 0;
+    return fnv1a(checksumDoConteudo, &cabecalho, sizeof(cabecalho));
+}
+
+/**
+ * @brief Grava um arquivo de árvore em fluxo: os registros passam por um
+ * buffer fixo de 64 KB, e o cabeçalho (com o checksum, só conhecido no
+ * final) é reescrito no início em finalizar(). Não guarda cópia do conteúdo.
+ */
+class EscritorBinario {
+private:
+    FILE* arquivo;
+    vector<char> buffer;
+    size_t usados;
+    uint64_t checksum;
+
+    void descarregar() {
+        if (usados > 0 && fwrite(buffer.data(), 1, usados, arquivo) != usados) {
+            throw runtime_error("Erro: falha ao gravar o arquivo.");
+        }
+        usados = 0;
+    }
+
+public:
+    explicit EscritorBinario(const string& caminho)
+        : buffer(1 << 16), usados(0), checksum(FNV_BASE) {
+        arquivo = fopen(caminho.c_str(), "wb");
+        if (arquivo == nullptr) {
+            throw runtime_error("Erro: nao foi possivel criar " + caminho);
+        }
+        CabecalhoArquivo vazio = {};
+        if (fwrite(&vazio, sizeof(vazio), 1, arquivo) != 1) {
+            fclose(arquivo);
+            throw runtime_error("Erro: falha ao gravar o arquivo.");
+        }
+    }
+
+    ~EscritorBinario() {
+        if (arquivo != nullptr) fclose(arquivo);
+    }
+
+    EscritorBinario(const EscritorBinario&) = delete;
+    EscritorBinario& operator=(const EscritorBinario&) = delete;
+
+    void escrever(const void* dados, size_t n) {
+        checksum = fnv1a(checksum, dados, n);
+        const char* p = static_cast<const char*>(dados);
+        while (n > 0) {
+            if (usados == buffer.size()) descarregar();
+            size_t parte = min(n, buffer.size() - usados);
+            memcpy(buffer.data() + usados, p, parte);
+            usados += parte;
+            p += parte;
+            n -= parte;
+        }
+    }
+
+    /**
+     * @brief Completa o cabeçalho (mágica, versão, checksum), grava-o no
+     * início do arquivo e fecha.
+     */
+    void finalizar(CabecalhoArquivo cabecalho) {
+        descarregar();
+        memcpy(cabecalho.magica, "ABB1", 4);
+        cabecalho.versao = VERSAO_ARQUIVO;
+        cabecalho.checksum = checksumDoArquivo(checksum, cabecalho);
+        bool ok = fseek(arquivo, 0, SEEK_SET) == 0 &&
+                  fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1;
+        ok = (fclose(arquivo) == 0) && ok;
+        arquivo = nullptr;
+        if (!ok) {
+            throw runtime_error("Erro: falha ao gravar o arquivo.");
+        }
+    }
+};
+
+/**
+ * @brief Confere um cabeçalho lido: mágica, versão, formato esperado e se
+ * o tamanho do conteúdo bate com registros * bytesPorRegistro.
+ */
+void validarCabecalho(const CabecalhoArquivo& c, uint32_t formato, uint64_t bytesDoConteudo,
+                      size_t bytesPorRegistro) {
+    if (memcmp(c.magica, "ABB1", 4) != 0) {
+        throw runtime_error("Erro: o arquivo nao contem uma arvore.");
+    }
+    if (c.versao != VERSAO_ARQUIVO) {
+        throw runtime_error("Erro: versao de arquivo nao suportada.");
+    }
+    if (c.formato != formato) {
+        throw runtime_error("Erro: formato de arquivo inesperado.");
+    }
+    if (c.registros > bytesDoConteudo / bytesPorRegistro ||
+        c.registros * bytesPorRegistro != bytesDoConteudo) {
+        throw runtime_error("Erro: arquivo truncado ou corrompido.");
+    }
+}
+
+/**
+ * @brief Lê um arquivo de árvore em fluxo, com buffer do FILE*, somando o
+ * checksum do que passa; conferirFim() compara com o do cabeçalho.
+ */
+class LeitorBinario {
+private:
+    FILE* arquivo;
+    uint64_t checksum;
+
+public:
+    CabecalhoArquivo cabecalho;
+
+    LeitorBinario(const string& caminho, uint32_t formato, size_t bytesPorRegistro)
+        : checksum(FNV_BASE) {
+        arquivo = fopen(caminho.c_str(), "rb");
+        if (arquivo == nullptr) {
+            throw runtime_error("Erro: nao foi possivel abrir " + caminho);
+        }
+        long tamanho = -1;
+        if (fseek(arquivo, 0, SEEK_END) == 0) tamanho = ftell(arquivo);
+        if (tamanho < (long)sizeof(cabecalho) || fseek(arquivo, 0, SEEK_SET) != 0 ||
+            fread(&cabecalho, sizeof(cabecalho), 1, arquivo) != 1) {
+            fclose(arquivo);
+            throw runtime_error("Erro: arquivo truncado ou corrompido.");
+        }
+        try {
+            validarCabecalho(cabecalho, formato, (uint64_t)tamanho - sizeof(cabecalho),
+                             bytesPorRegistro);
+        } catch (...) {
+            fclose(arquivo);
+            throw;
+        }
+    }
+
+    ~LeitorBinario() {
+        fclose(arquivo);
+    }
+
+    LeitorBinario(const LeitorBinario&) = delete;
+    LeitorBinario& operator=(const LeitorBinario&) = delete;
+
+    void ler(void* destino, size_t n) {
+        if (fread(destino, 1, n, arquivo) != n) {
+            throw runtime_error("Erro: arquivo truncado ou corrompido.");
+        }
+        checksum = fnv1a(checksum, destino, n);
+    }
+
+    void conferirFim() const {
+        if (checksumDoArquivo(checksum, cabecalho) != cabecalho.checksum) {
+            throw runtime_error("Erro: checksum do arquivo nao confere.");
+        }
+    }
+};
+
+// -----------------------------------------------------------------
+// INSTANTÂNEO CONGELADO (Layouts implícitos, sem ponteiros)
+// -----------------------------------------------------------------
+
+/**
+ * @brief Cópia somente-leitura do conteúdo da árvore, em arrays sem ponteiros.
+ *
+ * A partir dos valores em ordem crescente, monta uma árvore binária
+ * completa implícita (altura H, 2^H - 1 posições; as que sobram são
+ * preenchidas com INT_MAX) em dois layouts:
+ *  - Eytzinger (BFS): filhos de k em 2k e 2k+1. A busca não tem desvios
+ *    condicionais e faz prefetch dos descendentes 4 níveis abaixo
+ *    (16 ints = 1 linha de cache).
+ *  - van Emde Boas: a árvore é cortada recursivamente ao meio da altura
+ *    e cada pedaço fica contíguo, o que aproveita o cache em qualquer
+ *    nível da hierarquia sem conhecer o tamanho da linha.
+ * Os valores ordenados também são mantidos, para varreduras de intervalo
+ * sequenciais depois que o lower_bound localiza o início.
+ */
+class ArvoreCongelada {
+private:
+    vector<int> ordenados;  // Valores em ordem (posição = rank)
+    vector<int> eytzinger;  // Layout BFS, 1-indexado (posição 0 não usada)
+    vector<int> veb;        // Layout van Emde Boas, 0-indexado
+    int altura;             // Número de níveis da árvore completa
+
+    // Para cada profundidade d: tamanho da árvore de topo (T), tamanho de
+    // cada árvore de baixo (B) e profundidade da raiz do topo (D) no corte
+    // recursivo em que d é a primeira linha de uma árvore de baixo.
+    vector<size_t> vebT, vebB;
+    vector<int> vebD;
+
+    void cortarVEB(int profundidadeRaiz, int h) {
+        if (h <= 1) return;
+        int hTopo = h / 2;
+        int hBaixo = h - hTopo;
+        int d = profundidadeRaiz + hTopo;
+        vebT[d] = ((size_t)1 << hTopo) - 1;
+        vebB[d] = ((size_t)1 << hBaixo) - 1;
+        vebD[d] = profundidadeRaiz;
+        cortarVEB(profundidadeRaiz, hTopo);
+        cortarVEB(d, hBaixo);
+    }
+
+    // Preenche o layout Eytzinger com um percurso Em-Ordem implícito.
+    size_t preencherEytzinger(size_t k, size_t i) {
+        if (k < eytzinger.size()) {
+            i = preencherEytzinger(2 * k, i);
+            eytzinger[k] = (i < ordenados.size()) ? ordenados[i] : INT_MAX;
+            i++;
+            i = preencherEytzinger(2 * k + 1, i);
+        }
+        return i;
+    }
+
+    // Converte o índice BFS k (profundidade d) na posição Em-Ordem (rank).
+    size_t rankDoIndice(size_t k, int d) const {
+        size_t primeiroDoNivel = (size_t)1 << d;
+        return ((2 * (k - primeiroDoNivel) + 1) << (altura - 1 - d)) - 1;
+    }
+
+    static int profundidade(size_t k) {
+        return 63 - __builtin_clzll(k);
+    }
+
+public:
+    ArvoreCongelada() : altura(0) {}
+
+    /**
+     * @brief Reconstrói os layouts a partir dos valores em ordem crescente.
+     */
+    void construir(vector<int> valoresEmOrdem) {
+        ordenados.swap(valoresEmOrdem);
+        altura = 0;
+        while ((((size_t)1 << altura) - 1) < ordenados.size()) {
+            altura++;
+        }
+        size_t completo = ((size_t)1 << altura) - 1;
+
+        eytzinger.assign(completo + 1, INT_MAX);
+        preencherEytzinger(1, 0);
+
+        vebT.assign(altura, 0);
+        vebB.assign(altura, 0);
+        vebD.assign(altura, 0);
+        cortarVEB(0, altura);
+
+        // Posição vEB de cada nó, calculada em ordem BFS (o ancestral
+        // sempre vem antes do descendente).
+        veb.assign(completo, INT_MAX);
+        vector<size_t> posicao(completo + 1, 0);
+        for (size_t k = 2; k <= completo; k++) {
+            int d = profundidade(k);
+            int salto = d - vebD[d];
+            size_t ancestral = k >> salto;
+            size_t indiceBaixo = k & (((size_t)1 << salto) - 1);
+            posicao[k] = posicao[ancestral] + vebT[d] + indiceBaixo * vebB[d];
+        }
+        for (size_t k = 1; k <= completo; k++) {
+            veb[posicao[k]] = eytzinger[k];
+        }
+    }
+
+    size_t tamanho() const {
+        return ordenados.size();
+    }
+
+    // Valor na posição (rank) i da ordem crescente.
+    int operator[](size_t i) const {
+        return ordenados[i];
+    }
+
+    /**
+     * @brief Rank do primeiro valor >= x (tamanho() se não houver), no
+     * layout Eytzinger: descida sem desvios + prefetch.
+     */
+    size_t lowerBound(int x) const {
+        if (altura == 0) return 0;
+        const int* a = eytzinger.data();
+        size_t limite = eytzinger.size() - 1;
+        size_t k = 1;
+        for (int nivel = 0; nivel < altura; nivel++) {
+            size_t adiante = 16 * k;
+            __builtin_prefetch(a + (adiante < limite ? adiante : limite));
+            k = 2 * k + (a[k] < x);
+        }
+        // Volta até o último nó em que a descida foi para a esquerda.
+        k >>= __builtin_ffsll(~k);
+        if (k == 0) return ordenados.size();
+        size_t r = rankDoIndice(k, profundidade(k));
+        return r < ordenados.size() ? r : ordenados.size();
+    }
+
+    /**
+     * @brief Mesmo resultado de lowerBound, mas no layout van Emde Boas.
+     */
+    size_t lowerBoundVEB(int x) const {
+        if (altura == 0) return 0;
+        size_t posicao[64]; // Posição vEB do caminho, por profundidade
+        size_t k = 1, melhor = 0;
+        int melhorProf = 0;
+        posicao[0] = 0;
+        for (int d = 0; d < altura; d++) {
+            if (d > 0) {
+                int salto = d - vebD[d];
+                size_t indiceBaixo = k & (((size_t)1 << salto) - 1);
+                posicao[d] = posicao[vebD[d]] + vebT[d] + indiceBaixo * vebB[d];
+            }
+            if (veb[posicao[d]] >= x) {
+                melhor = k;
+                melhorProf = d;
+                k = 2 * k;
+            } else {
+                k = 2 * k + 1;
+            }
+        }
+        if (melhor == 0) return ordenados.size();
+        size_t r = rankDoIndice(melhor, melhorProf);
+        return r < ordenados.size() ? r : ordenados.size();
+    }
+
+    bool contem(int x) const {
+        size_t i = lowerBound(x);
+        return i < ordenados.size() && ordenados[i] == x;
+    }
+
+    bool contemVEB(int x) const {
+        size_t i = lowerBoundVEB(x);
+        return i < ordenados.size() && ordenados[i] == x;
+    }
+
+    /**
+     * @brief Visita, em ordem, todos os valores em [lo, hi].
+     * O início é achado no layout Eytzinger e o resto é uma leitura
+     * sequencial do array ordenado.
+     */
+    template <typename Visitante>
+    void visitarIntervalo(int lo, int hi, Visitante visitar) const {
+        for (size_t i = lowerBound(lo); i < ordenados.size() && ordenados[i] <= hi; i++) {
+            visitar(ordenados[i]);
+        }
+    }
+
+    // Quantidade de valores em [lo, hi].
+    size_t contarIntervalo(int lo, int hi) const {
+        if (lo > hi) return 0;
+        size_t fim = (hi == INT_MAX) ? ordenados.size() : lowerBound(hi + 1);
+        return fim - lowerBound(lo);
+    }
+};
+
+// -----------------------------------------------------------------
+// ITERADORES (sem alocação: pilha de tamanho fixo dentro do iterador)
+// -----------------------------------------------------------------
+
+// Profundidade máxima do caminho guardado dentro de cada iterador.
+const int PROFUNDIDADE_ITERADOR = 64;
+
+/**
+ * @brief Iterador Em-Ordem bidirecional, compatível com a STL.
+ *
+ * Guarda o caminho da raiz até o nó atual num array fixo (sem heap), e
+ * avança/recua em O(1) amortizado. Se a árvore for mais funda que
+ * PROFUNDIDADE_ITERADOR (ex.: degenerada por entrada ordenada), o
+ * iterador passa a achar o sucessor/predecessor descendo a partir da
+ * raiz pelo valor atual: O(h) por passo, mas ainda sem alocar nada.
+ * Qualquer inserir/remover invalida os iteradores existentes.
+ */
+class IteradorEmOrdem {
+private:
+    const No* raiz;
+    const No* atual;                            // nullptr = fim
+    const No* caminho[PROFUNDIDADE_ITERADOR];   // Raiz ... atual
+    int topo;                                   // Entradas usadas em 'caminho'
+    bool semCaminho;                            // Caminho estourou: usa a raiz
+
+    bool empilhar(const No* no) {
+        if (topo == PROFUNDIDADE_ITERADOR) {
+            semCaminho = true;
+            return false;
+        }
+        caminho[topo++] = no;
+        return true;
+    }
+
+    // Menor valor > v (ou nullptr), descendo a partir da raiz.
+    const No* sucessorPelaRaiz(int v) const {
+        const No* melhor = nullptr;
+        for (const No* no = raiz; no != nullptr;) {
+            if (v < no->valor) {
+                melhor = no;
+                no = no->esquerda;
+            } else {
+                no = no->direita;
+            }
+        }
+        return melhor;
+    }
+
+    // Maior valor < v (ou nullptr), descendo a partir da raiz.
+    const No* predecessorPelaRaiz(int v) const {
+        const No* melhor = nullptr;
+        for (const No* no = raiz; no != nullptr;) {
+            if (v > no->valor) {
+                melhor = no;
+                no = no->direita;
+            } else {
+                no = no->esquerda;
+            }
+        }
+        return melhor;
+    }
+
+    // Desce sempre pelo mesmo lado a partir do nó atual, empilhando o
+    // caminho enquanto couber.
+    void descerAteOExtremo(bool paraEsquerda) {
+        while (true) {
+            const No* filho = paraEsquerda ? atual->esquerda : atual->direita;
+            if (filho == nullptr) break;
+            atual = filho;
+            if (!semCaminho) empilhar(atual);
+        }
+    }
+
+    void avancar() {
+        if (semCaminho) {
+            atual = sucessorPelaRaiz(atual->valor);
+            return;
+        }
+        if (atual->direita != nullptr) {
+            atual = atual->direita;
+            if (!empilhar(atual)) {
+                atual = sucessorPelaRaiz(caminho[topo - 1]->valor);
+                return;
+            }
+            descerAteOExtremo(true);
+            return;
+        }
+        // Sobe enquanto viemos da direita; o primeiro pai alcançado pela
+        // esquerda é o sucessor.
+        while (topo > 1 && caminho[topo - 2]->direita == caminho[topo - 1]) {
+            topo--;
+        }
+        topo--;
+        atual = (topo > 0) ? caminho[topo - 1] : nullptr;
+    }
+
+    void recuar() {
+        if (atual == nullptr) {
+            // Do fim volta para o maior valor.
+            topo = 0;
+            semCaminho = false;
+            if (raiz == nullptr) return;
+            atual = raiz;
+            empilhar(raiz);
+            descerAteOExtremo(false);
+            return;
+        }
+        if (semCaminho) {
+            atual = predecessorPelaRaiz(atual->valor);
+            return;
+        }
+        if (atual->esquerda != nullptr) {
+            atual = atual->esquerda;
+            if (!empilhar(atual)) {
+                atual = predecessorPelaRaiz(caminho[topo - 1]->valor);
+                return;
+            }
+            descerAteOExtremo(false);
+            return;
+        }
+        while (topo > 1 && caminho[topo - 2]->esquerda == caminho[topo - 1]) {
+            topo--;
+        }
+        topo--;
+        atual = (topo > 0) ? caminho[topo - 1] : nullptr;
+    }
+
+public:
+    using iterator_category = bidirectional_iterator_tag;
+    using value_type = int;
+    using difference_type = ptrdiff_t;
+    using pointer = const int*;
+    using reference = const int&;
+
+    IteradorEmOrdem() : raiz(nullptr), atual(nullptr), topo(0), semCaminho(false) {}
+
+    // Iterador de fim da árvore com raiz r (permite --fim).
+    explicit IteradorEmOrdem(const No* r) : raiz(r), atual(nullptr), topo(0), semCaminho(false) {}
+
+    /**
+     * @brief Posiciona no primeiro valor >= x (lower_bound), ou no fim.
+     */
+    IteradorEmOrdem(const No* r, int x) : raiz(r), atual(nullptr), topo(0), semCaminho(false) {
+        int topoDoMelhor = 0;
+        for (const No* no = raiz; no != nullptr;) {
+            if (!semCaminho && !empilhar(no)) {
+                // Muito fundo para o caminho: só o valor será guardado.
+                topo = 0;
+            }
+            if (x <= no->valor) {
+                atual = no;
+                topoDoMelhor = topo;
+                if (x == no->valor) break;
+                no = no->esquerda;
+            } else {
+                no = no->direita;
+            }
+        }
+        topo = semCaminho ? 0 : topoDoMelhor;
+    }
+
+    reference operator*() const { return atual->valor; }
+    pointer operator->() const { return &atual->valor; }
+
+    IteradorEmOrdem& operator++() { avancar(); return *this; }
+    IteradorEmOrdem operator++(int) { IteradorEmOrdem c = *this; avancar(); return c; }
+    IteradorEmOrdem& operator--() { recuar(); return *this; }
+    IteradorEmOrdem operator--(int) { IteradorEmOrdem c = *this; recuar(); return c; }
+
+    bool operator==(const IteradorEmOrdem& outro) const { return atual == outro.atual; }
+    bool operator!=(const IteradorEmOrdem& outro) const { return atual != outro.atual; }
+};
+
+/**
+ * @brief Iterador Pré-Ordem (de avanço), com o mesmo esquema de pilha fixa
+ * e o mesmo recurso de descida pela raiz para árvores muito fundas.
+ */
+class IteradorPreOrdem {
+private:
+    const No* raiz;
+    const No* atual;
+    const No* caminho[PROFUNDIDADE_ITERADOR];
+    int topo;
+    bool semCaminho;
+
+    // Próximo em Pré-Ordem de uma folha: filho direito do ancestral mais
+    // próximo em que descemos pela esquerda e que tem filho direito.
+    const No* proximoDaFolhaPelaRaiz(int v) const {
+        const No* proximo = nullptr;
+        for (const No* no = raiz; no != nullptr && no->valor != v;) {
+            if (v < no->valor) {
+                if (no->direita != nullptr) proximo = no->direita;
+                no = no->esquerda;
+            } else {
+                no = no->direita;
+            }
+        }
+        return proximo;
+    }
+
+    void avancar() {
+        const No* filho = atual->esquerda ? atual->esquerda : atual->direita;
+        if (filho != nullptr) {
+            atual = filho;
+            if (!semCaminho) {
+                if (topo == PROFUNDIDADE_ITERADOR) {
+                    semCaminho = true;
+                } else {
+                    caminho[topo++] = atual;
+                }
+            }
+            return;
+        }
+        if (semCaminho) {
+            atual = proximoDaFolhaPelaRaiz(atual->valor);
+            return;
+        }
+        // Sobe até um pai que nos alcançou pela esquerda e tem filho direito.
+        while (topo > 1) {
+            const No* veio = caminho[--topo];
+            const No* pai = caminho[topo - 1];
+            if (pai->esquerda == veio && pai->direita != nullptr) {
+                atual = pai->direita;
+                caminho[topo++] = atual;
+                return;
+            }
+        }
+        topo = 0;
+        atual = nullptr;
+    }
+
+public:
+    using iterator_category = forward_iterator_tag;
+    using value_type = int;
+    using difference_type = ptrdiff_t;
+    using pointer = const int*;
+    using reference = const int&;
+
+    IteradorPreOrdem() : raiz(nullptr), atual(nullptr), topo(0), semCaminho(false) {}
+
+    explicit IteradorPreOrdem(const No* r) : raiz(r), atual(r), topo(0), semCaminho(false) {
+        if (r != nullptr) caminho[topo++] = r;
+    }
+
+    reference operator*() const { return atual->valor; }
+    pointer operator->() const { return &atual->valor; }
+
+    IteradorPreOrdem& operator++() { avancar(); return *this; }
+    IteradorPreOrdem operator++(int) { IteradorPreOrdem c = *this; avancar(); return c; }
+
+    bool operator==(const IteradorPreOrdem& outro) const { return atual == outro.atual; }
+    bool operator!=(const IteradorPreOrdem& outro) const { return atual != outro.atual; }
+};
+
+/**
+ * @brief Par [inicio, fim) de iteradores, para uso em 'for' de intervalo.
+ */
+template <typename Iterador>
+struct Percurso {
+    Iterador inicio, fim;
+    Iterador begin() const { return inicio; }
+    Iterador end() const { return fim; }
+};
+
 class ArvoreBinariaBusca {
 private:
     No* raiz; // Ponteiro para o nó raiz da árvore
+    PoolDeNos<No> pool; // Todos os nós da árvore vêm deste pool
 
-    No* inserirRec(No* no, int valor) {
-        // 1. Caso base: Se o nó é nulo, encontramos o local para inserir.
-        if (no == nullptr) {
-            return new No(valor);
+    // Instantâneo congelado (ver congelar()); refeito sob demanda
+    // quando a árvore muda.
+    ArvoreCongelada instantaneo;
+    bool instantaneoValido = false;
+
+    // -----------------------------------------------------------------
+    // F1: FUNÇÃO DE INSERÇÃO (Privada - Iterativa)
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Insere um valor descendo pela árvore sem recursão.
+     * Mantém um ponteiro para o "elo" (o campo esquerda/direita do pai, ou
+     * a própria raiz) onde o novo nó deve ser pendurado. Assim não é
+     * preciso guardar o pai, e árvores degeneradas (entrada ordenada) não
+     * estouram a pilha de chamadas.
+     */
+    void inserirIter(int valor) {
+        No** elo = &raiz;
+        while (*elo != nullptr) {
+            if (valor < (*elo)->valor) {
+                elo = &(*elo)->esquerda;
+            } else if (valor > (*elo)->valor) {
+                elo = &(*elo)->direita;
+            } else {
+                return; // Assumindo que não inserimos valores duplicados
+            }
+        }
+        *elo = pool.alocar(valor);
+    }
+
+    // -----------------------------------------------------------------
+    // F2: FUNÇÕES DE LISTAGEM (Privadas - Percurso de Morris)
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Percurso Em-Ordem de Morris: sem recursão e sem pilha.
+     * Cria temporariamente um "fio" do predecessor de cada nó de volta
+     * para o nó, e desfaz o fio ao passar por ele pela segunda vez.
+     * Ao final, a árvore volta exatamente ao estado original.
+     */
+    void listarEmOrdemIter() {
+        No* atual = raiz;
+        while (atual != nullptr) {
+            if (atual->esquerda == nullptr) {
+                cout << atual->valor << " ";
+                atual = atual->direita;
+                continue;
+            }
+            // Predecessor Em-Ordem: o mais à direita da sub-árvore esquerda
+            No* pred = atual->esquerda;
+            while (pred->direita != nullptr && pred->direita != atual) {
+                pred = pred->direita;
+            }
+            if (pred->direita == nullptr) {
+                pred->direita = atual; // Cria o fio e desce à esquerda
+                atual = atual->esquerda;
+            } else {
+                pred->direita = nullptr; // Desfaz o fio: esquerda já visitada
+                cout << atual->valor << " ";
+                atual = atual->direita;
+            }
+        }
+    }
+
+    /**
+     * @brief Percurso Pré-Ordem de Morris (mesma ideia do Em-Ordem, mas o
+     * nó é impresso na primeira vez em que é alcançado).
+     */
+    void listarPreOrdemIter() {
+        No* atual = raiz;
+        while (atual != nullptr) {
+            if (atual->esquerda == nullptr) {
+                cout << atual->valor << " ";
+                atual = atual->direita;
+                continue;
+            }
+            No* pred = atual->esquerda;
+            while (pred->direita != nullptr && pred->direita != atual) {
+                pred = pred->direita;
+            }
+            if (pred->direita == nullptr) {
+                cout << atual->valor << " ";
+                pred->direita = atual;
+                atual = atual->esquerda;
+            } else {
+                pred->direita = nullptr;
+                atual = atual->direita;
+            }
+        }
+    }
+
+    // -----------------------------------------------------------------
+    // F3: FUNÇÃO DE REMOÇÃO (Privada - Iterativa)
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Remove um valor da árvore sem recursão.
+     * Desce guardando o elo que aponta para o nó atual; ao encontrar o
+     * valor, o elo é religado ao substituto do nó removido.
+     */
+    void removerIter(int valor) {
+        // 1. Procurando o nó a ser removido
+        No** elo = &raiz;
+        while (*elo != nullptr && (*elo)->valor != valor) {
+            elo = (valor < (*elo)->valor) ? &(*elo)->esquerda : &(*elo)->direita;
+        }
+        No* no = *elo;
+        if (no == nullptr) {
+            return; // Valor não encontrado
+        }
+
+        // CASO 1: Nó com 0 ou 1 filho (à direita)
+        if (no->esquerda == nullptr) {
+            *elo = no->direita;
+            pool.liberar(no); // Devolve o nó ao pool
+            return;
+        }
+        // CASO 2: Nó com 1 filho (à esquerda)
+        if (no->direita == nullptr) {
+            *elo = no->esquerda;
+            pool.liberar(no);
+            return;
+        }
+
+        // CASO 3: Nó com 2 filhos
+        // 1. Encontra o sucessor Em-Ordem (menor valor na sub-árvore direita),
+        //    guardando o elo que aponta para ele.
+        No** eloSucessor = &no->direita;
+        while ((*eloSucessor)->esquerda != nullptr) {
+            eloSucessor = &(*eloSucessor)->esquerda;
+        }
+        No* sucessor = *eloSucessor;
+
+        // 2. Copia o valor do sucessor para este nó
+        no->valor = sucessor->valor;
+
+        // 3. O sucessor não tem filho esquerdo: o pai dele adota o direito.
+        *eloSucessor = sucessor->direita;
+        pool.liberar(sucessor);
+    }
+
+    /**
+     * @brief Procura um valor descendo iterativamente a partir da raiz.
+     */
+    bool contemIter(int valor) const {
+        const No* atual = raiz;
+        while (atual != nullptr) {
+            if (valor < atual->valor) {
+                atual = atual->esquerda;
+            } else if (valor > atual->valor) {
+                atual = atual->direita;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Libera toda a memória da árvore (usado no destrutor).
+     * Como todos os nós vivem no pool, basta liberar os blocos inteiros,
+     * sem percorrer a árvore nó a nó.
+     */
+    void deletarArvore() {
+        pool.liberarTudo();
+        raiz = nullptr;
+    }
+
+    /**
+     * @brief Constrói a sub-árvore perfeitamente balanceada com os valores
+     * ordenados em [inicio, fim): o do meio vira a raiz e as metades viram
+     * as sub-árvores. Cada nó é construído na posição do seu rank dentro
+     * do bloco contíguo 'nos', numa única passada O(n).
+     */
+    No* ligarBalanceado(No* nos, const vector<int>& ordenadas, size_t inicio, size_t fim) {
+        if (inicio >= fim) {
+            return nullptr;
+        }
+        size_t meio = inicio + (fim - inicio) / 2;
+        No* no = new (&nos[meio]) No(ordenadas[meio]);
+        no->esquerda = ligarBalanceado(nos, ordenadas, inicio, meio);
+        no->direita = ligarBalanceado(nos, ordenadas, meio + 1, fim);
+        return no;
+    }
+
+public:
+    // Construtor: Inicializa a árvore com a raiz nula.
+    ArvoreBinariaBusca() : raiz(nullptr) {}
+
+    // Destrutor: Limpa toda a memória alocada.
+    ~ArvoreBinariaBusca() {
+        deletarArvore();
+    }
+
+    // A árvore é dona do pool de nós: não pode ser copiada.
+    ArvoreBinariaBusca(const ArvoreBinariaBusca&) = delete;
+    ArvoreBinariaBusca& operator=(const ArvoreBinariaBusca&) = delete;
+
+    // -----------------------------------------------------------------
+    // INTERFACE PÚBLICA (Funções F1, F2, F3)
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief F1: Insere um valor na árvore.
+     */
+    void inserir(int valor) {
+        inserirIter(valor);
+        instantaneoValido = false;
+    }
+
+    /**
+     * @brief F2: Lista a árvore (Em-Ordem).
+     * Em-Ordem (In-Order) mostra os elementos de forma ordenada.
+     */
+    void listarEmOrdem() {
+        cout << "[Em-Ordem]:   ";
+        listarEmOrdemIter();
+        cout << endl;
+    }
+    
+    /**
+     * @brief F2: Lista a árvore (Pré-Ordem).
+     * Pré-Ordem (Pre-Order) é útil para ver a estrutura da árvore.
+     */
+    void listarPreOrdem() {
+        cout << "[Pre-Ordem]:  ";
+        listarPreOrdemIter();
+        cout << endl;
+    }
+
+    /**
+     * @brief F3: Remove um valor da árvore.
+     */
+    void remover(int valor) {
+        removerIter(valor);
+        instantaneoValido = false;
+    }
+
+    /**
+     * @brief Verifica se um valor está na árvore.
+     */
+    bool contem(int valor) const {
+        return contemIter(valor);
+    }
+
+    // -----------------------------------------------------------------
+    // ITERADORES E CONSULTAS DE INTERVALO (sem alocação)
+    // -----------------------------------------------------------------
+
+    // Percurso Em-Ordem: for (int v : arvore) { ... }
+    IteradorEmOrdem begin() const {
+        return IteradorEmOrdem(raiz, INT_MIN);
+    }
+
+    IteradorEmOrdem end() const {
+        return IteradorEmOrdem(raiz);
+    }
+
+    // Primeiro valor >= x.
+    IteradorEmOrdem lowerBound(int x) const {
+        return IteradorEmOrdem(raiz, x);
+    }
+
+    // Primeiro valor > x.
+    IteradorEmOrdem upperBound(int x) const {
+        return (x == INT_MAX) ? end() : IteradorEmOrdem(raiz, x + 1);
+    }
+
+    /**
+     * @brief Valores em [lo, hi], em ordem: for (int v : arvore.intervalo(a, b)).
+     * Só visita os O(log n + k) nós relevantes.
+     */
+    Percurso<IteradorEmOrdem> intervalo(int lo, int hi) const {
+        if (lo > hi) return Percurso<IteradorEmOrdem>{end(), end()};
+        return Percurso<IteradorEmOrdem>{lowerBound(lo), upperBound(hi)};
+    }
+
+    /**
+     * @brief Chama visitar(v) para cada valor em [lo, hi], em ordem.
+     */
+    template <typename Visitante>
+    void visitarIntervalo(int lo, int hi, Visitante visitar) const {
+        for (int v : intervalo(lo, hi)) {
+            visitar(v);
+        }
+    }
+
+    // Percurso Pré-Ordem: for (int v : arvore.preOrdem()) { ... }
+    Percurso<IteradorPreOrdem> preOrdem() const {
+        return Percurso<IteradorPreOrdem>{IteradorPreOrdem(raiz), IteradorPreOrdem()};
+    }
+
+    /**
+     * @brief Substitui o conteúdo da árvore pelos 'n' valores de 'chaves'
+     * (em qualquer ordem), construindo diretamente uma árvore perfeitamente
+     * balanceada, em vez de chamar inserir() para cada valor.
+     * Custo: a ordenação (paralela) + O(n) para montar a árvore, com todos
+     * os nós num único bloco contíguo do pool.
+     */
+    void construirEmLote(const int* chaves, size_t n) {
+        // 1. Ordena uma cópia dos valores (em paralelo se for grande)
+        vector<int> ordenadas(chaves, chaves + n);
+        ordenarEmParalelo(ordenadas);
+
+        // 2. Sem duplicatas, como em inserir().
+        ordenadas.erase(unique(ordenadas.begin(), ordenadas.end()), ordenadas.end());
+
+        // 3. Descarta a árvore atual e monta a nova no mesmo pool
+        deletarArvore();
+        if (!ordenadas.empty()) {
+            No* nos = pool.reservarContiguos(ordenadas.size());
+            raiz = ligarBalanceado(nos, ordenadas, 0, ordenadas.size());
+        }
+        instantaneoValido = false;
+    }
+
+    void construirEmLote(const vector<int>& chaves) {
+        construirEmLote(chaves.data(), chaves.size());
+    }
+
+    /**
+     * @brief Altura da árvore (0 se vazia), calculada nível a nível, sem
+     * recursão.
+     */
+    int altura() const {
+        vector<const No*> nivel, proximo;
+        if (raiz != nullptr) nivel.push_back(raiz);
+        int h = 0;
+        while (!nivel.empty()) {
+            h++;
+            proximo.clear();
+            for (const No* no : nivel) {
+                if (no->esquerda) proximo.push_back(no->esquerda);
+                if (no->direita) proximo.push_back(no->direita);
+            }
+            nivel.swap(proximo);
+        }
+        return h;
+    }
+
+    /**
+     * @brief Copia os valores, na ordem do percurso Em-Ordem, para 'saida'.
+     */
+    void coletarEmOrdem(vector<int>& saida) {
+        saida.clear();
+        No* atual = raiz;
+        while (atual != nullptr) {
+            if (atual->esquerda == nullptr) {
+                saida.push_back(atual->valor);
+                atual = atual->direita;
+                continue;
+            }
+            No* pred = atual->esquerda;
+            while (pred->direita != nullptr && pred->direita != atual) {
+                pred = pred->direita;
+            }
+            if (pred->direita == nullptr) {
+                pred->direita = atual;
+                atual = atual->esquerda;
+            } else {
+                pred->direita = nullptr;
+                saida.push_back(atual->valor);
+                atual = atual->direita;
+            }
+        }
+    }
+
+    /**
+     * @brief "Congela" o conteúdo atual num ArvoreCongelada (layouts
+     * Eytzinger e van Emde Boas) para consultas somente-leitura rápidas.
+     * O instantâneo é reaproveitado enquanto a árvore não muda e é
+     * reconstruído na próxima chamada após inserir/remover.
+     */
+    const ArvoreCongelada& congelar() {
+        if (!instantaneoValido) {
+            vector<int> valores;
+            coletarEmOrdem(valores);
+            instantaneo.construir(move(valores));
+            instantaneoValido = true;
+        }
+        return instantaneo;
+    }
+
+    // -----------------------------------------------------------------
+    // GRAVAÇÃO E CARGA EM ARQUIVO BINÁRIO
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Grava a árvore em 'caminho': um registro por nó, em Pré-Ordem,
+     * com o valor (4 bytes) e um byte de flags dizendo quais filhos existem.
+     * A Pré-Ordem sozinha já determina a forma, então a carga não compara
+     * valores nem rebalanceia.
+     */
+    void salvar(const string& caminho) const {
+        EscritorBinario escritor(caminho);
+        uint64_t registros = 0;
+        vector<const No*> pilha;
+        if (raiz != nullptr) pilha.push_back(raiz);
+        while (!pilha.empty()) {
+            const No* no = pilha.back();
+            pilha.pop_back();
+            int32_t valor = no->valor;
+            uint8_t flags = (no->esquerda ? 1 : 0) | (no->direita ? 2 : 0);
+            escritor.escrever(&valor, sizeof(valor));
+            escritor.escrever(&flags, sizeof(flags));
+            registros++;
+            if (no->direita) pilha.push_back(no->direita);
+            if (no->esquerda) pilha.push_back(no->esquerda);
+        }
+        CabecalhoArquivo cabecalho = {};
+        cabecalho.formato = FORMATO_PRE_ORDEM;
+        cabecalho.raiz = cabecalho.livres = UINT32_MAX;
+        cabecalho.registros = cabecalho.vivos = cabecalho.ocorrencias = registros;
+        escritor.finalizar(cabecalho);
+    }
+
+    /**
+     * @brief Substitui o conteúdo pelo da árvore gravada em 'caminho', em
+     * O(n): cada registro ocupa o próximo elo pendente (filhos esquerdos
+     * antes dos direitos). Os nós ficam num bloco contíguo, em Pré-Ordem.
+     * Lança runtime_error (e deixa a árvore vazia) se o arquivo for inválido.
+     */
+    void carregar(const string& caminho) {
+        deletarArvore();
+        instantaneoValido = false;
+        try {
+            LeitorBinario leitor(caminho, FORMATO_PRE_ORDEM, sizeof(int32_t) + sizeof(uint8_t));
+            uint64_t n = leitor.cabecalho.registros;
+            No* nos = (n > 0) ? pool.reservarContiguos(n) : nullptr;
+            vector<No**> pendentes; // Elos ainda sem nó, o próximo no topo
+            pendentes.push_back(&raiz);
+            for (uint64_t i = 0; i < n; i++) {
+                int32_t valor;
+                uint8_t flags;
+                leitor.ler(&valor, sizeof(valor));
+                leitor.ler(&flags, sizeof(flags));
+                if (pendentes.empty()) {
+                    throw runtime_error("Erro: arquivo truncado ou corrompido.");
+                }
+                No* no = new (&nos[i]) No(valor);
+                *pendentes.back() = no;
+                pendentes.pop_back();
+                if (flags & 2) pendentes.push_back(&no->direita);
+                if (flags & 1) pendentes.push_back(&no->esquerda);
+            }
+            if (n > 0 && !pendentes.empty()) {
+                throw runtime_error("Erro: arquivo truncado ou corrompido.");
+            }
+            leitor.conferirFim();
+        } catch (...) {
+            deletarArvore();
+            throw;
+        }
+    }
+};
+
+// -----------------------------------------------------------------
+// VARIANTE COMPACTA (nós num único array, ligados por índices de 32 bits)
+// -----------------------------------------------------------------
+
+// Índice que faz o papel de nullptr.
+const uint32_t SEM_NO = UINT32_MAX;
+
+/**
+ * @brief Nó da árvore indexada: o valor e os índices dos filhos no array
+ * de nós. 12 bytes, contra 24 do No com ponteiros de 64 bits.
+ */
+struct NoIndexado {
+    int valor;
+    uint32_t esquerda;
+    uint32_t direita;
+};
+
+static_assert(sizeof(NoIndexado) == 12, "NoIndexado deveria ocupar 12 bytes");
+
+/**
+ * @brief Mesma árvore de busca da ArvoreBinariaBusca, mas com todos os nós
+ * num único vector<NoIndexado>, ligados por índices em vez de ponteiros.
+ *
+ * Metade da memória por nó significa o dobro de nós por linha de cache.
+ * Como nenhum elo depende do endereço do array, o armazenamento pode ser
+ * realocado (o vector cresce), copiado com memcpy ou gravado em disco
+ * tal como está. Nós removidos entram numa lista livre encadeada pelo
+ * campo 'esquerda' e são reaproveitados nas próximas inserções.
+ */
+class ArvoreIndexada {
+private:
+    vector<NoIndexado> nos; // Armazenamento de todos os nós (vivos e livres)
+    uint32_t raiz;          // Índice da raiz (SEM_NO se vazia)
+    uint32_t livres;        // Topo da lista livre
+    size_t quantidade;      // Nós vivos
+
+    uint32_t novoNo(int valor) {
+        uint32_t i;
+        if (livres != SEM_NO) {
+            i = livres;
+            livres = nos[i].esquerda;
+        } else {
+            if (nos.size() >= SEM_NO) {
+                throw runtime_error("Erro: limite de nos da ArvoreIndexada atingido.");
+            }
+            i = (uint32_t)nos.size();
+            nos.push_back(NoIndexado());
+        }
+        nos[i].valor = valor;
+        nos[i].esquerda = SEM_NO;
+        nos[i].direita = SEM_NO;
+        quantidade++;
+        return i;
+    }
+
+    void liberarNo(uint32_t i) {
+        nos[i].esquerda = livres;
+        livres = i;
+        quantidade--;
+    }
+
+    /**
+     * @brief Mesmo que ArvoreBinariaBusca::ligarBalanceado, mas o nó de
+     * rank 'meio' fica na posição 'meio' do array.
+     */
+    uint32_t ligarBalanceado(const vector<int>& ordenadas, size_t inicio, size_t fim) {
+        if (inicio >= fim) {
+            return SEM_NO;
+        }
+        size_t meio = inicio + (fim - inicio) / 2;
+        nos[meio].valor = ordenadas[meio];
+        nos[meio].esquerda = ligarBalanceado(ordenadas, inicio, meio);
+        nos[meio].direita = ligarBalanceado(ordenadas, meio + 1, fim);
+        return (uint32_t)meio;
+    }
+
+public:
+    ArvoreIndexada() : raiz(SEM_NO), livres(SEM_NO), quantidade(0) {}
+
+    // Cópia e movimentação padrão: copiar a árvore é copiar o array.
+
+    /**
+     * @brief Reserva espaço para 'n' nós (evita realocações do array).
+     */
+    void reservar(size_t n) {
+        nos.reserve(n);
+    }
+
+    /**
+     * @brief Insere um valor (sem duplicatas), descendo sem recursão.
+     * Guarda o pai e o lado em vez de um ponteiro para o elo, porque
+     * novoNo() pode realocar o array.
+     */
+    void inserir(int valor) {
+        uint32_t pai = SEM_NO;
+        bool aEsquerda = false;
+        uint32_t atual = raiz;
+        while (atual != SEM_NO) {
+            const NoIndexado& no = nos[atual];
+            if (valor < no.valor) {
+                pai = atual;
+                aEsquerda = true;
+                atual = no.esquerda;
+            } else if (valor > no.valor) {
+                pai = atual;
+                aEsquerda = false;
+                atual = no.direita;
+            } else {
+                return;
+            }
+        }
+        uint32_t novo = novoNo(valor);
+        if (pai == SEM_NO) {
+            raiz = novo;
+        } else if (aEsquerda) {
+            nos[pai].esquerda = novo;
+        } else {
+            nos[pai].direita = novo;
+        }
+    }
+
+    /**
+     * @brief Remove um valor, religando o elo do pai como em removerIter().
+     * Aqui o array não muda de tamanho, então o ponteiro para o elo é seguro.
+     */
+    void remover(int valor) {
+        uint32_t* elo = &raiz;
+        while (*elo != SEM_NO && nos[*elo].valor != valor) {
+            NoIndexado& no = nos[*elo];
+            elo = (valor < no.valor) ? &no.esquerda : &no.direita;
+        }
+        uint32_t i = *elo;
+        if (i == SEM_NO) {
+            return;
+        }
+        NoIndexado& no = nos[i];
+        if (no.esquerda == SEM_NO) {
+            *elo = no.direita;
+            liberarNo(i);
+            return;
+        }
+        if (no.direita == SEM_NO) {
+            *elo = no.esquerda;
+            liberarNo(i);
+            return;
+        }
+        // Dois filhos: o sucessor Em-Ordem empresta o valor e sai do lugar.
+        uint32_t* eloSucessor = &no.direita;
+        while (nos[*eloSucessor].esquerda != SEM_NO) {
+            eloSucessor = &nos[*eloSucessor].esquerda;
+        }
+        uint32_t sucessor = *eloSucessor;
+        no.valor = nos[sucessor].valor;
+        *eloSucessor = nos[sucessor].direita;
+        liberarNo(sucessor);
+    }
+
+    bool contem(int valor) const {
+        uint32_t atual = raiz;
+        while (atual != SEM_NO) {
+            const NoIndexado& no = nos[atual];
+            if (valor < no.valor) {
+                atual = no.esquerda;
+            } else if (valor > no.valor) {
+                atual = no.direita;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Chama visitar(v) para cada valor em [lo, hi], em ordem,
+     * podando as sub-árvores fora do intervalo. A pilha explícita guarda
+     * índices de 4 bytes.
+     */
+    template <typename Visitante>
+    void visitarIntervalo(int lo, int hi, Visitante visitar) const {
+        vector<uint32_t> pilha;
+        uint32_t atual = raiz;
+        while (atual != SEM_NO || !pilha.empty()) {
+            while (atual != SEM_NO) {
+                if (nos[atual].valor < lo) {
+                    atual = nos[atual].direita; // Tudo à esquerda é < lo
+                } else {
+                    pilha.push_back(atual);
+                    atual = nos[atual].esquerda;
+                }
+            }
+            if (pilha.empty()) break;
+            uint32_t i = pilha.back();
+            pilha.pop_back();
+            if (nos[i].valor > hi) break; // Os próximos são todos maiores
+            visitar(nos[i].valor);
+            atual = nos[i].direita;
+        }
+    }
+
+    template <typename Visitante>
+    void visitarEmOrdem(Visitante visitar) const {
+        visitarIntervalo(INT_MIN, INT_MAX, visitar);
+    }
+
+    void listarEmOrdem() const {
+        cout << "[Em-Ordem]:   ";
+        visitarEmOrdem([](int v) { cout << v << " "; });
+        cout << endl;
+    }
+
+    void listarPreOrdem() const {
+        cout << "[Pre-Ordem]:  ";
+        vector<uint32_t> pilha;
+        if (raiz != SEM_NO) pilha.push_back(raiz);
+        while (!pilha.empty()) {
+            uint32_t i = pilha.back();
+            pilha.pop_back();
+            cout << nos[i].valor << " ";
+            if (nos[i].direita != SEM_NO) pilha.push_back(nos[i].direita);
+            if (nos[i].esquerda != SEM_NO) pilha.push_back(nos[i].esquerda);
+        }
+        cout << endl;
+    }
+
+    void coletarEmOrdem(vector<int>& saida) const {
+        saida.clear();
+        saida.reserve(quantidade);
+        visitarEmOrdem([&saida](int v) { saida.push_back(v); });
+    }
+
+    /**
+     * @brief Substitui o conteúdo pelos valores de 'chaves', montando a
+     * árvore balanceada diretamente no array, sem nós livres.
+     */
+    void construirEmLote(const int* chaves, size_t n) {
+        vector<int> ordenadas(chaves, chaves + n);
+        ordenarEmParalelo(ordenadas);
+        ordenadas.erase(unique(ordenadas.begin(), ordenadas.end()), ordenadas.end());
+        if (ordenadas.size() >= SEM_NO) {
+            throw runtime_error("Erro: limite de nos da ArvoreIndexada atingido.");
+        }
+        nos.assign(ordenadas.size(), NoIndexado());
+        livres = SEM_NO;
+        quantidade = ordenadas.size();
+        raiz = ligarBalanceado(ordenadas, 0, ordenadas.size());
+    }
+
+    void construirEmLote(const vector<int>& chaves) {
+        construirEmLote(chaves.data(), chaves.size());
+    }
+
+    int altura() const {
+        vector<uint32_t> nivel, proximo;
+        if (raiz != SEM_NO) nivel.push_back(raiz);
+        int h = 0;
+        while (!nivel.empty()) {
+            h++;
+            proximo.clear();
+            for (uint32_t i : nivel) {
+                if (nos[i].esquerda != SEM_NO) proximo.push_back(nos[i].esquerda);
+                if (nos[i].direita != SEM_NO) proximo.push_back(nos[i].direita);
+            }
+            nivel.swap(proximo);
+        }
+        return h;
+    }
+
+    size_t tamanho() const {
+        return quantidade;
+    }
+
+    // Bytes reservados para o array de nós (inclui folga e nós livres).
+    size_t bytesUsados() const {
+        return nos.capacity() * sizeof(NoIndexado);
+    }
+
+    // --- Acesso ao armazenamento bruto (cópia, gravação em disco) ---
+
+    const NoIndexado* dados() const {
+        return nos.data();
+    }
+
+    size_t totalDeNos() const {
+        return nos.size();
+    }
+
+    uint32_t indiceRaiz() const {
+        return raiz;
+    }
+
+    // -----------------------------------------------------------------
+    // GRAVAÇÃO E CARGA EM ARQUIVO BINÁRIO
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Grava o array de nós tal como está (inclusive posições livres):
+     * como os elos são índices, não há nada a traduzir.
+     */
+    void salvar(const string& caminho) const {
+        EscritorBinario escritor(caminho);
+        escritor.escrever(nos.data(), nos.size() * sizeof(NoIndexado));
+        CabecalhoArquivo cabecalho = {};
+        cabecalho.formato = FORMATO_ARRAY_INDEXADO;
+        cabecalho.raiz = raiz;
+        cabecalho.livres = livres;
+        cabecalho.registros = nos.size();
+        cabecalho.vivos = cabecalho.ocorrencias = quantidade;
+        escritor.finalizar(cabecalho);
+    }
+
+    /**
+     * @brief Lê o array gravado por salvar() de uma vez, confere checksum e
+     * estrutura, e passa a usá-lo como armazenamento.
+     */
+    void carregar(const string& caminho) {
+        LeitorBinario leitor(caminho, FORMATO_ARRAY_INDEXADO, sizeof(NoIndexado));
+        const CabecalhoArquivo& c = leitor.cabecalho;
+        vector<NoIndexado> lidos(c.registros);
+        leitor.ler(lidos.data(), lidos.size() * sizeof(NoIndexado));
+        leitor.conferirFim();
+        if (c.ocorrencias != c.vivos ||
+            !estruturaValida(lidos.data(), lidos.size(), c.raiz, c.livres, c.vivos)) {
+            throw runtime_error("Erro: arquivo truncado ou corrompido.");
+        }
+        nos.swap(lidos);
+        raiz = c.raiz;
+        livres = c.livres;
+        quantidade = c.vivos;
+    }
+
+    /**
+     * @brief Confere um array vindo de arquivo antes de confiar nele: todo
+     * elo aponta para dentro do array, os nós alcançados pela raiz e os da
+     * lista livre não se repetem nem se cruzam, juntos ocupam todas as
+     * posições, e a árvore tem exatamente 'vivos' nós. Sem recursão.
+     */
+    static bool estruturaValida(const NoIndexado* v, size_t n, uint32_t raiz, uint32_t livres,
+                                uint64_t vivos) {
+        vector<char> visto(n, 0);
+        auto marcar = [&visto, n](uint32_t i) {
+            if (i >= n || visto[i]) return false;
+            visto[i] = 1;
+            return true;
+        };
+        uint64_t naArvore = 0, naLista = 0;
+        vector<uint32_t> pilha;
+        if (raiz != SEM_NO) {
+            if (!marcar(raiz)) return false;
+            pilha.push_back(raiz);
+        }
+        while (!pilha.empty()) {
+            uint32_t i = pilha.back();
+            pilha.pop_back();
+            naArvore++;
+            for (uint32_t filho : {v[i].esquerda, v[i].direita}) {
+                if (filho == SEM_NO) continue;
+                if (!marcar(filho)) return false;
+                pilha.push_back(filho);
+            }
+        }
+        for (uint32_t i = livres; i != SEM_NO; i = v[i].esquerda) {
+            if (!marcar(i)) return false;
+            naLista++;
+        }
+        return naArvore == vivos && naArvore + naLista == n;
+    }
+};
+
+// -----------------------------------------------------------------
+// ÁRVORE MAPEADA (arquivo do ArvoreIndexada aberto com mmap, só leitura)
+// -----------------------------------------------------------------
+
+/**
+ * @brief Abre um arquivo gravado por ArvoreIndexada::salvar() sem copiar
+ * nem reconstruir nada: o array de nós é mapeado direto do arquivo
+ * (mmap, só leitura) e as consultas descem pelos índices nele.
+ * Com 'conferir' = false, só o cabeçalho é validado e a abertura é O(1);
+ * as páginas são lidas do disco sob demanda, na primeira consulta que as
+ * toca, e cada índice seguido é conferido na hora (runtime_error se o
+ * arquivo estiver corrompido). Fora de sistemas POSIX, o arquivo é lido
+ * para a memória.
+ */
+class ArvoreMapeada {
+private:
+    const NoIndexado* nos;
+    size_t totalNos;
+    uint32_t raiz;
+    size_t vivos;
+#ifdef _WIN32
+    vector<NoIndexado> copia;
+#else
+    void* mapa;
+    size_t bytesMapeados;
+#endif
+
+    // Sem a verificação na abertura, os índices vêm direto do arquivo:
+    // cada um precisa estar dentro do array, e um caminho com mais passos
+    // do que nós só existe se houver um ciclo.
+    void conferirPasso(uint32_t indice, size_t& passos) const {
+        if (indice >= totalNos || ++passos > 2 * totalNos) {
+            throw runtime_error("Erro: arquivo truncado ou corrompido.");
+        }
+    }
+
+public:
+    explicit ArvoreMapeada(const string& caminho, bool conferir = true) {
+#ifdef _WIN32
+        ArvoreIndexada arvore;
+        arvore.carregar(caminho); // Confere checksum e índices sempre
+        copia.assign(arvore.dados(), arvore.dados() + arvore.totalDeNos());
+        nos = copia.data();
+        totalNos = copia.size();
+        raiz = arvore.indiceRaiz();
+        vivos = arvore.tamanho();
+        (void)conferir;
+#else
+        int fd = open(caminho.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Erro: nao foi possivel abrir " + caminho);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(CabecalhoArquivo)) {
+            close(fd);
+            throw runtime_error("Erro: arquivo truncado ou corrompido.");
+        }
+        bytesMapeados = (size_t)info.st_size;
+        mapa = mmap(nullptr, bytesMapeados, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // O mapeamento continua válido sem o descritor
+        if (mapa == MAP_FAILED) {
+            throw runtime_error("Erro: falha no mmap de " + caminho);
+        }
+        try {
+            const CabecalhoArquivo* c = static_cast<const CabecalhoArquivo*>(mapa);
+            validarCabecalho(*c, FORMATO_ARRAY_INDEXADO, bytesMapeados - sizeof(CabecalhoArquivo),
+                             sizeof(NoIndexado));
+            nos = reinterpret_cast<const NoIndexado*>(c + 1);
+            totalNos = c->registros;
+            raiz = c->raiz;
+            vivos = c->vivos;
+            if (conferir) {
+                uint64_t conteudo = fnv1a(FNV_BASE, nos, totalNos * sizeof(NoIndexado));
+                if (checksumDoArquivo(conteudo, *c) != c->checksum) {
+                    throw runtime_error("Erro: checksum do arquivo nao confere.");
+                }
+                if (c->ocorrencias != c->vivos ||
+                    !ArvoreIndexada::estruturaValida(nos, totalNos, raiz, c->livres, c->vivos)) {
+                    throw runtime_error("Erro: arquivo truncado ou corrompido.");
+                }
+            } else if (raiz != SEM_NO && raiz >= totalNos) {
+                throw runtime_error("Erro: arquivo truncado ou corrompido.");
+            }
+        } catch (...) {
+            munmap(mapa, bytesMapeados);
+            throw;
+        }
+#endif
+    }
+
+    ~ArvoreMapeada() {
+#ifndef _WIN32
+        munmap(mapa, bytesMapeados);
+#endif
+    }
+
+    // Dono do mapeamento: não pode ser copiada.
+    ArvoreMapeada(const ArvoreMapeada&) = delete;
+    ArvoreMapeada& operator=(const ArvoreMapeada&) = delete;
+
+    bool contem(int valor) const {
+        uint32_t atual = raiz;
+        size_t passos = 0;
+        while (atual != SEM_NO) {
+            conferirPasso(atual, passos);
+            const NoIndexado& no = nos[atual];
+            if (valor < no.valor) {
+                atual = no.esquerda;
+            } else if (valor > no.valor) {
+                atual = no.direita;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Chama visitar(v) para cada valor em [lo, hi], em ordem
+     * (mesmo percurso podado da ArvoreIndexada).
+     */
+    template <typename Visitante>
+    void visitarIntervalo(int lo, int hi, Visitante visitar) const {
+        vector<uint32_t> pilha;
+        uint32_t atual = raiz;
+        size_t passos = 0;
+        while (atual != SEM_NO || !pilha.empty()) {
+            while (atual != SEM_NO) {
+                conferirPasso(atual, passos);
+                if (nos[atual].valor < lo) {
+                    atual = nos[atual].direita;
+                } else {
+                    pilha.push_back(atual);
+                    atual = nos[atual].esquerda;
+                }
+            }
+            if (pilha.empty()) break;
+            uint32_t i = pilha.back();
+            pilha.pop_back();
+            if (nos[i].valor > hi) break;
+            visitar(nos[i].valor);
+            atual = nos[i].direita;
+        }
+    }
+
+    size_t tamanho() const {
+        return vivos;
+    }
+};
+
+// -----------------------------------------------------------------
+// EXECUÇÃO PARALELA (divisão e conquista das operações de conjunto)
+// -----------------------------------------------------------------
+
+/**
+ * @brief Quantos níveis da recursão ainda abrem uma thread nova. Com
+ * 2^d >= núcleos, os d primeiros níveis já ocupam todos os núcleos e,
+ * abaixo deles, cada thread continua em sequência.
+ */
+int niveisParalelos() {
+    static const int niveis = [] {
+        unsigned nucleos = thread::hardware_concurrency();
+        int d = 0;
+        while ((1u << d) < nucleos) d++;
+        return d;
+    }();
+    return niveis;
+}
+
+/**
+ * @brief Executa as duas tarefas independentes: em paralelo (a primeira
+ * numa thread nova) nos níveis rasos da recursão, em sequência abaixo.
+ */
+template <typename Tarefa1, typename Tarefa2>
+void executarEmParalelo(int nivel, Tarefa1 tarefa1, Tarefa2 tarefa2) {
+    if (nivel < niveisParalelos()) {
+        thread t(tarefa1);
+        tarefa2();
+        t.join();
+    } else {
+        tarefa1();
+        tarefa2();
+    }
+}
+
+// -----------------------------------------------------------------
+// VARIANTE BALANCEADA (Treap)
+// -----------------------------------------------------------------
+
+/**
+ * @brief Nó da Treap: além do valor, guarda uma prioridade aleatória.
+ * A árvore é uma BST pelos valores e um heap (máximo) pelas prioridades.
+ */
+struct NoTreap {
+    int valor;
+    unsigned prioridade;
+    NoTreap *esquerda;
+    NoTreap *direita;
+
+    NoTreap(int v, unsigned p) {
+        valor = v;
+        prioridade = p;
+        esquerda = nullptr;
+        direita = nullptr;
+    }
+};
+
+/**
+ * @brief Árvore balanceada com a mesma interface de ArvoreBinariaBusca.
+ *
+ * Como as prioridades são sorteadas, o formato da árvore não depende da
+ * ordem de chegada dos valores: entradas quase ordenadas (timestamps,
+ * ids) continuam com altura esperada O(log n), e inserir/remover/contem
+ * custam O(log n) esperado mesmo com entrada adversária.
+ */
+class ArvoreBalanceada {
+private:
+    NoTreap* raiz;
+    unsigned long long semente; // Estado do gerador xorshift das prioridades
+
+    unsigned sortearPrioridade() {
+        semente ^= semente << 13;
+        semente ^= semente >> 7;
+        semente ^= semente << 17;
+        return (unsigned)(semente >> 32);
+    }
+
+    // Rotação à Direita: o filho esquerdo sobe.
+    NoTreap* rotacaoDireita(NoTreap* y) {
+        NoTreap* x = y->esquerda;
+        y->esquerda = x->direita;
+        x->direita = y;
+        return x;
+    }
+
+    // Rotação à Esquerda: o filho direito sobe.
+    NoTreap* rotacaoEsquerda(NoTreap* x) {
+        NoTreap* y = x->direita;
+        x->direita = y->esquerda;
+        y->esquerda = x;
+        return y;
+    }
+
+    NoTreap* inserirRec(NoTreap* no, int valor) {
+        // 1. Inserção padrão de BST
+        if (no == nullptr) {
+            return new NoTreap(valor, sortearPrioridade());
+        }
+
+        if (valor < no->valor) {
+            no->esquerda = inserirRec(no->esquerda, valor);
+            // 2. Se o filho tem prioridade maior, ele sobe
+            if (no->esquerda->prioridade > no->prioridade) {
+                no = rotacaoDireita(no);
+            }
+        } else if (valor > no->valor) {
+            no->direita = inserirRec(no->direita, valor);
+            if (no->direita->prioridade > no->prioridade) {
+                no = rotacaoEsquerda(no);
+            }
+        }
+        // Valores duplicados são ignorados, como em ArvoreBinariaBusca
+        return no;
+    }
+
+    NoTreap* removerRec(NoTreap* no, int valor) {
+        if (no == nullptr) {
+            return no; // Valor não encontrado
+        }
+
+        if (valor < no->valor) {
+            no->esquerda = removerRec(no->esquerda, valor);
+        } else if (valor > no->valor) {
+            no->direita = removerRec(no->direita, valor);
+        } else {
+            // Nó encontrado: com 0 ou 1 filho ele sai direto...
+            if (no->esquerda == nullptr || no->direita == nullptr) {
+                NoTreap* temp = no->esquerda ? no->esquerda : no->direita;
+                delete no;
+                return temp;
+            }
+            // ...com 2 filhos, o filho de maior prioridade sobe e o nó
+            // desce até poder ser retirado.
+            if (no->esquerda->prioridade > no->direita->prioridade) {
+                no = rotacaoDireita(no);
+                no->direita = removerRec(no->direita, valor);
+            } else {
+                no = rotacaoEsquerda(no);
+                no->esquerda = removerRec(no->esquerda, valor);
+            }
+        }
+        return no;
+    }
+
+    void listarEmOrdemRec(NoTreap* no) {
+        if (no != nullptr) {
+            listarEmOrdemRec(no->esquerda);
+            cout << no->valor << " ";
+            listarEmOrdemRec(no->direita);
+        }
+    }
+
+    void listarPreOrdemRec(NoTreap* no) {
+        if (no != nullptr) {
+            cout << no->valor << " ";
+            listarPreOrdemRec(no->esquerda);
+            listarPreOrdemRec(no->direita);
+        }
+    }
+
+    int alturaRec(NoTreap* no) const {
+        if (no == nullptr) return 0;
+        return 1 + max(alturaRec(no->esquerda), alturaRec(no->direita));
+    }
+
+    // --- Operações de conjunto por divisão/junção ---
+
+    /**
+     * @brief Divide a treap 't' pelo valor k: 'menores' (< k), 'igual'
+     * (o nó com k, desligado, ou nulo) e 'maiores' (> k). O(log n) esperado.
+     */
+    static void dividir(NoTreap* t, int k, NoTreap*& menores, NoTreap*& igual, NoTreap*& maiores) {
+        if (t == nullptr) {
+            menores = igual = maiores = nullptr;
+        } else if (k < t->valor) {
+            dividir(t->esquerda, k, menores, igual, t->esquerda);
+            maiores = t;
+        } else if (k > t->valor) {
+            dividir(t->direita, k, t->direita, igual, maiores);
+            menores = t;
+        } else {
+            menores = t->esquerda;
+            maiores = t->direita;
+            t->esquerda = t->direita = nullptr;
+            igual = t;
+        }
+    }
+
+    /**
+     * @brief Junta duas treaps em que todo valor de 'a' é menor que todo
+     * valor de 'b', respeitando as prioridades. O(log n) esperado.
+     */
+    static NoTreap* juntar(NoTreap* a, NoTreap* b) {
+        if (a == nullptr) return b;
+        if (b == nullptr) return a;
+        if (a->prioridade > b->prioridade) {
+            a->direita = juntar(a->direita, b);
+            return a;
+        }
+        b->esquerda = juntar(a, b->esquerda);
+        return b;
+    }
+
+    static long long contarNos(const NoTreap* no) {
+        if (no == nullptr) return 0;
+        return 1 + contarNos(no->esquerda) + contarNos(no->direita);
+    }
+
+    static void liberar(NoTreap* no) {
+        if (no == nullptr) return;
+        liberar(no->esquerda);
+        liberar(no->direita);
+        delete no;
+    }
+
+    /**
+     * @brief União: a raiz de maior prioridade divide a outra treap, e as
+     * duas metades são unidas recursivamente (e em paralelo).
+     * Custo O(m log(n/m + 1)) esperado, com m <= n os tamanhos.
+     */
+    static NoTreap* uniao(NoTreap* a, NoTreap* b, int nivel) {
+        if (a == nullptr) return b;
+        if (b == nullptr) return a;
+        if (a->prioridade < b->prioridade) swap(a, b);
+
+        NoTreap *menores, *igual, *maiores;
+        dividir(b, a->valor, menores, igual, maiores);
+        delete igual; // Já presente em 'a' (nulo se não havia)
+        NoTreap* esquerda = a->esquerda;
+        NoTreap* direita = a->direita;
+        executarEmParalelo(nivel,
+            [&] { esquerda = uniao(esquerda, menores, nivel + 1); },
+            [&] { direita = uniao(direita, maiores, nivel + 1); });
+        a->esquerda = esquerda;
+        a->direita = direita;
+        return a;
+    }
+
+    static NoTreap* intersecao(NoTreap* a, NoTreap* b, int nivel) {
+        if (a == nullptr || b == nullptr) {
+            liberar(a);
+            liberar(b);
+            return nullptr;
+        }
+        if (a->prioridade < b->prioridade) swap(a, b);
+
+        NoTreap *menores, *igual, *maiores;
+        dividir(b, a->valor, menores, igual, maiores);
+        NoTreap* esquerda = a->esquerda;
+        NoTreap* direita = a->direita;
+        executarEmParalelo(nivel,
+            [&] { esquerda = intersecao(esquerda, menores, nivel + 1); },
+            [&] { direita = intersecao(direita, maiores, nivel + 1); });
+
+        if (igual == nullptr) {
+            // O valor de 'a' não está em 'b': o nó sai.
+            delete a;
+            return juntar(esquerda, direita);
+        }
+        delete igual;
+        a->esquerda = esquerda;
+        a->direita = direita;
+        return a;
+    }
+
+    /**
+     * @brief Diferença a - b: divide 'a' pela raiz de 'b' e subtrai as
+     * sub-árvores de 'b' das metades correspondentes (em paralelo).
+     */
+    static NoTreap* diferenca(NoTreap* a, NoTreap* b, int nivel) {
+        if (a == nullptr) {
+            liberar(b);
+            return nullptr;
+        }
+        if (b == nullptr) return a;
+
+        NoTreap *menores, *igual, *maiores;
+        dividir(a, b->valor, menores, igual, maiores);
+        NoTreap* esquerda = nullptr;
+        NoTreap* direita = nullptr;
+        NoTreap* bEsquerda = b->esquerda;
+        NoTreap* bDireita = b->direita;
+        executarEmParalelo(nivel,
+            [&] { esquerda = diferenca(menores, bEsquerda, nivel + 1); },
+            [&] { direita = diferenca(maiores, bDireita, nivel + 1); });
+        delete igual;
+        delete b;
+        return juntar(esquerda, direita);
+    }
+
+public:
+    ArvoreBalanceada() : raiz(nullptr) {
+        random_device rd;
+        semente = ((unsigned long long)rd() << 32) | rd() | 1;
+    }
+
+    ~ArvoreBalanceada() {
+        liberar(raiz);
+    }
+
+    ArvoreBalanceada(const ArvoreBalanceada&) = delete;
+    ArvoreBalanceada& operator=(const ArvoreBalanceada&) = delete;
+
+    void inserir(int valor) {
+        raiz = inserirRec(raiz, valor);
+    }
+
+    void remover(int valor) {
+        raiz = removerRec(raiz, valor);
+    }
+
+    bool contem(int valor) const {
+        const NoTreap* atual = raiz;
+        while (atual != nullptr) {
+            if (valor < atual->valor) {
+                atual = atual->esquerda;
+            } else if (valor > atual->valor) {
+                atual = atual->direita;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void listarEmOrdem() {
+        cout << "[Em-Ordem]:   ";
+        listarEmOrdemRec(raiz);
+        cout << endl;
+    }
+
+    void listarPreOrdem() {
+        cout << "[Pre-Ordem]:  ";
+        listarPreOrdemRec(raiz);
+        cout << endl;
+    }
+
+    // Altura da árvore (0 se vazia), útil para conferir o balanceamento.
+    int altura() const {
+        return alturaRec(raiz);
+    }
+
+    // -----------------------------------------------------------------
+    // OPERAÇÕES DE CONJUNTO (os nós de 'outra' são reaproveitados ou
+    // liberados: 'outra' sempre termina vazia)
+    // -----------------------------------------------------------------
+
+    // Número de valores distintos (percorre a árvore).
+    long long tamanho() const {
+        return contarNos(raiz);
+    }
+
+    // this = this ∪ outra
+    void unir(ArvoreBalanceada& outra) {
+        raiz = uniao(raiz, outra.raiz, 0);
+        outra.raiz = nullptr;
+    }
+
+    // this = this ∩ outra
+    void intersectar(ArvoreBalanceada& outra) {
+        raiz = intersecao(raiz, outra.raiz, 0);
+        outra.raiz = nullptr;
+    }
+
+    // this = this - outra
+    void subtrair(ArvoreBalanceada& outra) {
+        raiz = diferenca(raiz, outra.raiz, 0);
+        outra.raiz = nullptr;
+    }
+};
+
+// -----------------------------------------------------------------
+// VARIANTE CONCORRENTE (leituras sem trava, escritas com travas por nó)
+// -----------------------------------------------------------------
+
+// Máximo de threads operando ao mesmo tempo numa árvore concorrente.
+const int MAX_THREADS_COLETOR = 128;
+
+/**
+ * @brief Reserva um índice (0 a MAX_THREADS_COLETOR-1) para a thread e o
+ * devolve quando ela termina, para que threads novas reaproveitem os
+ * índices das que já saíram.
+ */
+class IndiceDeThread {
+private:
+    static atomic<bool>* ocupados() {
+        static atomic<bool> ocupado[MAX_THREADS_COLETOR]; // Começam em false
+        return ocupado;
+    }
+
+    int indice;
+
+public:
+    IndiceDeThread() : indice(MAX_THREADS_COLETOR) {
+        for (int i = 0; i < MAX_THREADS_COLETOR; i++) {
+            bool livre = false;
+            if (ocupados()[i].compare_exchange_strong(livre, true)) {
+                indice = i;
+                return;
+            }
+        }
+    }
+
+    ~IndiceDeThread() {
+        if (indice < MAX_THREADS_COLETOR) {
+            ocupados()[indice].store(false);
+        }
+    }
+
+    int valor() const {
+        return indice;
+    }
+};
+
+/**
+ * @brief Índice da thread atual, usado pelos coletores por épocas.
+ */
+int indiceDaThread() {
+    thread_local IndiceDeThread registro;
+    return registro.valor();
+}
+
+/**
+ * @brief Recuperação de memória por épocas (EBR).
+ *
+ * Um nó retirado da árvore ainda pode estar sendo lido por outra thread,
+ * então ele não pode ser liberado na hora. Cada operação anuncia a época
+ * global em que entrou; um nó retirado na época e só é liberado quando a
+ * época global chega a e+2, pois aí nenhuma thread ativa pode ter
+ * começado antes da retirada.
+ */
+template <typename T>
+class ColetorPorEpocas {
+private:
+    static const int MAX_THREADS = MAX_THREADS_COLETOR;
+    static const size_t LIMITE_PENDENTES = 64; // Tenta coletar a cada 64 retiradas
+    static const unsigned long long INATIVA = 0;
+
+    struct Retirado {
+        T* no;
+        unsigned long long epoca;
+    };
+
+    // Uma entrada por thread, cada uma na sua linha de cache.
+    struct alignas(64) Participante {
+        atomic<unsigned long long> epoca; // INATIVA ou a época de entrada
+        vector<Retirado> pendentes;       // Só a própria thread mexe aqui
+
+        Participante() : epoca(INATIVA) {}
+    };
+
+    atomic<unsigned long long> epocaGlobal;
+    Participante participantes[MAX_THREADS];
+
+    Participante& meu() {
+        int i = indiceDaThread();
+        if (i >= MAX_THREADS) {
+            throw runtime_error("Erro: threads demais para o coletor por epocas.");
+        }
+        return participantes[i];
+    }
+
+    // Avança a época global se todas as threads ativas já a viram.
+    void tentarAvancar() {
+        unsigned long long e = epocaGlobal.load();
+        for (const Participante& p : participantes) {
+            unsigned long long vista = p.epoca.load();
+            if (vista != INATIVA && vista != e) return;
+        }
+        epocaGlobal.compare_exchange_strong(e, e + 1);
+    }
+
+    void coletar(Participante& p) {
+        unsigned long long e = epocaGlobal.load();
+        size_t mantidos = 0;
+        for (const Retirado& r : p.pendentes) {
+            if (r.epoca + 2 <= e) {
+                delete r.no;
+            } else {
+                p.pendentes[mantidos++] = r;
+            }
         }
+        p.pendentes.resize(mantidos);
+    }
 
-        // 2. Caso recursivo: Decide se vai para a esquerda ou direita.
-        if (valor < no->valor) {
-            no->esquerda = inserirRec(no->esquerda, valor);
-        } else if (valor > no->valor) {
-            // Assumindo que não inserimos valores duplicados
-            no->direita = inserirRec(no->direita, valor);
+public:
+    ColetorPorEpocas() : epocaGlobal(1) {}
+
+    // Só deve ser destruído quando nenhuma thread estiver operando.
+    ~ColetorPorEpocas() {
+        for (Participante& p : participantes) {
+            for (const Retirado& r : p.pendentes) {
+                delete r.no;
+            }
         }
+    }
 
-        // Retorna o nó (inalterado ou com o novo filho)
-        return no;
+    void entrar() {
+        meu().epoca.store(epocaGlobal.load());
     }
 
-    
-    void listarEmOrdemRec(No* no) {
-        if (no != nullptr) {
-            listarEmOrdemRec(no->esquerda);
-            cout << no->valor << " ";
-            listarEmOrdemRec(no->direita);
+    void sair() {
+        meu().epoca.store(INATIVA, memory_order_release);
+    }
+
+    // Agenda a liberação de um nó que já foi desligado da árvore.
+    void retirar(T* no) {
+        Participante& p = meu();
+        p.pendentes.push_back(Retirado{no, epocaGlobal.load()});
+        if (p.pendentes.size() >= LIMITE_PENDENTES) {
+            tentarAvancar();
+            coletar(p);
         }
     }
 
-   
-    void listarPreOrdemRec(No* no) {
-        if (no != nullptr) {
-            cout << no->valor << " ";
-            listarPreOrdemRec(no->esquerda);
-            listarPreOrdemRec(no->direita);
+    // Marca a thread como ativa durante o escopo (RAII).
+    struct Guarda {
+        ColetorPorEpocas& coletor;
+        Guarda(ColetorPorEpocas& c) : coletor(c) { coletor.entrar(); }
+        ~Guarda() { coletor.sair(); }
+    };
+};
+
+/**
+ * @brief Nó da árvore concorrente. A árvore é "externa": os valores ficam
+ * só nas folhas e os nós internos apenas roteiam a busca (esquerda se
+ * chave < nó->chave). As chaves nunca mudam; só os filhos mudam, e sempre
+ * por escrita atômica, então leitores nunca veem um nó pela metade.
+ */
+struct NoConcorrente {
+    const long long chave; // long long: as sentinelas ficam acima de INT_MAX
+    const bool folha;
+    atomic<NoConcorrente*> esquerda;
+    atomic<NoConcorrente*> direita;
+    atomic<bool> removido; // Nó interno já desligado da árvore
+    atomic<bool> trava;    // Trava de escrita (spinlock) do nó
+
+    NoConcorrente(long long c, bool f, NoConcorrente* esq = nullptr, NoConcorrente* dir = nullptr)
+        : chave(c), folha(f), esquerda(esq), direita(dir), removido(false), trava(false) {}
+
+    void travar() {
+        while (trava.exchange(true, memory_order_acquire)) {
+            while (trava.load(memory_order_relaxed)) {
+                this_thread::yield();
+            }
         }
     }
 
-    // -----------------------------------------------------------------
-    // F3: FUNÇÃO DE REMOÇÃO (Privada - Recursiva)
-    // -----------------------------------------------------------------
-    
-    /**
-     * @brief Encontra o nó com o menor valor na sub-árvore (o sucessor Em-Ordem).
-     * Usado na remoção de um nó com dois filhos.
-     */
-    No* encontrarMinimo(No* no) {
-        No* atual = no;
-        // O menor valor está sempre no filho mais à esquerda.
-        while (atual != nullptr && atual->esquerda != nullptr) {
-            atual = atual->esquerda;
+    void destravar() {
+        trava.store(false, memory_order_release);
+    }
+
+    // Filho pelo qual a busca por 'c' continua.
+    atomic<NoConcorrente*>& filhoPara(long long c) {
+        return (c < chave) ? esquerda : direita;
+    }
+};
+
+/**
+ * @brief Conjunto de inteiros seguro para várias threads, com a mesma
+ * interface de ArvoreBinariaBusca (inserir, remover, contem).
+ *
+ *  - contem(): não trava nada e não repete; só desce lendo ponteiros
+ *    atômicos (wait-free).
+ *  - inserir(): trava apenas o pai da folha onde o valor entra.
+ *  - remover(): trava o avô e o pai da folha (sempre de cima para baixo,
+ *    o que evita deadlock), liga o irmão da folha direto no avô e entrega
+ *    pai e folha ao coletor por épocas.
+ * Se a validação após travar falhar (outra thread mudou o trecho), a
+ * operação recomeça.
+ */
+class ArvoreConcorrente {
+private:
+    static constexpr long long INFINITO1 = (long long)INT_MAX + 1;
+    static constexpr long long INFINITO2 = (long long)INT_MAX + 2;
+
+    NoConcorrente* raiz;
+    ColetorPorEpocas<NoConcorrente> coletor;
+
+    struct Busca {
+        NoConcorrente* avo;
+        NoConcorrente* pai;
+        NoConcorrente* folha;
+    };
+
+    Busca buscar(long long c) {
+        Busca b{nullptr, raiz, raiz->esquerda.load(memory_order_acquire)};
+        while (!b.folha->folha) {
+            b.avo = b.pai;
+            b.pai = b.folha;
+            b.folha = b.folha->filhoPara(c).load(memory_order_acquire);
         }
-        return atual;
+        return b;
     }
 
-    /**
-     * @brief Remove um valor da árvore recursivamente.
-     * @param no Nó atual na recursão.
-     * @param valor O valor a ser removido.
-     * @return O nó que substitui o nó removido na árvore.
-     */
-    No* removerRec(No* no, int valor) {
-        // 1. Caso base: Nó nulo, valor não encontrado.
-        if (no == nullptr) {
-            return no;
+public:
+    ArvoreConcorrente() {
+        // Sentinelas: todo valor real fica abaixo de um nó interno e de um
+        // avô, então remover() sempre encontra os dois.
+        raiz = new NoConcorrente(INFINITO2, false,
+                                 new NoConcorrente(INFINITO1, true),
+                                 new NoConcorrente(INFINITO2, true));
+    }
+
+    ~ArvoreConcorrente() {
+        vector<NoConcorrente*> pilha{raiz};
+        while (!pilha.empty()) {
+            NoConcorrente* no = pilha.back();
+            pilha.pop_back();
+            if (!no->folha) {
+                pilha.push_back(no->esquerda.load());
+                pilha.push_back(no->direita.load());
+            }
+            delete no;
         }
+    }
 
-        // 2. Procurando o nó a ser removido
-        if (valor < no->valor) {
-            no->esquerda = removerRec(no->esquerda, valor);
-        } else if (valor > no->valor) {
-            no->direita = removerRec(no->direita, valor);
+    ArvoreConcorrente(const ArvoreConcorrente&) = delete;
+    ArvoreConcorrente& operator=(const ArvoreConcorrente&) = delete;
+
+    bool contem(int valor) {
+        typename ColetorPorEpocas<NoConcorrente>::Guarda guarda(coletor);
+        return buscar(valor).folha->chave == valor;
+    }
+
+    // Devolve false se o valor já existia.
+    bool inserir(int valor) {
+        while (true) {
+            typename ColetorPorEpocas<NoConcorrente>::Guarda guarda(coletor);
+            Busca b = buscar(valor);
+            if (b.folha->chave == valor) {
+                return false;
+            }
+
+            b.pai->travar();
+            if (!b.pai->removido.load() && b.pai->filhoPara(valor).load() == b.folha) {
+                // A folha antiga e a nova viram filhas de um novo nó interno.
+                NoConcorrente* nova = new NoConcorrente(valor, true);
+                NoConcorrente* interno = (valor < b.folha->chave)
+                    ? new NoConcorrente(b.folha->chave, false, nova, b.folha)
+                    : new NoConcorrente(valor, false, b.folha, nova);
+                b.pai->filhoPara(valor).store(interno, memory_order_release);
+                b.pai->destravar();
+                return true;
+            }
+            b.pai->destravar();
         }
-        // 3. Nó encontrado (valor == no->valor)
-        else {
-            // CASO 1: Nó com 0 ou 1 filho (à direita)
-            if (no->esquerda == nullptr) {
-                No* temp = no->direita;
-                delete no; // Libera a memória
-                return temp; // Retorna o filho da direita (ou nullptr) para o pai
+    }
+
+    // Devolve false se o valor não existia.
+    bool remover(int valor) {
+        while (true) {
+            typename ColetorPorEpocas<NoConcorrente>::Guarda guarda(coletor);
+            Busca b = buscar(valor);
+            if (b.folha->chave != valor) {
+                return false;
+            }
+
+            b.avo->travar();
+            b.pai->travar();
+            bool valido = !b.avo->removido.load() && !b.pai->removido.load()
+                       && b.avo->filhoPara(valor).load() == b.pai
+                       && b.pai->filhoPara(valor).load() == b.folha;
+            if (valido) {
+                NoConcorrente* irmao = (b.pai->esquerda.load() == b.folha)
+                                     ? b.pai->direita.load() : b.pai->esquerda.load();
+                b.avo->filhoPara(valor).store(irmao, memory_order_release);
+                b.pai->removido.store(true);
             }
-            // CASO 2: Nó com 1 filho (à esquerda)
-            else if (no->direita == nullptr) {
-                No* temp = no->esquerda;
-                delete no; // Libera a memória
-                return temp; // Retorna o filho da esquerda para o pai
+            b.pai->destravar();
+            b.avo->destravar();
+            if (valido) {
+                coletor.retirar(b.pai);
+                coletor.retirar(b.folha);
+                return true;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Vazão (milhões de operações/s) com 'threads' threads fazendo
+ * 'porThread' operações cada, com 'percentualLeitura'% de contem() e o
+ * resto dividido entre inserir() e remover().
+ */
+template <typename Conjunto>
+double medirVazao(Conjunto& conjunto, int threads, int porThread, int percentualLeitura, int faixa) {
+    vector<thread> trabalhadores;
+    auto inicio = chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        trabalhadores.emplace_back([&conjunto, t, porThread, percentualLeitura, faixa] {
+            mt19937 gerador(1000 + t);
+            for (int i = 0; i < porThread; i++) {
+                int valor = (int)(gerador() % faixa);
+                int sorteio = (int)(gerador() % 100);
+                if (sorteio < percentualLeitura) {
+                    conjunto.contem(valor);
+                } else if ((sorteio - percentualLeitura) % 2 == 0) {
+                    conjunto.inserir(valor);
+                } else {
+                    conjunto.remover(valor);
+                }
             }
+        });
+    }
+    for (thread& t : trabalhadores) t.join();
+    auto fim = chrono::steady_clock::now();
+    double segundos = chrono::duration<double>(fim - inicio).count();
+    return (double)threads * porThread / segundos / 1e6;
+}
+
+// ArvoreBinariaBusca protegida por uma única trava global (referência).
+class ArvoreComTravaGlobal {
+private:
+    ArvoreBinariaBusca arvore;
+    mutex trava;
+
+public:
+    bool contem(int valor) { lock_guard<mutex> g(trava); return arvore.contem(valor); }
+    void inserir(int valor) { lock_guard<mutex> g(trava); arvore.inserir(valor); }
+    void remover(int valor) { lock_guard<mutex> g(trava); arvore.remover(valor); }
+};
+
+// -----------------------------------------------------------------
+// VARIANTE PERSISTENTE (cópia de caminho + contagem de referências)
+// -----------------------------------------------------------------
+
+/**
+ * @brief Nó imutável: depois de criado, valor e filhos nunca mudam.
+ * Cada ponteiro que aponta para o nó (de um pai ou de uma versão) conta
+ * uma referência; quando a contagem zera, o nó é liberado.
+ */
+struct NoPersistente {
+    const int valor;
+    NoPersistente* const esquerda;
+    NoPersistente* const direita;
+    atomic<int> referencias;
+
+    static atomic<long long> vivos; // Nós existentes (para medir o compartilhamento)
+
+    NoPersistente(int v, NoPersistente* esq, NoPersistente* dir)
+        : valor(v), esquerda(esq), direita(dir), referencias(1) {
+        vivos.fetch_add(1, memory_order_relaxed);
+    }
 
-            // CASO 3: Nó com 2 filhos
-            // 1. Encontra o sucessor Em-Ordem (menor valor na sub-árvore direita)
-            No* temp = encontrarMinimo(no->direita);
-            
-            // 2. Copia o valor do sucessor para este nó
-            no->valor = temp->valor;
+    ~NoPersistente() {
+        vivos.fetch_sub(1, memory_order_relaxed);
+    }
 
-            // 3. Remove o nó sucessor (que agora é duplicado) da sub-árvore direita
-            no->direita = removerRec(no->direita, temp->valor);
+    // Mais uma referência para 'no' (pode ser nulo).
+    static NoPersistente* compartilhar(NoPersistente* no) {
+        if (no != nullptr) {
+            no->referencias.fetch_add(1, memory_order_relaxed);
         }
         return no;
     }
 
-    /**
-     * @brief Libera toda a memória da árvore (usado no destrutor).
-     * Faz um percurso Pós-Ordem para deletar.
-     */
-    void deletarArvore(No* no) {
-        if (no == nullptr) return;
-        deletarArvore(no->esquerda);
-        deletarArvore(no->direita);
-        delete no;
+    // Solta uma referência; libera em cascata (sem recursão) o que zerar.
+    static void soltar(NoPersistente* no) {
+        vector<NoPersistente*> pendentes;
+        if (no != nullptr) pendentes.push_back(no);
+        while (!pendentes.empty()) {
+            NoPersistente* atual = pendentes.back();
+            pendentes.pop_back();
+            if (atual->referencias.fetch_sub(1, memory_order_acq_rel) == 1) {
+                if (atual->esquerda) pendentes.push_back(atual->esquerda);
+                if (atual->direita) pendentes.push_back(atual->direita);
+                delete atual;
+            }
+        }
     }
+};
+
+atomic<long long> NoPersistente::vivos(0);
+
+/**
+ * @brief Versão imutável (instantâneo) da árvore persistente.
+ * Copiar uma versão custa O(1) (só uma referência a mais na raiz), e
+ * ela pode ser lida por qualquer thread sem travas enquanto a árvore
+ * original continua recebendo inserções e remoções.
+ */
+class VersaoPersistente {
+private:
+    NoPersistente* raiz;
 
 public:
-    // Construtor: Inicializa a árvore com a raiz nula.
-    ArvoreBinariaBusca() : raiz(nullptr) {}
+    explicit VersaoPersistente(NoPersistente* r = nullptr) : raiz(r) {}
 
-    // Destrutor: Limpa toda a memória alocada.
-    ~ArvoreBinariaBusca() {
-        deletarArvore(raiz);
+    VersaoPersistente(const VersaoPersistente& outra)
+        : raiz(NoPersistente::compartilhar(outra.raiz)) {}
+
+    VersaoPersistente& operator=(const VersaoPersistente& outra) {
+        NoPersistente* nova = NoPersistente::compartilhar(outra.raiz);
+        NoPersistente::soltar(raiz);
+        raiz = nova;
+        return *this;
     }
 
-    // -----------------------------------------------------------------
-    // INTERFACE PÚBLICA (Funções F1, F2, F3)
-    // -----------------------------------------------------------------
+    ~VersaoPersistente() {
+        NoPersistente::soltar(raiz);
+    }
 
-    /**
-     * @brief F1: Insere um valor na árvore.
-     */
-    void inserir(int valor) {
-        raiz = inserirRec(raiz, valor);
+    bool contem(int valor) const {
+        const NoPersistente* atual = raiz;
+        while (atual != nullptr) {
+            if (valor < atual->valor) {
+                atual = atual->esquerda;
+            } else if (valor > atual->valor) {
+                atual = atual->direita;
+            } else {
+                return true;
+            }
+        }
+        return false;
     }
 
     /**
-     * @brief F2: Lista a árvore (Em-Ordem).
-     * Em-Ordem (In-Order) mostra os elementos de forma ordenada.
+     * @brief Visita os valores em ordem crescente (pilha explícita).
      */
-    void listarEmOrdem() {
+    template <typename Visitante>
+    void visitarEmOrdem(Visitante visitar) const {
+        vector<const NoPersistente*> pilha;
+        const NoPersistente* atual = raiz;
+        while (atual != nullptr || !pilha.empty()) {
+            while (atual != nullptr) {
+                pilha.push_back(atual);
+                atual = atual->esquerda;
+            }
+            atual = pilha.back();
+            pilha.pop_back();
+            visitar(atual->valor);
+            atual = atual->direita;
+        }
+    }
+
+    void listarEmOrdem() const {
         cout << "[Em-Ordem]:   ";
-        listarEmOrdemRec(raiz);
+        visitarEmOrdem([](int v) { cout << v << " "; });
         cout << endl;
     }
-    
+};
+
+/**
+ * @brief Árvore persistente: mesma interface de ArvoreBinariaBusca, mas
+ * cada inserir/remover cria uma nova raiz copiando apenas o caminho
+ * alterado (O(h) nós novos) e compartilhando todas as outras
+ * sub-árvores com as versões anteriores.
+ *
+ * As escritas são serializadas entre si; a troca da raiz publicada é a
+ * única seção crítica compartilhada com instantaneo(), e dura O(1).
+ * Quem já tem uma VersaoPersistente nunca espera nem faz ninguém esperar.
+ */
+class ArvorePersistente {
+private:
+    NoPersistente* raiz;
+    mutex travaEscrita; // Uma escrita por vez
+    mutex travaRaiz;    // Protege só a leitura/troca do ponteiro 'raiz'
+
+    // Publica a nova raiz e solta a referência da antiga (fora da trava).
+    void publicar(NoPersistente* nova) {
+        NoPersistente* antiga;
+        {
+            lock_guard<mutex> g(travaRaiz);
+            antiga = raiz;
+            raiz = nova;
+        }
+        NoPersistente::soltar(antiga);
+    }
+
     /**
-     * @brief F2: Lista a árvore (Pré-Ordem).
-     * Pré-Ordem (Pre-Order) é útil para ver a estrutura da árvore.
+     * @brief Reconstrói, de baixo para cima, as cópias dos nós do caminho
+     * (da raiz até o pai do ponto alterado), pendurando 'base' no lugar
+     * certo e compartilhando os irmãos que não mudaram.
      */
-    void listarPreOrdem() {
-        cout << "[Pre-Ordem]:  ";
-        listarPreOrdemRec(raiz);
-        cout << endl;
+    static NoPersistente* copiarCaminho(const vector<NoPersistente*>& caminho, int valor,
+                                        NoPersistente* base) {
+        for (size_t i = caminho.size(); i-- > 0;) {
+            NoPersistente* p = caminho[i];
+            if (valor < p->valor) {
+                base = new NoPersistente(p->valor, base, NoPersistente::compartilhar(p->direita));
+            } else {
+                base = new NoPersistente(p->valor, NoPersistente::compartilhar(p->esquerda), base);
+            }
+        }
+        return base;
+    }
+
+public:
+    ArvorePersistente() : raiz(nullptr) {}
+
+    ~ArvorePersistente() {
+        NoPersistente::soltar(raiz);
     }
 
+    ArvorePersistente(const ArvorePersistente&) = delete;
+    ArvorePersistente& operator=(const ArvorePersistente&) = delete;
+
     /**
-     * @brief F3: Remove um valor da árvore.
+     * @brief Instantâneo O(1) do estado atual.
      */
+    VersaoPersistente instantaneo() {
+        lock_guard<mutex> g(travaRaiz);
+        return VersaoPersistente(NoPersistente::compartilhar(raiz));
+    }
+
+    void inserir(int valor) {
+        lock_guard<mutex> g(travaEscrita);
+        vector<NoPersistente*> caminho;
+        for (NoPersistente* no = raiz; no != nullptr;) {
+            if (valor == no->valor) {
+                return; // Sem duplicatas: nenhuma versão nova
+            }
+            caminho.push_back(no);
+            no = (valor < no->valor) ? no->esquerda : no->direita;
+        }
+        publicar(copiarCaminho(caminho, valor, new NoPersistente(valor, nullptr, nullptr)));
+    }
+
     void remover(int valor) {
-        raiz = removerRec(raiz, valor);
+        lock_guard<mutex> g(travaEscrita);
+        vector<NoPersistente*> caminho;
+        NoPersistente* alvo = raiz;
+        while (alvo != nullptr && alvo->valor != valor) {
+            caminho.push_back(alvo);
+            alvo = (valor < alvo->valor) ? alvo->esquerda : alvo->direita;
+        }
+        if (alvo == nullptr) {
+            return; // Valor não encontrado
+        }
+
+        NoPersistente* substituto;
+        if (alvo->esquerda == nullptr) {
+            // CASO 1: 0 ou 1 filho (à direita)
+            substituto = NoPersistente::compartilhar(alvo->direita);
+        } else if (alvo->direita == nullptr) {
+            // CASO 2: 1 filho (à esquerda)
+            substituto = NoPersistente::compartilhar(alvo->esquerda);
+        } else {
+            // CASO 3: 2 filhos. O sucessor (mínimo da direita) sobe; o
+            // caminho até ele dentro da sub-árvore direita é copiado.
+            vector<NoPersistente*> caminhoMinimo;
+            NoPersistente* minimo = alvo->direita;
+            while (minimo->esquerda != nullptr) {
+                caminhoMinimo.push_back(minimo);
+                minimo = minimo->esquerda;
+            }
+            NoPersistente* novaDireita = copiarCaminho(caminhoMinimo, minimo->valor,
+                                                       NoPersistente::compartilhar(minimo->direita));
+            substituto = new NoPersistente(minimo->valor,
+                                           NoPersistente::compartilhar(alvo->esquerda),
+                                           novaDireita);
+        }
+        publicar(copiarCaminho(caminho, valor, substituto));
+    }
+
+    bool contem(int valor) {
+        return instantaneo().contem(valor);
+    }
+
+    void listarEmOrdem() {
+        instantaneo().listarEmOrdem();
     }
 };
 
+// --- Comparativo de desempenho (entrada ordenada x aleatória) ---
+
+/**
+ * @brief Mede o tempo (ms) para inserir e depois consultar os valores dados.
+ */
+template <typename Arvore>
+double medirInsercoesEConsultas(const vector<int>& valores) {
+    auto inicio = chrono::steady_clock::now();
+    Arvore arvore;
+    for (int v : valores) {
+        arvore.inserir(v);
+    }
+    int encontrados = 0;
+    for (int v : valores) {
+        encontrados += arvore.contem(v);
+    }
+    auto fim = chrono::steady_clock::now();
+    if (encontrados != (int)valores.size()) {
+        cout << "Erro: valores inseridos nao encontrados!" << endl;
+    }
+    return chrono::duration<double, milli>(fim - inicio).count();
+}
+
 /**
  * @brief Função principal para executar os passos do exercício.
  */
@@ -277,6 +2903,382 @@ int main() {
            (n) 17  40
     */
     
+    cout << "\n------------------------------------------" << endl;
+    cout << "c) Entrada ordenada (arvore degenerada em lista)" << endl;
+    cout << "------------------------------------------" << endl;
+
+    // Com as operações iterativas, a árvore degenerada não estoura a pilha.
+    {
+        const int N = 20000;
+        ArvoreBinariaBusca degenerada;
+        for (int i = 0; i < N; i++) {
+            degenerada.inserir(i);
+        }
+        for (int i = 0; i < N; i += 2) {
+            degenerada.remover(i);
+        }
+        int encontrados = 0;
+        for (int i = 0; i < N; i++) {
+            encontrados += degenerada.contem(i);
+        }
+        cout << "Inseridos " << N << " valores em ordem, removidos os pares."
+             << " Restantes: " << encontrados << " (Esperado: " << N / 2 << ")" << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "d) Variante balanceada (Treap)" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        ArvoreBalanceada balanceada;
+        for (int i = 0; i < n; i++) {
+            balanceada.inserir(valores[i]);
+        }
+        balanceada.remover(9);
+        balanceada.remover(5);
+        balanceada.remover(20);
+        cout << "Mesmas operacoes de a) e b) na Treap:" << endl;
+        balanceada.listarEmOrdem(); // Mesmo resultado da BST comum
+
+        // Comparativo: a BST comum degenera com entrada ordenada (O(n^2)),
+        // a Treap mantém O(n log n) nos dois casos.
+        const int N = 20000;
+        vector<int> ordenados(N), aleatorios(N);
+        for (int i = 0; i < N; i++) {
+            ordenados[i] = aleatorios[i] = i;
+        }
+        shuffle(aleatorios.begin(), aleatorios.end(), mt19937(42));
+
+        cout << "\nComparativo (" << N << " insercoes + " << N << " consultas, em ms):" << endl;
+        cout << "  BST comum, entrada ordenada:  "
+             << medirInsercoesEConsultas<ArvoreBinariaBusca>(ordenados) << endl;
+        cout << "  BST comum, entrada aleatoria: "
+             << medirInsercoesEConsultas<ArvoreBinariaBusca>(aleatorios) << endl;
+        cout << "  Treap,     entrada ordenada:  "
+             << medirInsercoesEConsultas<ArvoreBalanceada>(ordenados) << endl;
+        cout << "  Treap,     entrada aleatoria: "
+             << medirInsercoesEConsultas<ArvoreBalanceada>(aleatorios) << endl;
+
+        ArvoreBalanceada grande;
+        for (int i = 0; i < 1000000; i++) {
+            grande.inserir(i);
+        }
+        cout << "Treap com 1000000 valores em ordem: altura " << grande.altura() << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "e) Instantaneo congelado (Eytzinger / van Emde Boas)" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        const ArvoreCongelada& congelada = arvore.congelar();
+        cout << "Valores em [10, 40]: ";
+        congelada.visitarIntervalo(10, 40, [](int v) { cout << v << " "; });
+        cout << "(" << congelada.contarIntervalo(10, 40) << " valores)" << endl;
+
+        // Comparativo de consultas: ponteiros x layouts implícitos.
+        const int N = 1000000;
+        vector<int> chaves(N);
+        mt19937 gerador(7);
+        for (int i = 0; i < N; i++) {
+            chaves[i] = (int)(gerador() % (4 * N));
+        }
+        ArvoreBinariaBusca grande;
+        for (int v : chaves) {
+            grande.inserir(v);
+        }
+        const ArvoreCongelada& grandeCongelada = grande.congelar();
+
+        auto medir = [&](auto consulta) {
+            auto inicio = chrono::steady_clock::now();
+            long long encontrados = 0;
+            for (int i = 0; i < N; i++) {
+                encontrados += consulta(chaves[(i * 7919LL) % N] + (i & 1));
+            }
+            auto fim = chrono::steady_clock::now();
+            cout << chrono::duration<double, milli>(fim - inicio).count()
+                 << " ms (" << encontrados << " encontrados)" << endl;
+        };
+        cout << "\n" << N << " consultas sobre " << grandeCongelada.tamanho() << " valores:" << endl;
+        cout << "  Ponteiros (contem):  ";
+        medir([&](int x) { return grande.contem(x); });
+        cout << "  Eytzinger:           ";
+        medir([&](int x) { return grandeCongelada.contem(x); });
+        cout << "  van Emde Boas:       ";
+        medir([&](int x) { return grandeCongelada.contemVEB(x); });
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "f) Construcao em lote (arvore balanceada em O(n))" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        ArvoreBinariaBusca lote;
+        lote.construirEmLote(valores, n);
+        cout << "Mesma sequencia de a), construida em lote:" << endl;
+        lote.listarEmOrdem();
+        lote.listarPreOrdem();
+
+        const int N = 5000000;
+        vector<int> chaves(N);
+        mt19937 gerador(3);
+        for (int i = 0; i < N; i++) {
+            chaves[i] = (int)(gerador() % N);
+        }
+        auto inicio = chrono::steady_clock::now();
+        ArvoreBinariaBusca grande;
+        grande.construirEmLote(chaves);
+        auto fim = chrono::steady_clock::now();
+        cout << "construirEmLote com " << N << " chaves: "
+             << chrono::duration<double, milli>(fim - inicio).count() << " ms, altura "
+             << grande.altura() << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "g) Iteradores e consultas de intervalo" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        cout << "Em-Ordem via iterador:   ";
+        for (int v : arvore) {
+            cout << v << " ";
+        }
+        cout << "\nPre-Ordem via iterador:  ";
+        for (int v : arvore.preOrdem()) {
+            cout << v << " ";
+        }
+        cout << "\nDo maior para o menor:   ";
+        for (auto it = arvore.end(); it != arvore.begin();) {
+            --it;
+            cout << *it << " ";
+        }
+        cout << "\nIntervalo [10, 40]:      ";
+        arvore.visitarIntervalo(10, 40, [](int v) { cout << v << " "; });
+        cout << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "h) Variante concorrente (varias threads)" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        const int FAIXA = 100000;
+        const int POR_THREAD = 200000;
+        unsigned nucleos = thread::hardware_concurrency();
+        cout << "Nucleos disponiveis: " << nucleos << endl;
+        cout << "Vazao em milhoes de ops/s (leituras% / threads):" << endl;
+        int misturas[] = {90, 50};
+        int quantidades[] = {1, 2, 4, 8};
+        for (int leitura : misturas) {
+            for (int threads : quantidades) {
+                ArvoreConcorrente concorrente;
+                ArvoreComTravaGlobal comTrava;
+                mt19937 gerador(1);
+                for (int i = 0; i < FAIXA / 2; i++) {
+                    int v = (int)(gerador() % FAIXA);
+                    concorrente.inserir(v);
+                    comTrava.inserir(v);
+                }
+                double vConc = medirVazao(concorrente, threads, POR_THREAD, leitura, FAIXA);
+                double vTrava = medirVazao(comTrava, threads, POR_THREAD, leitura, FAIXA);
+                cout << "  " << leitura << "% leituras, " << threads << " threads: concorrente "
+                     << vConc << " | trava global " << vTrava << endl;
+            }
+        }
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "i) Versoes persistentes (instantaneos O(1))" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        ArvorePersistente persistente;
+        for (int i = 0; i < n; i++) {
+            persistente.inserir(valores[i]);
+        }
+        VersaoPersistente antes = persistente.instantaneo();
+        long long nosAntes = NoPersistente::vivos.load();
+
+        persistente.remover(9);
+        persistente.remover(5);
+        persistente.remover(20);
+        VersaoPersistente depois = persistente.instantaneo();
+
+        cout << "Versao antes das remocoes:  ";
+        antes.listarEmOrdem();
+        cout << "Versao depois das remocoes: ";
+        depois.listarEmOrdem();
+        cout << "Nos antes: " << nosAntes << ", com as duas versoes vivas: "
+             << NoPersistente::vivos.load() << " (so os caminhos alterados foram copiados)" << endl;
+
+        // Um leitor percorre uma versão antiga enquanto a árvore muda.
+        const int N = 200000;
+        for (int i = 0; i < N; i++) {
+            persistente.inserir((int)((i * 2654435761u) % 1000000));
+        }
+        VersaoPersistente relatorio = persistente.instantaneo();
+        long long somaLeitor = 0;
+        thread leitor([&relatorio, &somaLeitor] {
+            relatorio.visitarEmOrdem([&somaLeitor](int v) { somaLeitor += v; });
+        });
+        for (int i = 0; i < N; i++) {
+            persistente.remover((int)((i * 2654435761u) % 1000000));
+        }
+        leitor.join();
+        long long somaConferencia = 0;
+        relatorio.visitarEmOrdem([&somaConferencia](int v) { somaConferencia += v; });
+        cout << "Leitor concorrente viu a versao intacta: "
+             << (somaLeitor == somaConferencia ? "sim" : "NAO") << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "j) Operacoes de conjunto (dividir/juntar, em paralelo)" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        ArvoreBalanceada a, b;
+        for (int v = 0; v < 20; v += 2) a.inserir(v);  // pares
+        for (int v = 0; v < 20; v += 3) b.inserir(v);  // múltiplos de 3
+        cout << "A: "; a.listarEmOrdem();
+        cout << "B: "; b.listarEmOrdem();
+        ArvoreBalanceada c, d;
+        for (int v = 0; v < 20; v += 2) c.inserir(v);
+        for (int v = 0; v < 20; v += 3) d.inserir(v);
+        ArvoreBalanceada e, f;
+        for (int v = 0; v < 20; v += 2) e.inserir(v);
+        for (int v = 0; v < 20; v += 3) f.inserir(v);
+        a.unir(b);
+        c.intersectar(d);
+        e.subtrair(f);
+        cout << "A uniao B:      "; a.listarEmOrdem();
+        cout << "A intersecao B: "; c.listarEmOrdem();
+        cout << "A - B:          "; e.listarEmOrdem();
+        // Duas árvores grandes: a união por dividir/juntar contra a
+        // reinserção de cada elemento de uma na outra.
+        const int N = 500000;
+        ArvoreBalanceada x1, y1, x2;
+        vector<int> doY;
+        mt19937 gerador(5);
+        for (int i = 0; i < N; i++) {
+            int vx = (int)(gerador() % (4 * N));
+            int vy = (int)(gerador() % (4 * N));
+            x1.inserir(vx);
+            x2.inserir(vx);
+            y1.inserir(vy);
+            doY.push_back(vy);
+        }
+        auto t0 = chrono::steady_clock::now();
+        x1.unir(y1);
+        auto t1 = chrono::steady_clock::now();
+        for (int v : doY) x2.inserir(v);
+        auto t2 = chrono::steady_clock::now();
+        cout << "Uniao de " << N << " + " << N << " chaves: dividir/juntar "
+             << chrono::duration<double, milli>(t1 - t0).count() << " ms | reinserir "
+             << chrono::duration<double, milli>(t2 - t1).count() << " ms (tamanhos "
+             << x1.tamanho() << " e " << x2.tamanho() << ")" << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "k) Nos com indices de 32 bits (array unico)" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        ArvoreIndexada indexada;
+        for (int v : valores) indexada.inserir(v);
+        indexada.remover(9);
+        indexada.remover(5);
+        indexada.remover(20);
+        indexada.listarEmOrdem();
+        indexada.listarPreOrdem();
+
+        // Mesmas inserções/consultas aleatórias nas duas representações.
+        const int N = 1000000;
+        vector<int> aleatorios(N);
+        mt19937 gerador(11);
+        for (int& v : aleatorios) v = (int)(gerador() % (4u * N));
+
+        auto t0 = chrono::steady_clock::now();
+        ArvoreBinariaBusca comPonteiros;
+        for (int v : aleatorios) comPonteiros.inserir(v);
+        auto t1 = chrono::steady_clock::now();
+        ArvoreIndexada comIndices;
+        for (int v : aleatorios) comIndices.inserir(v);
+        auto t2 = chrono::steady_clock::now();
+        long long achados1 = 0, achados2 = 0;
+        for (int v = 0; v < N; v++) achados1 += comPonteiros.contem(v);
+        auto t3 = chrono::steady_clock::now();
+        for (int v = 0; v < N; v++) achados2 += comIndices.contem(v);
+        auto t4 = chrono::steady_clock::now();
+
+        cout << "Nos: " << comIndices.tamanho() << " | bytes por no: ponteiros "
+             << sizeof(No) << ", indices " << sizeof(NoIndexado) << endl;
+        cout << "Memoria dos nos: ponteiros ~" << comIndices.tamanho() * sizeof(No) / (1024 * 1024)
+             << " MB, indices " << comIndices.bytesUsados() / (1024 * 1024) << " MB (capacidade do array)" << endl;
+        cout << "Insercao:  ponteiros " << chrono::duration<double, milli>(t1 - t0).count()
+             << " ms | indices " << chrono::duration<double, milli>(t2 - t1).count() << " ms" << endl;
+        cout << "Consultas: ponteiros " << chrono::duration<double, milli>(t3 - t2).count()
+             << " ms | indices " << chrono::duration<double, milli>(t4 - t3).count() << " ms"
+             << " (achados " << achados1 << " / " << achados2 << ")" << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "l) Gravacao e carga em arquivo binario (e mmap)" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        const int N = 1000000;
+        vector<int> aleatorios(N);
+        mt19937 gerador(13);
+        for (int& v : aleatorios) v = (int)(gerador() % (4u * N));
+        auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+            return chrono::duration<double, milli>(b - a).count();
+        };
+
+        // 1. Árvore de ponteiros: Pré-Ordem com flags dos filhos.
+        ArvoreBinariaBusca original;
+        auto t0 = chrono::steady_clock::now();
+        for (int v : aleatorios) original.inserir(v);
+        auto t1 = chrono::steady_clock::now();
+        original.salvar("arvore_a1.bin");
+        auto t2 = chrono::steady_clock::now();
+        ArvoreBinariaBusca recarregada;
+        recarregada.carregar("arvore_a1.bin");
+        auto t3 = chrono::steady_clock::now();
+        vector<int> a, b;
+        original.coletarEmOrdem(a);
+        recarregada.coletarEmOrdem(b);
+        cout << "Ponteiros: reinserir " << ms(t0, t1) << " ms | salvar " << ms(t1, t2)
+             << " ms | carregar " << ms(t2, t3) << " ms | mesma arvore: "
+             << ((a == b && original.altura() == recarregada.altura()) ? "sim" : "NAO") << endl;
+
+        // 2. Árvore indexada: o array vai para o disco como está.
+        ArvoreIndexada indexada;
+        for (int v : aleatorios) indexada.inserir(v);
+        auto t4 = chrono::steady_clock::now();
+        indexada.salvar("arvore_a1_indexada.bin");
+        auto t5 = chrono::steady_clock::now();
+        ArvoreIndexada copia;
+        copia.carregar("arvore_a1_indexada.bin");
+        auto t6 = chrono::steady_clock::now();
+        cout << "Indices:   salvar " << ms(t4, t5) << " ms | carregar " << ms(t5, t6) << " ms" << endl;
+
+        // 3. Mapeada: sem conferir o checksum a abertura não lê os nós.
+        auto t7 = chrono::steady_clock::now();
+        ArvoreMapeada mapeada("arvore_a1_indexada.bin", false);
+        auto t8 = chrono::steady_clock::now();
+        long long achados = 0;
+        for (int v = 0; v < 1000; v++) achados += mapeada.contem(aleatorios[v]);
+        auto t9 = chrono::steady_clock::now();
+        cout << "mmap:      abrir " << ms(t7, t8) << " ms | 1000 consultas " << ms(t8, t9)
+             << " ms (achados " << achados << " de 1000, " << mapeada.tamanho() << " nos)" << endl;
+
+        // 4. Um byte trocado no conteúdo é detectado pelo checksum.
+        FILE* f = fopen("arvore_a1.bin", "r+b");
+        if (f != nullptr) {
+            fseek(f, sizeof(CabecalhoArquivo) + 100, SEEK_SET);
+            fputc(0x5A, f);
+            fclose(f);
+        }
+        try {
+            recarregada.carregar("arvore_a1.bin");
+        } catch (const exception& e) {
+            cout << "Arquivo corrompido: " << e.what() << endl;
+        }
+        remove("arvore_a1.bin");
+        remove("arvore_a1_indexada.bin");
+    }
+
     cout << "\n------------------------------------------" << endl;
     cout << "Execucao finalizada." << endl;
     cout << "------------------------------------------" << endl;
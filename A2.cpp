@@ -47,6 +47,32 @@ private:
         return no;
     }
 
+    /**
+     * @brief Função recursiva privada para procurar um valor.
+     */
+    bool contemRecursivo(No* no, int valor) const {
+        if (no == nullptr) {
+            return false;
+        }
+        if (valor == no->dados) {
+            return true;
+        }
+        return (valor < no->dados) ? contemRecursivo(no->esquerda, valor)
+                                   : contemRecursivo(no->direita, valor);
+    }
+
+    /**
+     * @brief Função recursiva privada para calcular a altura (0 se vazia).
+     */
+    int alturaRecursivo(No* no) const {
+        if (no == nullptr) {
+            return 0;
+        }
+        int esq = alturaRecursivo(no->esquerda);
+        int dir = alturaRecursivo(no->direita);
+        return 1 + (esq > dir ? esq : dir);
+    }
+
     /**
      * @brief Função recursiva privada para deletar todos os nós (limpeza).
      */
@@ -73,6 +99,14 @@ public:
     }
 
 
+    bool contem(int valor) const {
+        return contemRecursivo(raiz, valor);
+    }
+
+    int altura() const {
+        return alturaRecursivo(raiz);
+    }
+
     int encontrarMaiorValor() {
         // Trata o caso da árvore estar vazia
         if (raiz == nullptr) {
@@ -1,9 +1,22 @@
 #include <iostream>
 #include <string>
 #include <vector> 
+#include <random> // Para gerar pessoas no comparativo
+#include <chrono> // Para medir o comparativo
 
 using namespace std;
 
+struct NoArvore;
+
+// --- Elos de um nó dentro de um índice por categoria ---
+// Cada categoria (ex.: sexo 'M') tem a sua própria árvore por nome, só
+// com os nós daquela categoria, e uma lista encadeada em ordem de nome.
+struct ElosCategoria {
+    NoArvore* esquerda = nullptr; // Árvore da categoria
+    NoArvore* direita = nullptr;
+    NoArvore* proximo = nullptr;  // Próximo nome da mesma categoria
+};
+
 // --- Estrutura do Nó (conforme solicitado) ---
 struct NoArvore {
     // Dados do nó
@@ -16,44 +29,135 @@ struct NoArvore {
     NoArvore* esquerda;
     NoArvore* direita;
 
+    // Elos do índice por sexo
+    ElosCategoria elosSexo;
+
     // Construtor para facilitar a criação
     NoArvore(string n, char s, int i, double p)
         : nome(n), sexo(s), idade(i), peso(p), esquerda(nullptr), direita(nullptr) {}
 };
 
+// --- Visão somente-leitura de uma categoria (sem cópia) ---
+
 /**
- * @brief Classe que implementa a Árvore Binária de Busca (BST).
+ * @brief Percorre, em ordem de nome, os nós de uma categoria seguindo os
+ * elos 'proximo': obter a visão é O(1) e percorrê-la é O(k), sem alocar
+ * nem copiar nós.
  */
-class ArvoreBinariaBusca {
+class VisaoCategoria {
 private:
-    NoArvore* raiz; // Este é o ponteiro 'RAIZ' que o enunciado menciona
+    const NoArvore* primeiro;
+    size_t quantidade;
+    ElosCategoria NoArvore::*elos;
 
-    void _gerarListasRecursivo(NoArvore* no,
-                                vector<NoArvore*>& homens,
-                                vector<NoArvore*>& mulheres) {
-        
-        // Caso Base: Se o nó é nulo, não faz nada e retorna.
-        if (no == nullptr) {
-            return;
+public:
+    class Iterador {
+    private:
+        const NoArvore* no;
+        ElosCategoria NoArvore::*elos;
+
+    public:
+        Iterador(const NoArvore* n, ElosCategoria NoArvore::*e) : no(n), elos(e) {}
+        const NoArvore& operator*() const { return *no; }
+        const NoArvore* operator->() const { return no; }
+        Iterador& operator++() {
+            no = (no->*elos).proximo;
+            return *this;
+        }
+        bool operator!=(const Iterador& outro) const { return no != outro.no; }
+    };
+
+    VisaoCategoria(const NoArvore* p, size_t q, ElosCategoria NoArvore::*e)
+        : primeiro(p), quantidade(q), elos(e) {}
+
+    Iterador begin() const { return Iterador(primeiro, elos); }
+    Iterador end() const { return Iterador(nullptr, elos); }
+    size_t tamanho() const { return quantidade; }
+    bool vazia() const { return quantidade == 0; }
+};
+
+/**
+ * @brief Índice por um campo de poucas categorias (sexo, estado civil...).
+ *
+ * 'campo' é o membro do nó que define a categoria e 'elos' o membro
+ * ElosCategoria reservado para este índice. Cada categoria guarda a raiz
+ * da sua árvore por nome e o primeiro da sua lista. Ao inserir, a descida
+ * pela árvore da categoria encontra o vizinho anterior e o próximo dentro
+ * dela, e o nó é encaixado na lista entre os dois: O(altura), sem
+ * percorrer a árvore principal.
+ */
+template <typename Campo, Campo NoArvore::*campo, ElosCategoria NoArvore::*elos>
+class IndicePorCategoria {
+private:
+    struct Categoria {
+        Campo valor;
+        NoArvore* raiz;
+        NoArvore* primeiro;
+        size_t quantidade;
+    };
+
+    vector<Categoria> categorias; // Poucas: busca linear
+
+    const Categoria* encontrar(const Campo& valor) const {
+        for (const Categoria& c : categorias) {
+            if (c.valor == valor) return &c;
+        }
+        return nullptr;
+    }
+
+public:
+    void inserir(NoArvore* novo) {
+        Categoria* categoria = nullptr;
+        for (Categoria& c : categorias) {
+            if (c.valor == novo->*campo) categoria = &c;
         }
+        if (categoria == nullptr) {
+            categorias.push_back(Categoria{novo->*campo, nullptr, nullptr, 0});
+            categoria = &categorias.back();
+        }
+        Categoria& c = *categoria;
 
-        // 1. Passo Recursivo: Visita a sub-árvore da ESQUERDA
-        _gerarListasRecursivo(no->esquerda, homens, mulheres);
+        // Mesmo critério da árvore principal: nomes iguais vão à direita.
+        NoArvore* anterior = nullptr;
+        NoArvore** elo = &c.raiz;
+        while (*elo != nullptr) {
+            NoArvore* no = *elo;
+            if (novo->nome < no->nome) {
+                elo = &(no->*elos).esquerda;
+            } else {
+                anterior = no;
+                elo = &(no->*elos).direita;
+            }
+        }
+        *elo = novo;
 
-        // 2. Processa o nó "RAIZ" (o nó atual)
-        // Adiciona o nó à lista correta.
-        // Como estamos em-ordem, ele será adicionado na posição correta.
-        if (no->sexo == 'M') {
-            homens.push_back(no);
-        } else if (no->sexo == 'F') {
-            mulheres.push_back(no);
+        ElosCategoria& e = novo->*elos;
+        if (anterior == nullptr) {
+            e.proximo = c.primeiro;
+            c.primeiro = novo;
+        } else {
+            e.proximo = (anterior->*elos).proximo;
+            (anterior->*elos).proximo = novo;
         }
-        // Nota: Nós com sexo != 'M' ou 'F' seriam ignorados.
+        c.quantidade++;
+    }
 
-        // 3. Passo Recursivo: Visita a sub-árvore da DIREITA
-        _gerarListasRecursivo(no->direita, homens, mulheres);
+    VisaoCategoria visao(const Campo& valor) const {
+        const Categoria* c = encontrar(valor);
+        if (c == nullptr) return VisaoCategoria(nullptr, 0, elos);
+        return VisaoCategoria(c->primeiro, c->quantidade, elos);
     }
+};
 
+/**
+ * @brief Classe que implementa a Árvore Binária de Busca (BST).
+ */
+class ArvoreBinariaBusca {
+private:
+    NoArvore* raiz; // Este é o ponteiro 'RAIZ' que o enunciado menciona
+
+    // Listas por sexo, mantidas a cada inserção
+    IndicePorCategoria<char, &NoArvore::sexo, &NoArvore::elosSexo> porSexo;
 
     // --- Funções auxiliares para o exemplo funcionar ---
 
@@ -95,6 +199,15 @@ public:
     void inserir(string nome, char sexo, int idade, double peso) {
         NoArvore* novoNo = new NoArvore(nome, sexo, idade, peso);
         raiz = _inserirRecursivo(raiz, novoNo);
+        porSexo.inserir(novoNo);
+    }
+
+    /**
+     * @brief Pessoas de um sexo, em ordem de nome, sem percorrer a árvore
+     * nem copiar: for (const NoArvore& p : bst.listarPorSexo('F')).
+     */
+    VisaoCategoria listarPorSexo(char sexo) const {
+        return porSexo.visao(sexo);
     }
 
     
@@ -105,8 +218,14 @@ public:
         listaHomens.clear();
         listaMulheres.clear();
 
-        // Chama a função recursiva privada, começando pela raiz
-        _gerarListasRecursivo(raiz, listaHomens, listaMulheres);
+        // As listas já estão prontas no índice: basta copiar os ponteiros,
+        // O(k) por sexo, sem visitar os nós de outros sexos.
+        VisaoCategoria homens = porSexo.visao('M');
+        VisaoCategoria mulheres = porSexo.visao('F');
+        listaHomens.reserve(homens.tamanho());
+        listaMulheres.reserve(mulheres.tamanho());
+        for (const NoArvore& no : homens) listaHomens.push_back(const_cast<NoArvore*>(&no));
+        for (const NoArvore& no : mulheres) listaMulheres.push_back(const_cast<NoArvore*>(&no));
     }
 };
 
@@ -153,5 +272,36 @@ int main() {
     cout<<"A"<<endl;
     imprimirLista("Lista de Mulheres (Ordenada por NOME)", listaMulheres);
 
+    // Visão direta do índice: nada é copiado nem percorrido além das k
+    // pessoas do sexo pedido.
+    cout << "--- Mulheres (visao do indice, sem copia) ---" << endl;
+    for (const NoArvore& p : bst.listarPorSexo('F')) {
+        cout << "  " << p.nome << endl;
+    }
+
+    // Comparativo com muitas pessoas: copiar as listas x percorrer a visão.
+    ArvoreBinariaBusca grande;
+    mt19937 gerador(7);
+    const int N = 200000;
+    for (int i = 0; i < N; i++) {
+        string nome = "P" + to_string(gerador() % 10000000);
+        grande.inserir(nome, (gerador() % 2) ? 'M' : 'F', 20 + (int)(gerador() % 60), 70.0);
+    }
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < 10; r++) {
+        grande.gerarListasPorSexo(listaHomens, listaMulheres);
+    }
+    auto t1 = chrono::steady_clock::now();
+    size_t somaIdades = 0;
+    for (int r = 0; r < 10; r++) {
+        for (const NoArvore& p : grande.listarPorSexo('F')) somaIdades += p.idade;
+    }
+    auto t2 = chrono::steady_clock::now();
+    cout << "\n" << N << " pessoas, 10 repeticoes: gerarListasPorSexo "
+         << chrono::duration<double, milli>(t1 - t0).count() << " ms | percorrer a visao 'F' "
+         << chrono::duration<double, milli>(t2 - t1).count() << " ms ("
+         << grande.listarPorSexo('F').tamanho() << " mulheres, soma das idades " << somaIdades << ")"
+         << endl;
+
     return 0;
 }
\ No newline at end of file
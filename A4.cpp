@@ -1,5 +1,18 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm> // Para std::shuffle, std::sort e std::max
+#include <new>         // Para ::operator new / placement new
+#include <type_traits> // Para std::is_trivially_destructible
+#include <thread>      // Para a ordenação paralela da construção em lote
+#include <random> // Para sortear as prioridades da Treap
+#include <chrono> // Para o comparativo de desempenho
+#include <climits>   // Para INT_MIN
+#include <cmath>     // Para ceil (percentis)
+#include <stdexcept> // Para as exceções de select/percentil
+#include <cstdint>   // Para uint32_t (variante indexada)
+#include <cstdio>    // Para FILE* (gravação e carga em arquivo)
+#include <cstring>   // Para memcpy / memcmp
 
 // Usar 'using namespace std;' é comum em exercícios acadêmicos para simplificar.
 using namespace std;
@@ -8,6 +21,7 @@ using namespace std;
 struct No {
     int valor;
     int contador; // <-- MODIFICAÇÃO: Contador de ocorrências
+    long long soma; // Soma dos contadores da sub-árvore (estatísticas de ordem)
     No *esquerda;
     No *direita;
 
@@ -15,20 +29,378 @@ struct No {
     No(int v) {
         valor = v;
         contador = 1; // <-- MODIFICAÇÃO: Inicia o contador em 1
+        soma = 1;
         esquerda = nullptr;
         direita = nullptr;
     }
 };
 
 
+// -----------------------------------------------------------------
+// ALOCADOR DE NÓS (Arena / Slab com lista livre intrusiva)
+// -----------------------------------------------------------------
+
+/**
+ * @brief Pool de nós alocados em blocos (slabs) contíguos.
+ *
+ * Em vez de um 'new' por nó, os nós são retirados sequencialmente de
+ * blocos grandes, de modo que nós inseridos em sequência ficam vizinhos
+ * na memória (compartilham linhas de cache). Nós liberados entram numa
+ * lista livre intrusiva (o próprio espaço do nó guarda o ponteiro para o
+ * próximo livre) e são reaproveitados nas próximas alocações.
+ * A destruição libera bloco a bloco: O(#blocos), e não O(#nós).
+ */
+template <typename T>
+class PoolDeNos {
+private:
+    static const size_t NOS_POR_BLOCO = 4096;
+
+    // Um nó livre reaproveita o próprio armazenamento como elo da lista.
+    struct Livre {
+        Livre* proximo;
+    };
+
+    static_assert(sizeof(T) >= sizeof(Livre), "No pequeno demais para a lista livre");
+    static_assert(is_trivially_destructible<T>::value,
+                  "PoolDeNos libera blocos inteiros sem chamar destrutores");
+
+    vector<T*> blocos; // Todos os blocos alocados
+    T* cursor;         // Próxima posição nunca usada do bloco atual
+    T* fimBloco;       // Fim do bloco atual
+    Livre* livres;     // Topo da lista livre
+
+    void novoBloco() {
+        T* bloco = static_cast<T*>(::operator new(sizeof(T) * NOS_POR_BLOCO));
+        blocos.push_back(bloco);
+        cursor = bloco;
+        fimBloco = bloco + NOS_POR_BLOCO;
+    }
+
+public:
+    PoolDeNos() : cursor(nullptr), fimBloco(nullptr), livres(nullptr) {}
+
+    // O pool é dono dos blocos: não pode ser copiado.
+    PoolDeNos(const PoolDeNos&) = delete;
+    PoolDeNos& operator=(const PoolDeNos&) = delete;
+
+    ~PoolDeNos() {
+        liberarTudo();
+    }
+
+    /**
+     * @brief Constrói um nó, reaproveitando um espaço livre se houver.
+     */
+    template <typename... Args>
+    T* alocar(Args&&... args) {
+        void* espaco;
+        if (livres != nullptr) {
+            espaco = livres;
+            livres = livres->proximo;
+        } else {
+            if (cursor == fimBloco) {
+                novoBloco();
+            }
+            espaco = cursor++;
+        }
+        return new (espaco) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Devolve um nó ao pool (entra no topo da lista livre).
+     */
+    void liberar(T* no) {
+        Livre* livre = reinterpret_cast<Livre*>(no);
+        livre->proximo = livres;
+        livres = livre;
+    }
+
+    /**
+     * @brief Reserva um bloco próprio com 'quantidade' posições contíguas
+     * (ainda não construídas), usado pela construção em lote.
+     */
+    T* reservarContiguos(size_t quantidade) {
+        T* bloco = static_cast<T*>(::operator new(sizeof(T) * quantidade));
+        blocos.push_back(bloco);
+        return bloco;
+    }
+
+    /**
+     * @brief Libera todos os blocos de uma vez, em O(#blocos).
+     */
+    void liberarTudo() {
+        for (T* bloco : blocos) {
+            ::operator delete(bloco);
+        }
+        blocos.clear();
+        cursor = fimBloco = nullptr;
+        livres = nullptr;
+    }
+};
+
+// -----------------------------------------------------------------
+// ORDENAÇÃO PARALELA (usada pela construção em lote)
+// -----------------------------------------------------------------
+
+/**
+ * @brief Ordena 'v' dividindo-o em uma fatia por núcleo: cada thread
+ * ordena a sua fatia e depois as fatias são mescladas aos pares, também
+ * em paralelo. Para vetores pequenos usa só std::sort.
+ */
+void ordenarEmParalelo(vector<int>& v) {
+    unsigned nucleos = thread::hardware_concurrency();
+    if (nucleos < 2 || v.size() < (1u << 16)) {
+        sort(v.begin(), v.end());
+        return;
+    }
+    // Número de fatias em potência de 2, para as mesclas aos pares.
+    unsigned partes = 1;
+    while (partes * 2 <= nucleos) {
+        partes *= 2;
+    }
+    vector<size_t> limites(partes + 1);
+    for (unsigned i = 0; i <= partes; i++) {
+        limites[i] = v.size() * i / partes;
+    }
+
+    vector<thread> threads;
+    for (unsigned i = 0; i < partes; i++) {
+        threads.emplace_back([&v, &limites, i] {
+            sort(v.begin() + limites[i], v.begin() + limites[i + 1]);
+        });
+    }
+    for (thread& t : threads) t.join();
+
+    for (unsigned largura = 1; largura < partes; largura *= 2) {
+        threads.clear();
+        for (unsigned i = 0; i < partes; i += 2 * largura) {
+            threads.emplace_back([&v, &limites, i, largura] {
+                inplace_merge(v.begin() + limites[i],
+                              v.begin() + limites[i + largura],
+                              v.begin() + limites[i + 2 * largura]);
+            });
+        }
+        for (thread& t : threads) t.join();
+    }
+}
+
+// -----------------------------------------------------------------
+// ARQUIVO BINÁRIO (cabeçalho, escrita em fluxo e leitura conferida)
+// -----------------------------------------------------------------
+
+// Formatos do conteúdo que segue o cabeçalho.
+const uint32_t VERSAO_ARQUIVO = 2; // 2: o checksum cobre também o cabeçalho
+const uint32_t FORMATO_PRE_ORDEM = 1;        // Registros dos nós em Pré-Ordem
+const uint32_t FORMATO_ARRAY_INDEXADO = 2;   // Array de NoIndexado tal como está na memória
+
+/**
+ * @brief Cabeçalho de tamanho fixo no início de todo arquivo de árvore.
+ * Os inteiros são gravados na ordem de bytes da máquina (o arquivo não é
+ * portável entre arquiteturas de endianness diferente).
+ */
+struct CabecalhoArquivo {
+    char magica[4];        // "ABB1"
+    uint32_t versao;
+    uint32_t formato;
+    uint32_t raiz;         // Só no formato de array: índice da raiz
+    uint32_t livres;       // Só no formato de array: topo da lista livre
+    uint32_t reservado;
+    uint64_t registros;    // Nós na Pré-Ordem ou posições do array
+    uint64_t vivos;        // Nós vivos (valores distintos)
+    uint64_t ocorrencias;  // Soma dos contadores (= vivos sem contador)
+    uint64_t checksum;     // FNV-1a de 64 bits do conteúdo e do cabeçalho
+};
+
+static_assert(sizeof(CabecalhoArquivo) == 56, "Cabecalho com preenchimento inesperado");
+
+const uint64_t FNV_BASE = 14695981039346656037ull;
+const uint64_t FNV_PRIMO = 1099511628211ull;
+
+uint64_t fnv1a(uint64_t h, const void* dados, size_t n) {
+    const unsigned char* p = static_cast<const unsigned char*>(dados);
+    for (size_t i = 0; i < n; i++) {
+        h = (h ^ p[i]) * FNV_PRIMO;
+    }
+    return h;
+}
+
+/**
+ * @brief Checksum final do arquivo: continua o FNV-1a do conteúdo sobre o
+ * cabeçalho com o campo checksum zerado. Assim raiz, lista livre e
+ * contagens também são protegidos, e não só os registros.
+ */
+uint64_t checksumDoArquivo(uint64_t checksumDoConteudo, CabecalhoArquivo cabecalho) {
+    cabecalho.checksum = 0;
+    return fnv1a(checksumDoConteudo, &cabecalho, sizeof(cabecalho));
+}
+
+/**
+ * @brief Grava um arquivo de árvore em fluxo: os registros passam por um
+ * buffer fixo de 64 KB, e o cabeçalho (com o checksum, só conhecido no
+ * final) é reescrito no início em finalizar(). Não guarda cópia do conteúdo.
+ */
+class EscritorBinario {
+private:
+    FILE* arquivo;
+    vector<char> buffer;
+    size_t usados;
+    uint64_t checksum;
+
+    void descarregar() {
+        if (usados > 0 && fwrite(buffer.data(), 1, usados, arquivo) != usados) {
+            throw runtime_error("Erro: falha ao gravar o arquivo.");
+        }
+        usados = 0;
+    }
+
+public:
+    explicit EscritorBinario(const string& caminho)
+        : buffer(1 << 16), usados(0), checksum(FNV_BASE) {
+        arquivo = fopen(caminho.c_str(), "wb");
+        if (arquivo == nullptr) {
+            throw runtime_error("Erro: nao foi possivel criar " + caminho);
+        }
+        CabecalhoArquivo vazio = {};
+        if (fwrite(&vazio, sizeof(vazio), 1, arquivo) != 1) {
+            fclose(arquivo);
+            throw runtime_error("Erro: falha ao gravar o arquivo.");
+        }
+    }
+
+    ~EscritorBinario() {
+        if (arquivo != nullptr) fclose(arquivo);
+    }
+
+    EscritorBinario(const EscritorBinario&) = delete;
+    EscritorBinario& operator=(const EscritorBinario&) = delete;
+
+    void escrever(const void* dados, size_t n) {
+        checksum = fnv1a(checksum, dados, n);
+        const char* p = static_cast<const char*>(dados);
+        while (n > 0) {
+            if (usados == buffer.size()) descarregar();
+            size_t parte = min(n, buffer.size() - usados);
+            memcpy(buffer.data() + usados, p, parte);
+            usados += parte;
+            p += parte;
+            n -= parte;
+        }
+    }
+
+    /**
+     * @brief Completa o cabeçalho (mágica, versão, checksum), grava-o no
+     * início do arquivo e fecha.
+     */
+    void finalizar(CabecalhoArquivo cabecalho) {
+        descarregar();
+        memcpy(cabecalho.magica, "ABB1", 4);
+        cabecalho.versao = VERSAO_ARQUIVO;
+        cabecalho.checksum = checksumDoArquivo(checksum, cabecalho);
+        bool ok = fseek(arquivo, 0, SEEK_SET) == 0 &&
+                  fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1;
+        ok = (fclose(arquivo) == 0) && ok;
+        arquivo = nullptr;
+        if (!ok) {
+            throw runtime_error("Erro: falha ao gravar o arquivo.");
+        }
+    }
+};
+
+/**
+ * @brief Confere um cabeçalho lido: mágica, versão, formato esperado e se
+ * o tamanho do conteúdo bate com registros * bytesPorRegistro.
+ */
+void validarCabecalho(const CabecalhoArquivo& c, uint32_t formato, uint64_t bytesDoConteudo,
+                      size_t bytesPorRegistro) {
+    if (memcmp(c.magica, "ABB1", 4) != 0) {
+        throw runtime_error("Erro: o arquivo nao contem uma arvore.");
+    }
+    if (c.versao != VERSAO_ARQUIVO) {
+        throw runtime_error("Erro: versao de arquivo nao suportada.");
+    }
+    if (c.formato != formato) {
+        throw runtime_error("Erro: formato de arquivo inesperado.");
+    }
+    if (c.registros > bytesDoConteudo / bytesPorRegistro ||
+        c.registros * bytesPorRegistro != bytesDoConteudo) {
+        throw runtime_error("Erro: arquivo truncado ou corrompido.");
+    }
+}
+
+/**
+ * @brief Lê um arquivo de árvore em fluxo, com buffer do FILE*, somando o
+ * checksum do que passa; conferirFim() compara com o do cabeçalho.
+ */
+class LeitorBinario {
+private:
+    FILE* arquivo;
+    uint64_t checksum;
+
+public:
+    CabecalhoArquivo cabecalho;
+
+    LeitorBinario(const string& caminho, uint32_t formato, size_t bytesPorRegistro)
+        : checksum(FNV_BASE) {
+        arquivo = fopen(caminho.c_str(), "rb");
+        if (arquivo == nullptr) {
+            throw runtime_error("Erro: nao foi possivel abrir " + caminho);
+        }
+        long tamanho = -1;
+        if (fseek(arquivo, 0, SEEK_END) == 0) tamanho = ftell(arquivo);
+        if (tamanho < (long)sizeof(cabecalho) || fseek(arquivo, 0, SEEK_SET) != 0 ||
+            fread(&cabecalho, sizeof(cabecalho), 1, arquivo) != 1) {
+            fclose(arquivo);
+            throw runtime_error("Erro: arquivo truncado ou corrompido.");
+        }
+        try {
+            validarCabecalho(cabecalho, formato, (uint64_t)tamanho - sizeof(cabecalho),
+                             bytesPorRegistro);
+        } catch (...) {
+            fclose(arquivo);
+            throw;
+        }
+    }
+
+    ~LeitorBinario() {
+        fclose(arquivo);
+    }
+
+    LeitorBinario(const LeitorBinario&) = delete;
+    LeitorBinario& operator=(const LeitorBinario&) = delete;
+
+    void ler(void* destino, size_t n) {
+        if (fread(destino, 1, n, arquivo) != n) {
+            throw runtime_error("Erro: arquivo truncado ou corrompido.");
+        }
+        checksum = fnv1a(checksum, destino, n);
+    }
+
+    void conferirFim() const {
+        if (checksumDoArquivo(checksum, cabecalho) != cabecalho.checksum) {
+            throw runtime_error("Erro: checksum do arquivo nao confere.");
+        }
+    }
+};
+
 class ArvoreBinariaBusca {
 private:
     No* raiz; // Ponteiro para o nó raiz da árvore
+    PoolDeNos<No> pool; // Todos os nós da árvore vêm deste pool
+
+    // Soma dos contadores de uma sub-árvore (0 se vazia)
+    static long long getSoma(const No* no) {
+        return (no == nullptr) ? 0 : no->soma;
+    }
+
+    // Recalcula 'soma' a partir dos filhos; chamada na volta da recursão
+    // de toda função que altera a sub-árvore.
+    static void atualizarSoma(No* no) {
+        no->soma = no->contador + getSoma(no->esquerda) + getSoma(no->direita);
+    }
 
     No* inserirRec(No* no, int valor) {
         // 1. Caso base: Se o nó é nulo, encontramos o local para inserir.
         if (no == nullptr) {
-            return new No(valor); // O construtor já define contador = 1
+            return pool.alocar(valor); // O construtor já define contador = 1
         }
 
         // 2. Caso recursivo: Decide se vai para a esquerda ou direita.
@@ -42,6 +414,7 @@ private:
             no->contador++;
         }
 
+        atualizarSoma(no);
         // Retorna o nó (inalterado ou com o novo filho)
         return no;
     }
@@ -81,11 +454,12 @@ private:
         // Caso base: encontramos o menor (não tem filho esquerdo)
         if (no->esquerda == nullptr) {
             No* temp = no->direita; // O substituto dele (pode ser nullptr)
-            delete no; // Deleta o nó mínimo
+            pool.liberar(no); // Devolve o nó mínimo ao pool
             return temp; // Retorna o substituto
         }
         // Caso recursivo: continua descendo pela esquerda
         no->esquerda = removerMinimo(no->esquerda);
+        atualizarSoma(no);
         return no;
     }
 
@@ -107,6 +481,7 @@ private:
             // Se o contador for maior que 1, apenas o decrementamos.
             if (no->contador > 1) {
                 no->contador--;
+                no->soma--;
                 return no; // Retorna o nó sem excluí-lo
             }
             // Se o contador for 1, procedemos com a remoção física do nó.
@@ -115,13 +490,13 @@ private:
             // CASO 1: Nó com 0 ou 1 filho (à direita)
             if (no->esquerda == nullptr) {
                 No* temp = no->direita;
-                delete no; // Libera a memória
+                pool.liberar(no); // Devolve o nó ao pool
                 return temp; 
             }
             // CASO 2: Nó com 1 filho (à esquerda)
             else if (no->direita == nullptr) {
                 No* temp = no->esquerda;
-                delete no; // Libera a memória
+                pool.liberar(no); // Devolve o nó ao pool
                 return temp; 
             }
 
@@ -138,25 +513,57 @@ private:
             // física, e não apenas decrementar o contador do sucessor.
             no->direita = removerMinimo(no->direita);
         }
+        atualizarSoma(no);
         return no;
     }
 
-    void deletarArvore(No* no) {
-        if (no == nullptr) return;
-        deletarArvore(no->esquerda);
-        deletarArvore(no->direita);
-        delete no;
+    // Todos os nós vivem no pool: basta liberar os blocos inteiros.
+    void deletarArvore() {
+        pool.liberarTudo();
+        raiz = nullptr;
     }
 
+    int alturaRec(No* no) {
+        if (no == nullptr) return 0;
+        return 1 + max(alturaRec(no->esquerda), alturaRec(no->direita));
+    }
+
+    /**
+     * @brief Constrói a sub-árvore perfeitamente balanceada com os valores
+     * ordenados em [inicio, fim): o do meio vira a raiz e as metades viram
+     * as sub-árvores. Cada nó é construído na posição do seu rank dentro
+     * do bloco contíguo 'nos', numa única passada O(n).
+     */
+    No* ligarBalanceado(No* nos, const vector<int>& ordenadas, const vector<int>& contadores,
+                        size_t inicio, size_t fim) {
+        if (inicio >= fim) {
+            return nullptr;
+        }
+        size_t meio = inicio + (fim - inicio) / 2;
+        No* no = new (&nos[meio]) No(ordenadas[meio]);
+        no->contador = contadores[meio];
+        no->esquerda = ligarBalanceado(nos, ordenadas, contadores, inicio, meio);
+        no->direita = ligarBalanceado(nos, ordenadas, contadores, meio + 1, fim);
+        atualizarSoma(no);
+        return no;
+    }
+
+    // --- Registro de um nó no arquivo: valor, contador, flags dos filhos ---
+    static const size_t BYTES_POR_REGISTRO = sizeof(int32_t) + sizeof(int32_t) + sizeof(uint8_t);
+
 public:
     // Construtor: Inicializa a árvore com a raiz nula.
     ArvoreBinariaBusca() : raiz(nullptr) {}
 
     // Destrutor: Limpa toda a memória alocada.
     ~ArvoreBinariaBusca() {
-        deletarArvore(raiz);
+        deletarArvore();
     }
 
+    // A árvore é dona do pool de nós: não pode ser copiada.
+    ArvoreBinariaBusca(const ArvoreBinariaBusca&) = delete;
+    ArvoreBinariaBusca& operator=(const ArvoreBinariaBusca&) = delete;
+
     // --- INTERFACE PÚBLICA (Sem alterações nas assinaturas) ---
 
     void inserir(int valor) {
@@ -180,6 +587,1066 @@ public:
     void remover(int valor) {
         raiz = removerRec(raiz, valor);
     }
+
+    /**
+     * @brief Substitui o conteúdo da árvore pelos 'n' valores de 'chaves'
+     * (em qualquer ordem), construindo diretamente uma árvore perfeitamente
+     * balanceada, em vez de chamar inserir() para cada valor.
+     * Custo: a ordenação (paralela) + O(n) para montar a árvore, com todos
+     * os nós num único bloco contíguo do pool.
+     */
+    void construirEmLote(const int* chaves, size_t n) {
+        // 1. Ordena uma cópia dos valores (em paralelo se for grande)
+        vector<int> ordenadas(chaves, chaves + n);
+        ordenarEmParalelo(ordenadas);
+
+        // 2. Colapsa repetições em contadores: cada valor distinto vira
+        //    um nó, com 'contador' = número de ocorrências.
+        vector<int> contadores;
+        size_t distintos = 0;
+        for (size_t i = 0; i < ordenadas.size(); i++) {
+            if (distintos > 0 && ordenadas[distintos - 1] == ordenadas[i]) {
+                contadores[distintos - 1]++;
+            } else {
+                ordenadas[distintos++] = ordenadas[i];
+                contadores.push_back(1);
+            }
+        }
+        ordenadas.resize(distintos);
+
+        // 3. Descarta a árvore atual e monta a nova no mesmo pool
+        deletarArvore();
+        if (!ordenadas.empty()) {
+            No* nos = pool.reservarContiguos(ordenadas.size());
+            raiz = ligarBalanceado(nos, ordenadas, contadores, 0, ordenadas.size());
+        }
+    }
+
+    void construirEmLote(const vector<int>& chaves) {
+        construirEmLote(chaves.data(), chaves.size());
+    }
+
+    // Número de ocorrências de 'valor' (0 se ausente).
+    int contar(int valor) const {
+        const No* no = raiz;
+        while (no != nullptr) {
+            if (valor < no->valor) {
+                no = no->esquerda;
+            } else if (valor > no->valor) {
+                no = no->direita;
+            } else {
+                return no->contador;
+            }
+        }
+        return 0;
+    }
+
+    // Altura da árvore (0 se vazia).
+    int altura() {
+        return alturaRec(raiz);
+    }
+
+    // -----------------------------------------------------------------
+    // ESTATÍSTICAS DE ORDEM (O(h) usando 'soma' de cada sub-árvore; com
+    // amostras quase ordenadas h ~ n: use a ArvoreBalanceada)
+    // -----------------------------------------------------------------
+
+    // Total de ocorrências na árvore (soma de todos os contadores).
+    long long total() const {
+        return getSoma(raiz);
+    }
+
+    /**
+     * @brief rank: quantas ocorrências são <= x.
+     */
+    long long rank(int x) const {
+        long long acumulado = 0;
+        const No* no = raiz;
+        while (no != nullptr) {
+            if (x < no->valor) {
+                no = no->esquerda;
+            } else {
+                // O nó e toda a sua sub-árvore esquerda são <= x.
+                acumulado += getSoma(no->esquerda) + no->contador;
+                if (x == no->valor) break;
+                no = no->direita;
+            }
+        }
+        return acumulado;
+    }
+
+    /**
+     * @brief select: o k-ésimo menor valor, contando repetições (k a partir de 0).
+     */
+    int select(long long k) const {
+        if (k < 0 || k >= total()) {
+            throw out_of_range("Erro: posicao fora da arvore.");
+        }
+        const No* no = raiz;
+        while (true) {
+            long long aEsquerda = getSoma(no->esquerda);
+            if (k < aEsquerda) {
+                no = no->esquerda;
+            } else if (k < aEsquerda + no->contador) {
+                return no->valor;
+            } else {
+                k -= aEsquerda + no->contador;
+                no = no->direita;
+            }
+        }
+    }
+
+    /**
+     * @brief Quantas ocorrências estão em [lo, hi].
+     */
+    long long contarIntervalo(int lo, int hi) const {
+        if (lo > hi) return 0;
+        long long abaixoDeLo = (lo == INT_MIN) ? 0 : rank(lo - 1);
+        return rank(hi) - abaixoDeLo;
+    }
+
+    /**
+     * @brief Percentil p (0 a 100) pelo método do rank mais próximo:
+     * o menor valor com pelo menos p% das ocorrências <= ele.
+     */
+    int percentil(double p) const {
+        long long n = total();
+        if (n == 0) {
+            throw runtime_error("Erro: A árvore está vazia.");
+        }
+        long long k = (long long)ceil(p / 100.0 * n) - 1;
+        if (k < 0) k = 0;
+        if (k >= n) k = n - 1;
+        return select(k);
+    }
+
+    // -----------------------------------------------------------------
+    // GRAVAÇÃO E CARGA EM ARQUIVO BINÁRIO
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Grava a árvore em 'caminho': um registro por nó, em Pré-Ordem,
+     * com valor, contador e um byte de flags dizendo quais filhos existem.
+     * Iterativa: a árvore não é balanceada e pode ser uma corrente.
+     */
+    void salvar(const string& caminho) const {
+        EscritorBinario escritor(caminho);
+        uint64_t registros = 0;
+        vector<const No*> pilha;
+        if (raiz != nullptr) pilha.push_back(raiz);
+        while (!pilha.empty()) {
+            const No* no = pilha.back();
+            pilha.pop_back();
+            int32_t campos[2] = {no->valor, no->contador};
+            uint8_t flags = (no->esquerda ? 1 : 0) | (no->direita ? 2 : 0);
+            escritor.escrever(campos, sizeof(campos));
+            escritor.escrever(&flags, sizeof(flags));
+            registros++;
+            if (no->direita) pilha.push_back(no->direita);
+            if (no->esquerda) pilha.push_back(no->esquerda);
+        }
+        CabecalhoArquivo cabecalho = {};
+        cabecalho.formato = FORMATO_PRE_ORDEM;
+        cabecalho.raiz = cabecalho.livres = UINT32_MAX;
+        cabecalho.registros = cabecalho.vivos = registros;
+        cabecalho.ocorrencias = (uint64_t)total();
+        escritor.finalizar(cabecalho);
+    }
+
+    /**
+     * @brief Substitui o conteúdo pelo da árvore gravada em 'caminho', em
+     * O(n) e sem comparar valores: a Pré-Ordem com as flags já determina a
+     * forma. Cada registro ocupa o próximo elo pendente (filhos esquerdos
+     * antes dos direitos), sem recursão: um arquivo corrompido que descreva
+     * uma corrente longa não estoura a pilha. Na Pré-Ordem os descendentes
+     * vêm depois do nó, então as somas são recalculadas de trás para frente.
+     * Lança runtime_error (e deixa a árvore vazia) se o arquivo for inválido.
+     */
+    void carregar(const string& caminho) {
+        deletarArvore();
+        try {
+            LeitorBinario leitor(caminho, FORMATO_PRE_ORDEM, BYTES_POR_REGISTRO);
+            uint64_t n = leitor.cabecalho.registros;
+            if (n > 0) {
+                No* nos = pool.reservarContiguos(n);
+                vector<No**> pendentes; // Elos ainda sem nó, o próximo no topo
+                pendentes.push_back(&raiz);
+                for (uint64_t i = 0; i < n; i++) {
+                    int32_t campos[2];
+                    uint8_t flags;
+                    leitor.ler(campos, sizeof(campos));
+                    leitor.ler(&flags, sizeof(flags));
+                    // Cada elo pendente precisa de um dos registros que faltam.
+                    if (pendentes.empty() || pendentes.size() > n - i || campos[1] < 1) {
+                        throw runtime_error("Erro: arquivo truncado ou corrompido.");
+                    }
+                    No* no = new (&nos[i]) No(campos[0]);
+                    no->contador = campos[1];
+                    *pendentes.back() = no;
+                    pendentes.pop_back();
+                    if (flags & 2) pendentes.push_back(&no->direita);
+                    if (flags & 1) pendentes.push_back(&no->esquerda);
+                }
+                if (!pendentes.empty()) {
+                    throw runtime_error("Erro: arquivo truncado ou corrompido.");
+                }
+                for (uint64_t i = n; i > 0; i--) atualizarSoma(&nos[i - 1]);
+            }
+            leitor.conferirFim();
+        } catch (...) {
+            deletarArvore();
+            throw;
+        }
+    }
+};
+
+// -----------------------------------------------------------------
+// VARIANTE COMPACTA (nós num único array, ligados por índices de 32 bits)
+// -----------------------------------------------------------------
+
+// Índice que faz o papel de nullptr.
+const uint32_t SEM_NO = UINT32_MAX;
+
+/**
+ * @brief Nó da árvore indexada com contador: 16 bytes, contra 32 do No
+ * com ponteiros. Não guarda a 'soma' da sub-árvore, então rank/select
+ * continuam só na ArvoreBinariaBusca.
+ */
+struct NoIndexado {
+    int valor;
+    int contador;
+    uint32_t esquerda;
+    uint32_t direita;
+};
+
+static_assert(sizeof(NoIndexado) == 16, "NoIndexado deveria ocupar 16 bytes");
+
+/**
+ * @brief Árvore com contador de ocorrências cujos nós vivem num único
+ * vector<NoIndexado>, ligados por índices em vez de ponteiros.
+ *
+ * O array pode ser realocado, copiado ou gravado em disco sem ajustar
+ * nenhum elo. Nós removidos entram numa lista livre encadeada pelo campo
+ * 'esquerda'.
+ */
+class ArvoreIndexada {
+private:
+    vector<NoIndexado> nos; // Armazenamento de todos os nós (vivos e livres)
+    uint32_t raiz;          // Índice da raiz (SEM_NO se vazia)
+    uint32_t livres;        // Topo da lista livre
+    size_t distintos;       // Nós vivos
+    long long ocorrencias;  // Soma de todos os contadores
+
+    uint32_t novoNo(int valor) {
+        uint32_t i;
+        if (livres != SEM_NO) {
+            i = livres;
+            livres = nos[i].esquerda;
+        } else {
+            if (nos.size() >= SEM_NO) {
+                throw runtime_error("Erro: limite de nos da ArvoreIndexada atingido.");
+            }
+            i = (uint32_t)nos.size();
+            nos.push_back(NoIndexado());
+        }
+        nos[i].valor = valor;
+        nos[i].contador = 1;
+        nos[i].esquerda = SEM_NO;
+        nos[i].direita = SEM_NO;
+        distintos++;
+        return i;
+    }
+
+    void liberarNo(uint32_t i) {
+        nos[i].esquerda = livres;
+        livres = i;
+        distintos--;
+    }
+
+    void listarEmOrdemRec(uint32_t i) const {
+        if (i != SEM_NO) {
+            listarEmOrdemRec(nos[i].esquerda);
+            cout << nos[i].valor << " (" << nos[i].contador << "x) ";
+            listarEmOrdemRec(nos[i].direita);
+        }
+    }
+
+    void listarPreOrdemRec(uint32_t i) const {
+        if (i != SEM_NO) {
+            cout << nos[i].valor << " (" << nos[i].contador << "x) ";
+            listarPreOrdemRec(nos[i].esquerda);
+            listarPreOrdemRec(nos[i].direita);
+        }
+    }
+
+    int alturaRec(uint32_t i) const {
+        if (i == SEM_NO) return 0;
+        return 1 + max(alturaRec(nos[i].esquerda), alturaRec(nos[i].direita));
+    }
+
+    // O nó de rank 'meio' fica na posição 'meio' do array.
+    uint32_t ligarBalanceado(const vector<int>& ordenadas, const vector<int>& contadores,
+                             size_t inicio, size_t fim) {
+        if (inicio >= fim) {
+            return SEM_NO;
+        }
+        size_t meio = inicio + (fim - inicio) / 2;
+        nos[meio].valor = ordenadas[meio];
+        nos[meio].contador = contadores[meio];
+        nos[meio].esquerda = ligarBalanceado(ordenadas, contadores, inicio, meio);
+        nos[meio].direita = ligarBalanceado(ordenadas, contadores, meio + 1, fim);
+        return (uint32_t)meio;
+    }
+
+public:
+    ArvoreIndexada() : raiz(SEM_NO), livres(SEM_NO), distintos(0), ocorrencias(0) {}
+
+    // Cópia e movimentação padrão: copiar a árvore é copiar o array.
+
+    void reservar(size_t n) {
+        nos.reserve(n);
+    }
+
+    /**
+     * @brief Insere uma ocorrência. Sem 'soma' para atualizar na volta,
+     * a descida é iterativa; guarda pai e lado porque novoNo() pode
+     * realocar o array.
+     */
+    void inserir(int valor) {
+        ocorrencias++;
+        uint32_t pai = SEM_NO;
+        bool aEsquerda = false;
+        uint32_t atual = raiz;
+        while (atual != SEM_NO) {
+            NoIndexado& no = nos[atual];
+            if (valor < no.valor) {
+                pai = atual;
+                aEsquerda = true;
+                atual = no.esquerda;
+            } else if (valor > no.valor) {
+                pai = atual;
+                aEsquerda = false;
+                atual = no.direita;
+            } else {
+                no.contador++;
+                return;
+            }
+        }
+        uint32_t novo = novoNo(valor);
+        if (pai == SEM_NO) {
+            raiz = novo;
+        } else if (aEsquerda) {
+            nos[pai].esquerda = novo;
+        } else {
+            nos[pai].direita = novo;
+        }
+    }
+
+    /**
+     * @brief Remove uma ocorrência; o nó só sai da árvore quando o
+     * contador chega a zero (o sucessor empresta valor e contador).
+     */
+    void remover(int valor) {
+        uint32_t* elo = &raiz;
+        while (*elo != SEM_NO && nos[*elo].valor != valor) {
+            NoIndexado& no = nos[*elo];
+            elo = (valor < no.valor) ? &no.esquerda : &no.direita;
+        }
+        uint32_t i = *elo;
+        if (i == SEM_NO) {
+            return;
+        }
+        ocorrencias--;
+        NoIndexado& no = nos[i];
+        if (no.contador > 1) {
+            no.contador--;
+            return;
+        }
+        if (no.esquerda == SEM_NO) {
+            *elo = no.direita;
+            liberarNo(i);
+            return;
+        }
+        if (no.direita == SEM_NO) {
+            *elo = no.esquerda;
+            liberarNo(i);
+            return;
+        }
+        uint32_t* eloSucessor = &no.direita;
+        while (nos[*eloSucessor].esquerda != SEM_NO) {
+            eloSucessor = &nos[*eloSucessor].esquerda;
+        }
+        uint32_t sucessor = *eloSucessor;
+        no.valor = nos[sucessor].valor;
+        no.contador = nos[sucessor].contador;
+        *eloSucessor = nos[sucessor].direita;
+        liberarNo(sucessor);
+    }
+
+    // Número de ocorrências de 'valor' (0 se ausente).
+    int contar(int valor) const {
+        uint32_t atual = raiz;
+        while (atual != SEM_NO) {
+            const NoIndexado& no = nos[atual];
+            if (valor < no.valor) {
+                atual = no.esquerda;
+            } else if (valor > no.valor) {
+                atual = no.direita;
+            } else {
+                return no.contador;
+            }
+        }
+        return 0;
+    }
+
+    void listarEmOrdem() const {
+        cout << "[Em-Ordem]:   ";
+        if (raiz == SEM_NO) cout << "(Arvore Vazia)";
+        listarEmOrdemRec(raiz);
+        cout << endl;
+    }
+
+    void listarPreOrdem() const {
+        cout << "[Pre-Ordem]:  ";
+        if (raiz == SEM_NO) cout << "(Arvore Vazia)";
+        listarPreOrdemRec(raiz);
+        cout << endl;
+    }
+
+    /**
+     * @brief Mesma construção em lote da ArvoreBinariaBusca: repetições
+     * viram contadores e a árvore balanceada é montada direto no array.
+     */
+    void construirEmLote(const int* chaves, size_t n) {
+        vector<int> ordenadas(chaves, chaves + n);
+        ordenarEmParalelo(ordenadas);
+        vector<int> contadores;
+        size_t k = 0;
+        for (size_t i = 0; i < ordenadas.size(); i++) {
+            if (k > 0 && ordenadas[k - 1] == ordenadas[i]) {
+                contadores[k - 1]++;
+            } else {
+                ordenadas[k++] = ordenadas[i];
+                contadores.push_back(1);
+            }
+        }
+        ordenadas.resize(k);
+        if (k >= SEM_NO) {
+            throw runtime_error("Erro: limite de nos da ArvoreIndexada atingido.");
+        }
+        nos.assign(k, NoIndexado());
+        livres = SEM_NO;
+        distintos = k;
+        ocorrencias = (long long)n;
+        raiz = ligarBalanceado(ordenadas, contadores, 0, k);
+    }
+
+    void construirEmLote(const vector<int>& chaves) {
+        construirEmLote(chaves.data(), chaves.size());
+    }
+
+    int altura() const {
+        return alturaRec(raiz);
+    }
+
+    // Total de ocorrências (soma de todos os contadores).
+    long long total() const {
+        return ocorrencias;
+    }
+
+    // Número de valores distintos (nós vivos).
+    size_t tamanho() const {
+        return distintos;
+    }
+
+    // Bytes reservados para o array de nós (inclui folga e nós livres).
+    size_t bytesUsados() const {
+        return nos.capacity() * sizeof(NoIndexado);
+    }
+
+    // --- Acesso ao armazenamento bruto (cópia, gravação em disco) ---
+
+    const NoIndexado* dados() const {
+        return nos.data();
+    }
+
+    size_t totalDeNos() const {
+        return nos.size();
+    }
+
+    uint32_t indiceRaiz() const {
+        return raiz;
+    }
+
+    // -----------------------------------------------------------------
+    // GRAVAÇÃO E CARGA EM ARQUIVO BINÁRIO
+    // -----------------------------------------------------------------
+
+    /**
+     * @brief Grava o array de nós tal como está (inclusive posições livres):
+     * como os elos são índices, não há nada a traduzir.
+     */
+    void salvar(const string& caminho) const {
+        EscritorBinario escritor(caminho);
+        escritor.escrever(nos.data(), nos.size() * sizeof(NoIndexado));
+        CabecalhoArquivo cabecalho = {};
+        cabecalho.formato = FORMATO_ARRAY_INDEXADO;
+        cabecalho.raiz = raiz;
+        cabecalho.livres = livres;
+        cabecalho.registros = nos.size();
+        cabecalho.vivos = distintos;
+        cabecalho.ocorrencias = (uint64_t)ocorrencias;
+        escritor.finalizar(cabecalho);
+    }
+
+    /**
+     * @brief Lê o array gravado por salvar() de uma vez, confere checksum e
+     * estrutura, e passa a usá-lo como armazenamento.
+     */
+    void carregar(const string& caminho) {
+        LeitorBinario leitor(caminho, FORMATO_ARRAY_INDEXADO, sizeof(NoIndexado));
+        const CabecalhoArquivo& c = leitor.cabecalho;
+        vector<NoIndexado> lidos(c.registros);
+        leitor.ler(lidos.data(), lidos.size() * sizeof(NoIndexado));
+        leitor.conferirFim();
+        if (!estruturaValida(lidos, c)) {
+            throw runtime_error("Erro: arquivo truncado ou corrompido.");
+        }
+        nos.swap(lidos);
+        raiz = c.raiz;
+        livres = c.livres;
+        distintos = c.vivos;
+        ocorrencias = (long long)c.ocorrencias;
+    }
+
+    /**
+     * @brief Confere o array lido antes de confiar nele: todo elo aponta
+     * para dentro do array, os nós alcançados pela raiz e os da lista livre
+     * não se repetem nem se cruzam e, juntos, ocupam todas as posições; a
+     * árvore tem 'vivos' nós, e os contadores (todos >= 1) somam
+     * 'ocorrencias'. Sem recursão.
+     */
+    static bool estruturaValida(const vector<NoIndexado>& v, const CabecalhoArquivo& c) {
+        size_t n = v.size();
+        vector<char> visto(n, 0);
+        auto marcar = [&visto, n](uint32_t i) {
+            if (i >= n || visto[i]) return false;
+            visto[i] = 1;
+            return true;
+        };
+        uint64_t naArvore = 0, naLista = 0, soma = 0;
+        vector<uint32_t> pilha;
+        if (c.raiz != SEM_NO) {
+            if (!marcar(c.raiz)) return false;
+            pilha.push_back(c.raiz);
+        }
+        while (!pilha.empty()) {
+            const NoIndexado& no = v[pilha.back()];
+            pilha.pop_back();
+            if (no.contador < 1) return false;
+            naArvore++;
+            soma += (uint64_t)no.contador;
+            for (uint32_t filho : {no.esquerda, no.direita}) {
+                if (filho == SEM_NO) continue;
+                if (!marcar(filho)) return false;
+                pilha.push_back(filho);
+            }
+        }
+        for (uint32_t i = c.livres; i != SEM_NO; i = v[i].esquerda) {
+            if (!marcar(i)) return false;
+            naLista++;
+        }
+        return naArvore == c.vivos && soma == c.ocorrencias && naArvore + naLista == n;
+    }
+};
+
+// -----------------------------------------------------------------
+// EXECUÇÃO PARALELA (divisão e conquista das operações de conjunto)
+// -----------------------------------------------------------------
+
+/**
+ * @brief Quantos níveis da recursão ainda abrem uma thread nova. Com
+ * 2^d >= núcleos, os d primeiros níveis já ocupam todos os núcleos e,
+ * abaixo deles, cada thread continua em sequência.
+ */
+int niveisParalelos() {
+    static const int niveis = [] {
+        unsigned nucleos = thread::hardware_concurrency();
+        int d = 0;
+        while ((1u << d) < nucleos) d++;
+        return d;
+    }();
+    return niveis;
+}
+
+/**
+ * @brief Executa as duas tarefas independentes: em paralelo (a primeira
+ * numa thread nova) nos níveis rasos da recursão, em sequência abaixo.
+ */
+template <typename Tarefa1, typename Tarefa2>
+void executarEmParalelo(int nivel, Tarefa1 tarefa1, Tarefa2 tarefa2) {
+    if (nivel < niveisParalelos()) {
+        thread t(tarefa1);
+        tarefa2();
+        t.join();
+    } else {
+        tarefa1();
+        tarefa2();
+    }
+}
+
+// -----------------------------------------------------------------
+// VARIANTE BALANCEADA (Treap com contador)
+// -----------------------------------------------------------------
+
+struct NoTreap {
+    int valor;
+    int contador; // Contador de ocorrências, como em No
+    unsigned prioridade; // Prioridade aleatória (heap de máximo)
+    long long soma; // Soma dos contadores da sub-árvore, como em No
+    NoTreap *esquerda;
+    NoTreap *direita;
+
+    NoTreap(int v, unsigned p) {
+        valor = v;
+        contador = 1;
+        prioridade = p;
+        soma = 1;
+        esquerda = nullptr;
+        direita = nullptr;
+    }
+};
+
+/**
+ * @brief Treap com a mesma interface e a mesma semântica de contador
+ * de ArvoreBinariaBusca: inserir um valor repetido incrementa o
+ * contador, e remover só retira o nó quando o contador chega a zero.
+ * A altura esperada é O(log n) independentemente da ordem de entrada,
+ * então rank/select/percentil (mesmas da ArvoreBinariaBusca, com 'soma'
+ * mantida em rotações, divisões e junções) custam O(log n) esperado
+ * mesmo com amostras quase ordenadas.
+ */
+class ArvoreBalanceada {
+private:
+    NoTreap* raiz;
+    unsigned long long semente; // Estado do gerador xorshift das prioridades
+
+    unsigned sortearPrioridade() {
+        semente ^= semente << 13;
+        semente ^= semente >> 7;
+        semente ^= semente << 17;
+        return (unsigned)(semente >> 32);
+    }
+
+    // Soma dos contadores de uma sub-árvore (0 se vazia)
+    static long long getSoma(const NoTreap* no) {
+        return (no == nullptr) ? 0 : no->soma;
+    }
+
+    // Recalcula 'soma' a partir dos filhos (já atualizados).
+    static void atualizarSoma(NoTreap* no) {
+        no->soma = no->contador + getSoma(no->esquerda) + getSoma(no->direita);
+    }
+
+    NoTreap* rotacaoDireita(NoTreap* y) {
+        NoTreap* x = y->esquerda;
+        y->esquerda = x->direita;
+        x->direita = y;
+        atualizarSoma(y); // Primeiro o que desceu
+        atualizarSoma(x);
+        return x;
+    }
+
+    NoTreap* rotacaoEsquerda(NoTreap* x) {
+        NoTreap* y = x->direita;
+        x->direita = y->esquerda;
+        y->esquerda = x;
+        atualizarSoma(x);
+        atualizarSoma(y);
+        return y;
+    }
+
+    NoTreap* inserirRec(NoTreap* no, int valor) {
+        if (no == nullptr) {
+            return new NoTreap(valor, sortearPrioridade());
+        }
+
+        if (valor < no->valor) {
+            no->esquerda = inserirRec(no->esquerda, valor);
+            if (no->esquerda->prioridade > no->prioridade) {
+                no = rotacaoDireita(no);
+            }
+        } else if (valor > no->valor) {
+            no->direita = inserirRec(no->direita, valor);
+            if (no->direita->prioridade > no->prioridade) {
+                no = rotacaoEsquerda(no);
+            }
+        } else {
+            // Valor duplicado: apenas incrementa o contador.
+            no->contador++;
+        }
+        atualizarSoma(no);
+        return no;
+    }
+
+    // Retira fisicamente o nó com o valor dado (ignora o contador).
+    NoTreap* retirarNo(NoTreap* no, int valor) {
+        if (no->valor != valor) {
+            if (valor < no->valor) {
+                no->esquerda = retirarNo(no->esquerda, valor);
+            } else {
+                no->direita = retirarNo(no->direita, valor);
+            }
+            atualizarSoma(no);
+            return no;
+        }
+        if (no->esquerda == nullptr || no->direita == nullptr) {
+            NoTreap* temp = no->esquerda ? no->esquerda : no->direita;
+            delete no;
+            return temp;
+        }
+        // Com 2 filhos, o de maior prioridade sobe e o nó desce.
+        if (no->esquerda->prioridade > no->direita->prioridade) {
+            no = rotacaoDireita(no);
+            no->direita = retirarNo(no->direita, valor);
+        } else {
+            no = rotacaoEsquerda(no);
+            no->esquerda = retirarNo(no->esquerda, valor);
+        }
+        atualizarSoma(no);
+        return no;
+    }
+
+    NoTreap* removerRec(NoTreap* no, int valor) {
+        if (no == nullptr) {
+            return no; // Valor não encontrado
+        }
+
+        if (valor < no->valor) {
+            no->esquerda = removerRec(no->esquerda, valor);
+        } else if (valor > no->valor) {
+            no->direita = removerRec(no->direita, valor);
+        } else if (no->contador > 1) {
+            // Se o contador for maior que 1, apenas o decrementamos.
+            no->contador--;
+        } else {
+            return retirarNo(no, valor); // Já volta com as somas certas
+        }
+        atualizarSoma(no);
+        return no;
+    }
+
+    void listarEmOrdemRec(NoTreap* no) {
+        if (no != nullptr) {
+            listarEmOrdemRec(no->esquerda);
+            cout << no->valor << " (" << no->contador << "x) ";
+            listarEmOrdemRec(no->direita);
+        }
+    }
+
+    void listarPreOrdemRec(NoTreap* no) {
+        if (no != nullptr) {
+            cout << no->valor << " (" << no->contador << "x) ";
+            listarPreOrdemRec(no->esquerda);
+            listarPreOrdemRec(no->direita);
+        }
+    }
+
+    // --- Operações de conjunto por divisão/junção ---
+
+    /**
+     * @brief Divide a treap 't' pelo valor k: 'menores' (< k), 'igual'
+     * (o nó com k, desligado, ou nulo) e 'maiores' (> k). O(log n) esperado.
+     */
+    static void dividir(NoTreap* t, int k, NoTreap*& menores, NoTreap*& igual, NoTreap*& maiores) {
+        if (t == nullptr) {
+            menores = igual = maiores = nullptr;
+        } else if (k < t->valor) {
+            dividir(t->esquerda, k, menores, igual, t->esquerda);
+            atualizarSoma(t);
+            maiores = t;
+        } else if (k > t->valor) {
+            dividir(t->direita, k, t->direita, igual, maiores);
+            atualizarSoma(t);
+            menores = t;
+        } else {
+            menores = t->esquerda;
+            maiores = t->direita;
+            t->esquerda = t->direita = nullptr;
+            atualizarSoma(t);
+            igual = t;
+        }
+    }
+
+    /**
+     * @brief Junta duas treaps em que todo valor de 'a' é menor que todo
+     * valor de 'b', respeitando as prioridades. O(log n) esperado.
+     */
+    static NoTreap* juntar(NoTreap* a, NoTreap* b) {
+        if (a == nullptr) return b;
+        if (b == nullptr) return a;
+        if (a->prioridade > b->prioridade) {
+            a->direita = juntar(a->direita, b);
+            atualizarSoma(a);
+            return a;
+        }
+        b->esquerda = juntar(a, b->esquerda);
+        atualizarSoma(b);
+        return b;
+    }
+
+    static long long contarNos(const NoTreap* no) {
+        if (no == nullptr) return 0;
+        return 1 + contarNos(no->esquerda) + contarNos(no->direita);
+    }
+
+    static void liberar(NoTreap* no) {
+        if (no == nullptr) return;
+        liberar(no->esquerda);
+        liberar(no->direita);
+        delete no;
+    }
+
+    /**
+     * @brief União: a raiz de maior prioridade divide a outra treap, e as
+     * duas metades são unidas recursivamente (e em paralelo).
+     * Custo O(m log(n/m + 1)) esperado, com m <= n os tamanhos.
+     */
+    static NoTreap* uniao(NoTreap* a, NoTreap* b, int nivel) {
+        if (a == nullptr) return b;
+        if (b == nullptr) return a;
+        if (a->prioridade < b->prioridade) swap(a, b);
+
+        NoTreap *menores, *igual, *maiores;
+        dividir(b, a->valor, menores, igual, maiores);
+        if (igual != nullptr) {
+            a->contador += igual->contador; // Multiplicidades somadas
+            delete igual;
+        }
+        NoTreap* esquerda = a->esquerda;
+        NoTreap* direita = a->direita;
+        executarEmParalelo(nivel,
+            [&] { esquerda = uniao(esquerda, menores, nivel + 1); },
+            [&] { direita = uniao(direita, maiores, nivel + 1); });
+        a->esquerda = esquerda;
+        a->direita = direita;
+        atualizarSoma(a);
+        return a;
+    }
+
+    static NoTreap* intersecao(NoTreap* a, NoTreap* b, int nivel) {
+        if (a == nullptr || b == nullptr) {
+            liberar(a);
+            liberar(b);
+            return nullptr;
+        }
+        if (a->prioridade < b->prioridade) swap(a, b);
+
+        NoTreap *menores, *igual, *maiores;
+        dividir(b, a->valor, menores, igual, maiores);
+        NoTreap* esquerda = a->esquerda;
+        NoTreap* direita = a->direita;
+        executarEmParalelo(nivel,
+            [&] { esquerda = intersecao(esquerda, menores, nivel + 1); },
+            [&] { direita = intersecao(direita, maiores, nivel + 1); });
+
+        if (igual == nullptr) {
+            // O valor de 'a' não está em 'b': o nó sai.
+            delete a;
+            return juntar(esquerda, direita);
+        }
+        a->contador = min(a->contador, igual->contador); // Menor multiplicidade
+        delete igual;
+        a->esquerda = esquerda;
+        a->direita = direita;
+        atualizarSoma(a);
+        return a;
+    }
+
+    /**
+     * @brief Diferença a - b: divide 'a' pela raiz de 'b' e subtrai as
+     * sub-árvores de 'b' das metades correspondentes (em paralelo).
+     */
+    static NoTreap* diferenca(NoTreap* a, NoTreap* b, int nivel) {
+        if (a == nullptr) {
+            liberar(b);
+            return nullptr;
+        }
+        if (b == nullptr) return a;
+
+        NoTreap *menores, *igual, *maiores;
+        dividir(a, b->valor, menores, igual, maiores);
+        NoTreap* esquerda = nullptr;
+        NoTreap* direita = nullptr;
+        NoTreap* bEsquerda = b->esquerda;
+        NoTreap* bDireita = b->direita;
+        executarEmParalelo(nivel,
+            [&] { esquerda = diferenca(menores, bEsquerda, nivel + 1); },
+            [&] { direita = diferenca(maiores, bDireita, nivel + 1); });
+        NoTreap* meio = nullptr;
+        if (igual != nullptr) {
+            // Multiplicidades subtraídas: sobra só o excedente de 'a'.
+            if (igual->contador > b->contador) {
+                igual->contador -= b->contador;
+                atualizarSoma(igual); // Folha: dividir() a desligou
+                meio = igual;
+            } else {
+                delete igual;
+            }
+        }
+        delete b;
+        return juntar(juntar(esquerda, meio), direita);
+    }
+
+public:
+    ArvoreBalanceada() : raiz(nullptr) {
+        random_device rd;
+        semente = ((unsigned long long)rd() << 32) | rd() | 1;
+    }
+
+    ~ArvoreBalanceada() {
+        liberar(raiz);
+    }
+
+    ArvoreBalanceada(const ArvoreBalanceada&) = delete;
+    ArvoreBalanceada& operator=(const ArvoreBalanceada&) = delete;
+
+    void inserir(int valor) {
+        raiz = inserirRec(raiz, valor);
+    }
+
+    void remover(int valor) {
+        raiz = removerRec(raiz, valor);
+    }
+
+    // Quantas ocorrências do valor existem (0 se ausente).
+    int contar(int valor) const {
+        const NoTreap* atual = raiz;
+        while (atual != nullptr) {
+            if (valor < atual->valor) {
+                atual = atual->esquerda;
+            } else if (valor > atual->valor) {
+                atual = atual->direita;
+            } else {
+                return atual->contador;
+            }
+        }
+        return 0;
+    }
+
+    void listarEmOrdem() {
+        cout << "[Em-Ordem]:   ";
+        if (raiz == nullptr) cout << "(Arvore Vazia)";
+        listarEmOrdemRec(raiz);
+        cout << endl;
+    }
+
+    void listarPreOrdem() {
+        cout << "[Pre-Ordem]:  ";
+        if (raiz == nullptr) cout << "(Arvore Vazia)";
+        listarPreOrdemRec(raiz);
+        cout << endl;
+    }
+
+    // -----------------------------------------------------------------
+    // ESTATÍSTICAS DE ORDEM (O(log n) esperado, mesma semântica da
+    // ArvoreBinariaBusca)
+    // -----------------------------------------------------------------
+
+    // Total de ocorrências na árvore (soma de todos os contadores).
+    long long total() const {
+        return getSoma(raiz);
+    }
+
+    /**
+     * @brief rank: quantas ocorrências são <= x.
+     */
+    long long rank(int x) const {
+        long long acumulado = 0;
+        const NoTreap* no = raiz;
+        while (no != nullptr) {
+            if (x < no->valor) {
+                no = no->esquerda;
+            } else {
+                acumulado += getSoma(no->esquerda) + no->contador;
+                if (x == no->valor) break;
+                no = no->direita;
+            }
+        }
+        return acumulado;
+    }
+
+    /**
+     * @brief select: o k-ésimo menor valor, contando repetições (k a partir de 0).
+     */
+    int select(long long k) const {
+        if (k < 0 || k >= total()) {
+            throw out_of_range("Erro: posicao fora da arvore.");
+        }
+        const NoTreap* no = raiz;
+        while (true) {
+            long long aEsquerda = getSoma(no->esquerda);
+            if (k < aEsquerda) {
+                no = no->esquerda;
+            } else if (k < aEsquerda + no->contador) {
+                return no->valor;
+            } else {
+                k -= aEsquerda + no->contador;
+                no = no->direita;
+            }
+        }
+    }
+
+    /**
+     * @brief Quantas ocorrências estão em [lo, hi].
+     */
+    long long contarIntervalo(int lo, int hi) const {
+        if (lo > hi) return 0;
+        long long abaixoDeLo = (lo == INT_MIN) ? 0 : rank(lo - 1);
+        return rank(hi) - abaixoDeLo;
+    }
+
+    /**
+     * @brief Percentil p (0 a 100) pelo método do rank mais próximo.
+     */
+    int percentil(double p) const {
+        long long n = total();
+        if (n == 0) {
+            throw runtime_error("Erro: A árvore está vazia.");
+        }
+        long long k = (long long)ceil(p / 100.0 * n) - 1;
+        if (k < 0) k = 0;
+        if (k >= n) k = n - 1;
+        return select(k);
+    }
+
+    // -----------------------------------------------------------------
+    // OPERAÇÕES DE CONJUNTO (os nós de 'outra' são reaproveitados ou
+    // liberados: 'outra' sempre termina vazia)
+    // -----------------------------------------------------------------
+
+    // Número de valores distintos (percorre a árvore).
+    long long tamanho() const {
+        return contarNos(raiz);
+    }
+
+    // this = this ∪ outra (contadores somados)
+    void unir(ArvoreBalanceada& outra) {
+        raiz = uniao(raiz, outra.raiz, 0);
+        outra.raiz = nullptr;
+    }
+
+    // this = this ∩ outra (menor contador)
+    void intersectar(ArvoreBalanceada& outra) {
+        raiz = intersecao(raiz, outra.raiz, 0);
+        outra.raiz = nullptr;
+    }
+
+    // this = this - outra (contadores subtraídos)
+    void subtrair(ArvoreBalanceada& outra) {
+        raiz = diferenca(raiz, outra.raiz, 0);
+        outra.raiz = nullptr;
+    }
 };
 
 int main() {
@@ -264,6 +1731,263 @@ int main() {
               15 (1x)
     */
 
+    cout << "\n------------------------------------------" << endl;
+    cout << "c) Variante balanceada (Treap) com contador" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        ArvoreBalanceada balanceada;
+        for (int i = 0; i < n; i++) {
+            balanceada.inserir(valores[i]);
+        }
+        int remocoes[] = {5, 20, 5, 30, 20, 20};
+        for (int v : remocoes) {
+            balanceada.remover(v);
+        }
+        cout << "Mesmas remocoes de b) na Treap:" << endl;
+        balanceada.listarEmOrdem(); // Mesmo resultado da BST comum
+
+        // Comparativo com chaves quase ordenadas e muitas repetições:
+        // cada valor aparece 2 vezes, em ordem crescente.
+        const int N = 20000;
+        vector<int> ordenados, aleatorios;
+        for (int i = 0; i < N; i++) {
+            ordenados.push_back(i / 2);
+        }
+        aleatorios = ordenados;
+        shuffle(aleatorios.begin(), aleatorios.end(), mt19937(42));
+
+        cout << "\nComparativo (" << N << " insercoes, em ms):" << endl;
+        for (int caso = 0; caso < 2; caso++) {
+            const vector<int>& entrada = (caso == 0) ? ordenados : aleatorios;
+            const char* nome = (caso == 0) ? "ordenada: " : "aleatoria:";
+
+            auto t0 = chrono::steady_clock::now();
+            {
+                ArvoreBinariaBusca comum;
+                for (int v : entrada) comum.inserir(v);
+            }
+            auto t1 = chrono::steady_clock::now();
+            {
+                ArvoreBalanceada treap;
+                for (int v : entrada) treap.inserir(v);
+            }
+            auto t2 = chrono::steady_clock::now();
+
+            cout << "  Entrada " << nome
+                 << " BST comum " << chrono::duration<double, milli>(t1 - t0).count()
+                 << " | Treap " << chrono::duration<double, milli>(t2 - t1).count() << endl;
+        }
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "d) Construcao em lote (arvore balanceada em O(n))" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        ArvoreBinariaBusca lote;
+        lote.construirEmLote(valores, n);
+        cout << "Mesma sequencia de a), construida em lote:" << endl;
+        lote.listarEmOrdem();
+        lote.listarPreOrdem();
+
+        const int N = 5000000;
+        vector<int> chaves(N);
+        mt19937 gerador(3);
+        for (int i = 0; i < N; i++) {
+            chaves[i] = (int)(gerador() % (N / 4));
+        }
+        auto inicio = chrono::steady_clock::now();
+        ArvoreBinariaBusca grande;
+        grande.construirEmLote(chaves);
+        auto fim = chrono::steady_clock::now();
+        cout << "construirEmLote com " << N << " chaves: "
+             << chrono::duration<double, milli>(fim - inicio).count() << " ms, altura "
+             << grande.altura() << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "e) Estatisticas de ordem (rank / select / percentis)" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        // Amostras de latência (ms) chegando em fluxo, com repetições.
+        ArvoreBinariaBusca latencias;
+        int amostras[] = {12, 7, 30, 7, 15, 12, 95, 7, 22, 12, 40, 15};
+        for (int v : amostras) {
+            latencias.inserir(v);
+        }
+        latencias.listarEmOrdem();
+        cout << "Total de amostras: " << latencias.total() << endl;
+        cout << "rank(12) (amostras <= 12): " << latencias.rank(12) << endl;
+        cout << "select(0) / select(5): " << latencias.select(0) << " / "
+             << latencias.select(5) << endl;
+        cout << "Amostras em [10, 30]: " << latencias.contarIntervalo(10, 30) << endl;
+        cout << "p50 = " << latencias.percentil(50) << ", p90 = " << latencias.percentil(90)
+             << ", p99 = " << latencias.percentil(99) << endl;
+
+        latencias.remover(95);
+        latencias.remover(7);
+        cout << "Apos remover 95 e um 7: p99 = " << latencias.percentil(99)
+             << ", rank(12) = " << latencias.rank(12) << endl;
+    }
+
+    {
+        // Fluxo quase ordenado (latências que só crescem, com ruído): a BST
+        // comum vira uma corrente e cada consulta custa O(n); na Treap,
+        // as mesmas consultas custam O(log n) esperado.
+        const int N = 20000;
+        mt19937 gerador(9);
+        vector<int> fluxo(N);
+        for (int i = 0; i < N; i++) {
+            fluxo[i] = i + (int)(gerador() % 8);
+        }
+        ArvoreBinariaBusca comum;
+        ArvoreBalanceada treap;
+        for (int v : fluxo) {
+            comum.inserir(v);
+            treap.inserir(v);
+        }
+        long long somaComum = 0, somaTreap = 0;
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 1; i <= N; i++) somaComum += comum.percentil(100.0 * i / N);
+        auto t1 = chrono::steady_clock::now();
+        for (int i = 1; i <= N; i++) somaTreap += treap.percentil(100.0 * i / N);
+        auto t2 = chrono::steady_clock::now();
+        cout << "\n" << N << " percentis sobre " << N << " amostras quase ordenadas (ms):" << endl;
+        cout << "  BST comum " << chrono::duration<double, milli>(t1 - t0).count()
+             << " | Treap " << chrono::duration<double, milli>(t2 - t1).count()
+             << (somaComum == somaTreap ? " (mesmas respostas)" : " (RESPOSTAS DIFERENTES)") << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "f) Operacoes de conjunto (dividir/juntar, em paralelo)" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        ArvoreBalanceada a, b, c, d;
+        int va[] = {1, 2, 2, 3, 5, 5, 5};
+        int vb[] = {2, 3, 3, 5, 7};
+        for (int v : va) { a.inserir(v); c.inserir(v); }
+        for (int v : vb) { b.inserir(v); d.inserir(v); }
+        cout << "A: "; a.listarEmOrdem();
+        cout << "B: "; b.listarEmOrdem();
+        a.unir(b);
+        cout << "A uniao B (contadores somados):      "; a.listarEmOrdem();
+        ArvoreBalanceada copiaB;
+        for (int v : vb) copiaB.inserir(v);
+        c.subtrair(copiaB);
+        cout << "A - B (contadores subtraidos):       "; c.listarEmOrdem();
+        ArvoreBalanceada copiaA;
+        for (int v : va) copiaA.inserir(v);
+        d.intersectar(copiaA);
+        cout << "B intersecao A (menor contador):     "; d.listarEmOrdem();
+        // Duas árvores grandes: a união por dividir/juntar contra a
+        // reinserção de cada elemento de uma na outra.
+        const int N = 500000;
+        ArvoreBalanceada x1, y1, x2;
+        vector<int> doY;
+        mt19937 gerador(5);
+        for (int i = 0; i < N; i++) {
+            int vx = (int)(gerador() % (4 * N));
+            int vy = (int)(gerador() % (4 * N));
+            x1.inserir(vx);
+            x2.inserir(vx);
+            y1.inserir(vy);
+            doY.push_back(vy);
+        }
+        auto t0 = chrono::steady_clock::now();
+        x1.unir(y1);
+        auto t1 = chrono::steady_clock::now();
+        for (int v : doY) x2.inserir(v);
+        auto t2 = chrono::steady_clock::now();
+        cout << "Uniao de " << N << " + " << N << " chaves: dividir/juntar "
+             << chrono::duration<double, milli>(t1 - t0).count() << " ms | reinserir "
+             << chrono::duration<double, milli>(t2 - t1).count() << " ms (tamanhos "
+             << x1.tamanho() << " e " << x2.tamanho() << ")" << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "g) Nos com indices de 32 bits (array unico)" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        ArvoreIndexada indexada;
+        for (int i = 0; i < n; i++) indexada.inserir(valores[i]);
+        indexada.remover(5);
+        indexada.remover(20);
+        indexada.remover(30);
+        indexada.listarEmOrdem();
+        indexada.listarPreOrdem();
+
+        // Mesmas inserções/consultas aleatórias (com repetições) nas duas
+        // representações.
+        const int N = 1000000;
+        vector<int> aleatorios(N);
+        mt19937 gerador(11);
+        for (int& v : aleatorios) v = (int)(gerador() % (N / 2));
+
+        auto t0 = chrono::steady_clock::now();
+        ArvoreBinariaBusca comPonteiros;
+        for (int v : aleatorios) comPonteiros.inserir(v);
+        auto t1 = chrono::steady_clock::now();
+        ArvoreIndexada comIndices;
+        for (int v : aleatorios) comIndices.inserir(v);
+        auto t2 = chrono::steady_clock::now();
+        long long soma1 = 0, soma2 = 0;
+        for (int v = 0; v < N / 2; v++) soma1 += comPonteiros.contar(v);
+        auto t3 = chrono::steady_clock::now();
+        for (int v = 0; v < N / 2; v++) soma2 += comIndices.contar(v);
+        auto t4 = chrono::steady_clock::now();
+
+        cout << "Valores distintos: " << comIndices.tamanho() << " | bytes por no: ponteiros "
+             << sizeof(No) << ", indices " << sizeof(NoIndexado) << endl;
+        cout << "Memoria dos nos: ponteiros ~" << comIndices.tamanho() * sizeof(No) / (1024 * 1024)
+             << " MB, indices " << comIndices.bytesUsados() / (1024 * 1024) << " MB (capacidade do array)" << endl;
+        cout << "Insercao:  ponteiros " << chrono::duration<double, milli>(t1 - t0).count()
+             << " ms | indices " << chrono::duration<double, milli>(t2 - t1).count() << " ms" << endl;
+        cout << "Contagens: ponteiros " << chrono::duration<double, milli>(t3 - t2).count()
+             << " ms | indices " << chrono::duration<double, milli>(t4 - t3).count() << " ms"
+             << " (ocorrencias " << soma1 << " / " << soma2 << ")" << endl;
+    }
+
+    cout << "\n------------------------------------------" << endl;
+    cout << "h) Gravacao e carga em arquivo binario" << endl;
+    cout << "------------------------------------------" << endl;
+    {
+        const int N = 1000000;
+        vector<int> aleatorios(N);
+        mt19937 gerador(13);
+        for (int& v : aleatorios) v = (int)(gerador() % (N / 2));
+        auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+            return chrono::duration<double, milli>(b - a).count();
+        };
+
+        ArvoreBinariaBusca original;
+        auto t0 = chrono::steady_clock::now();
+        for (int v : aleatorios) original.inserir(v);
+        auto t1 = chrono::steady_clock::now();
+        original.salvar("arvore_a4.bin");
+        auto t2 = chrono::steady_clock::now();
+        ArvoreBinariaBusca recarregada;
+        recarregada.carregar("arvore_a4.bin");
+        auto t3 = chrono::steady_clock::now();
+        cout << "Ponteiros: reinserir " << ms(t0, t1) << " ms | salvar " << ms(t1, t2)
+             << " ms | carregar " << ms(t2, t3) << " ms" << endl;
+        cout << "Recarregada: total " << recarregada.total() << ", altura " << recarregada.altura()
+             << ", mediana " << recarregada.percentil(50) << " (original: " << original.total()
+             << ", " << original.altura() << ", " << original.percentil(50) << ")" << endl;
+
+        ArvoreIndexada indexada;
+        for (int v : aleatorios) indexada.inserir(v);
+        auto t4 = chrono::steady_clock::now();
+        indexada.salvar("arvore_a4_indexada.bin");
+        auto t5 = chrono::steady_clock::now();
+        ArvoreIndexada copia;
+        copia.carregar("arvore_a4_indexada.bin");
+        auto t6 = chrono::steady_clock::now();
+        cout << "Indices:   salvar " << ms(t4, t5) << " ms | carregar " << ms(t5, t6)
+             << " ms (total " << copia.total() << ")" << endl;
+
+        remove("arvore_a4.bin");
+        remove("arvore_a4_indexada.bin");
+    }
+
     cout << "\n------------------------------------------" << endl;
     cout << "Execucao finalizada." << endl;
     cout << "------------------------------------------" << endl;
@@ -55,6 +55,19 @@ private:
         return no;
     }
 
+    bool contemRec(No* no, int valor) const {
+        if (no == nullptr) return false;
+        if (valor == no->valor) return true;
+        return (valor < no->valor) ? contemRec(no->esquerda, valor) : contemRec(no->direita, valor);
+    }
+
+    int alturaRec(No* no) const {
+        if (no == nullptr) return 0;
+        int esq = alturaRec(no->esquerda);
+        int dir = alturaRec(no->direita);
+        return 1 + (esq > dir ? esq : dir);
+    }
+
     void deletarArvore(No* no) {
         if (no == nullptr) return;
         deletarArvore(no->esquerda);
@@ -76,6 +89,14 @@ public:
         raiz = inserirRec(raiz, valor);
     }
 
+    bool contem(int valor) const {
+        return contemRec(raiz, valor);
+    }
+
+    int altura() const {
+        return alturaRec(raiz);
+    }
+
     // -----------------------------------------------------------------
     // --- FUNÇÃO PÚBLICA SOLICITADA ---
     // -----------------------------------------------------------------
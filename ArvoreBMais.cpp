@@ -0,0 +1,593 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <climits>   // Para INT_MAX (preenchimento das posições vazias)
+#include <stdexcept> // Para lançar exceções (como em A2)
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h> // Comparações SIMD nas chaves do nó
+#endif
+
+using namespace std;
+
+// -----------------------------------------------------------------
+// ÁRVORE B+ DE INTEIROS (conjunto ou multiconjunto)
+// -----------------------------------------------------------------
+//
+// Cada nó guarda até ORDEM-1 chaves num array contíguo de 256 bytes
+// (4 linhas de cache), em vez de 1 chave por nó como em 'No' de A1.
+// As posições não usadas ficam com INT_MAX, então a busca dentro do nó
+// pode comparar blocos inteiros de 8 (AVX2) ou 4 (SSE2) chaves de uma vez
+// e contar quantas são menores que o valor procurado.
+// Os valores ficam só nas folhas, que são encadeadas: a listagem ordenada
+// é uma leitura sequencial de folha em folha.
+
+const int ORDEM = 64;                 // Capacidade de chaves por nó
+const int MINIMO = ORDEM / 2 - 1;     // Ocupação mínima (exceto a raiz)
+
+struct NoBMais {
+    bool folha;
+    int n; // Número de chaves em uso
+    alignas(32) int chaves[ORDEM];
+
+    NoBMais(bool f) : folha(f), n(0) {
+        for (int i = 0; i < ORDEM; i++) {
+            chaves[i] = INT_MAX;
+        }
+    }
+};
+
+struct FolhaBMais : NoBMais {
+    int contadores[ORDEM];  // Ocorrências de cada chave (como 'contador' em A4)
+    FolhaBMais* proxima;    // Próxima folha na ordem crescente
+
+    FolhaBMais() : NoBMais(true), proxima(nullptr) {}
+};
+
+struct InternoBMais : NoBMais {
+    NoBMais* filhos[ORDEM + 1]; // n chaves separam n+1 filhos
+
+    InternoBMais() : NoBMais(false) {}
+};
+
+// --- Busca dentro do nó (SIMD) ---
+
+/**
+ * @brief Quantas das n primeiras chaves são < x (= posição do lower_bound).
+ * Compara blocos completos: as posições além de n valem INT_MAX e
+ * nunca são menores que x.
+ */
+static inline int contarMenores(const int* chaves, int n, int x) {
+    int c = 0;
+#if defined(__AVX2__)
+    __m256i vx = _mm256_set1_epi32(x);
+    for (int i = 0; i < n; i += 8) {
+        __m256i bloco = _mm256_load_si256((const __m256i*)(chaves + i));
+        __m256i menor = _mm256_cmpgt_epi32(vx, bloco);
+        c += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(menor)));
+    }
+#elif defined(__SSE2__)
+    __m128i vx = _mm_set1_epi32(x);
+    for (int i = 0; i < n; i += 4) {
+        __m128i bloco = _mm_load_si128((const __m128i*)(chaves + i));
+        __m128i menor = _mm_cmplt_epi32(bloco, vx);
+        c += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(menor)));
+    }
+#else
+    for (int i = 0; i < n; i++) {
+        c += (chaves[i] < x);
+    }
+#endif
+    return c;
+}
+
+/**
+ * @brief Quantas das n primeiras chaves são <= x (= filho a seguir num
+ * nó interno). Conta as maiores que x no bloco e desconta do total; o
+ * resultado é limitado a n porque o preenchimento INT_MAX também seria
+ * contado quando x == INT_MAX.
+ */
+static inline int contarMenoresOuIguais(const int* chaves, int n, int x) {
+    int examinadas = 0, maiores = 0;
+#if defined(__AVX2__)
+    __m256i vx = _mm256_set1_epi32(x);
+    for (int i = 0; i < n; i += 8) {
+        __m256i bloco = _mm256_load_si256((const __m256i*)(chaves + i));
+        __m256i maior = _mm256_cmpgt_epi32(bloco, vx);
+        maiores += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(maior)));
+        examinadas += 8;
+    }
+#elif defined(__SSE2__)
+    __m128i vx = _mm_set1_epi32(x);
+    for (int i = 0; i < n; i += 4) {
+        __m128i bloco = _mm_load_si128((const __m128i*)(chaves + i));
+        __m128i maior = _mm_cmpgt_epi32(bloco, vx);
+        maiores += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(maior)));
+        examinadas += 4;
+    }
+#else
+    for (int i = 0; i < n; i++) {
+        maiores += (chaves[i] > x);
+    }
+    examinadas = n;
+#endif
+    int c = examinadas - maiores;
+    return c < n ? c : n;
+}
+
+class ArvoreBMais {
+private:
+    NoBMais* raiz;
+    FolhaBMais* primeiraFolha; // Início do encadeamento das folhas
+    bool multiconjunto;        // true: duplicatas incrementam o contador
+    long long total;           // Soma dos contadores (ocorrências)
+
+    // Resultado de uma divisão de nó: chave separadora e novo irmão direito.
+    struct Divisao {
+        int separador;
+        NoBMais* direito;
+    };
+
+    // --- Inserção ---
+
+    /**
+     * @brief Insere x na sub-árvore; devolve a divisão do nó se ele encheu.
+     */
+    bool inserirRec(NoBMais* no, int x, Divisao& divisao) {
+        if (no->folha) {
+            FolhaBMais* f = static_cast<FolhaBMais*>(no);
+            int i = contarMenores(f->chaves, f->n, x);
+            if (i < f->n && f->chaves[i] == x) {
+                // Valor duplicado: só o multiconjunto conta.
+                if (multiconjunto) {
+                    f->contadores[i]++;
+                    total++;
+                }
+                return false;
+            }
+            for (int j = f->n; j > i; j--) {
+                f->chaves[j] = f->chaves[j - 1];
+                f->contadores[j] = f->contadores[j - 1];
+            }
+            f->chaves[i] = x;
+            f->contadores[i] = 1;
+            f->n++;
+            total++;
+            if (f->n < ORDEM) return false;
+            divisao = dividirFolha(f);
+            return true;
+        }
+
+        InternoBMais* interno = static_cast<InternoBMais*>(no);
+        int i = contarMenoresOuIguais(interno->chaves, interno->n, x);
+        Divisao filha;
+        if (!inserirRec(interno->filhos[i], x, filha)) return false;
+
+        // O filho i se dividiu: a separadora e o novo irmão entram na posição i.
+        for (int j = interno->n; j > i; j--) {
+            interno->chaves[j] = interno->chaves[j - 1];
+            interno->filhos[j + 1] = interno->filhos[j];
+        }
+        interno->chaves[i] = filha.separador;
+        interno->filhos[i + 1] = filha.direito;
+        interno->n++;
+        if (interno->n < ORDEM) return false;
+        divisao = dividirInterno(interno);
+        return true;
+    }
+
+    Divisao dividirFolha(FolhaBMais* f) {
+        FolhaBMais* direita = new FolhaBMais();
+        int meio = f->n / 2;
+        for (int j = meio; j < f->n; j++) {
+            direita->chaves[j - meio] = f->chaves[j];
+            direita->contadores[j - meio] = f->contadores[j];
+            f->chaves[j] = INT_MAX;
+        }
+        direita->n = f->n - meio;
+        f->n = meio;
+        direita->proxima = f->proxima;
+        f->proxima = direita;
+        return Divisao{direita->chaves[0], direita};
+    }
+
+    Divisao dividirInterno(InternoBMais* no) {
+        InternoBMais* direito = new InternoBMais();
+        int meio = no->n / 2;
+        int separador = no->chaves[meio];
+        for (int j = meio + 1; j < no->n; j++) {
+            direito->chaves[j - meio - 1] = no->chaves[j];
+        }
+        for (int j = meio + 1; j <= no->n; j++) {
+            direito->filhos[j - meio - 1] = no->filhos[j];
+        }
+        direito->n = no->n - meio - 1;
+        for (int j = meio; j < no->n; j++) {
+            no->chaves[j] = INT_MAX;
+        }
+        no->n = meio;
+        return Divisao{separador, direito};
+    }
+
+    // --- Remoção ---
+
+    /**
+     * @brief Remove uma ocorrência de x; devolve true se algo foi removido.
+     * Ao voltar, o pai corrige filhos que ficaram abaixo da ocupação mínima.
+     */
+    bool removerRec(NoBMais* no, int x) {
+        if (no->folha) {
+            FolhaBMais* f = static_cast<FolhaBMais*>(no);
+            int i = contarMenores(f->chaves, f->n, x);
+            if (i >= f->n || f->chaves[i] != x) return false; // Não encontrado
+            total--;
+            if (f->contadores[i] > 1) {
+                f->contadores[i]--; // Apenas decrementa, como em A4
+                return true;
+            }
+            for (int j = i; j < f->n - 1; j++) {
+                f->chaves[j] = f->chaves[j + 1];
+                f->contadores[j] = f->contadores[j + 1];
+            }
+            f->n--;
+            f->chaves[f->n] = INT_MAX;
+            return true;
+        }
+
+        InternoBMais* interno = static_cast<InternoBMais*>(no);
+        int i = contarMenoresOuIguais(interno->chaves, interno->n, x);
+        if (!removerRec(interno->filhos[i], x)) return false;
+        if (interno->filhos[i]->n < MINIMO) {
+            corrigirFilho(interno, i);
+        }
+        return true;
+    }
+
+    /**
+     * @brief O filho i ficou com menos que MINIMO chaves: pega uma chave
+     * emprestada de um irmão com folga, ou funde com um irmão.
+     */
+    void corrigirFilho(InternoBMais* pai, int i) {
+        NoBMais* esq = (i > 0) ? pai->filhos[i - 1] : nullptr;
+        NoBMais* dir = (i < pai->n) ? pai->filhos[i + 1] : nullptr;
+
+        if (esq != nullptr && esq->n > MINIMO) {
+            emprestarDaEsquerda(pai, i);
+        } else if (dir != nullptr && dir->n > MINIMO) {
+            emprestarDaDireita(pai, i);
+        } else if (esq != nullptr) {
+            fundir(pai, i - 1); // filho é absorvido pelo irmão esquerdo
+        } else {
+            fundir(pai, i);     // irmão direito é absorvido pelo filho
+        }
+    }
+
+    void emprestarDaEsquerda(InternoBMais* pai, int i) {
+        NoBMais* filho = pai->filhos[i];
+        NoBMais* esq = pai->filhos[i - 1];
+        for (int j = filho->n; j > 0; j--) {
+            filho->chaves[j] = filho->chaves[j - 1];
+        }
+        if (filho->folha) {
+            FolhaBMais* f = static_cast<FolhaBMais*>(filho);
+            FolhaBMais* e = static_cast<FolhaBMais*>(esq);
+            for (int j = f->n; j > 0; j--) {
+                f->contadores[j] = f->contadores[j - 1];
+            }
+            f->chaves[0] = e->chaves[e->n - 1];
+            f->contadores[0] = e->contadores[e->n - 1];
+            pai->chaves[i - 1] = f->chaves[0];
+        } else {
+            InternoBMais* f = static_cast<InternoBMais*>(filho);
+            InternoBMais* e = static_cast<InternoBMais*>(esq);
+            for (int j = f->n + 1; j > 0; j--) {
+                f->filhos[j] = f->filhos[j - 1];
+            }
+            f->chaves[0] = pai->chaves[i - 1];
+            f->filhos[0] = e->filhos[e->n];
+            pai->chaves[i - 1] = e->chaves[e->n - 1];
+        }
+        filho->n++;
+        esq->n--;
+        esq->chaves[esq->n] = INT_MAX;
+    }
+
+    void emprestarDaDireita(InternoBMais* pai, int i) {
+        NoBMais* filho = pai->filhos[i];
+        NoBMais* dir = pai->filhos[i + 1];
+        if (filho->folha) {
+            FolhaBMais* f = static_cast<FolhaBMais*>(filho);
+            FolhaBMais* d = static_cast<FolhaBMais*>(dir);
+            f->chaves[f->n] = d->chaves[0];
+            f->contadores[f->n] = d->contadores[0];
+            for (int j = 0; j < d->n - 1; j++) {
+                d->chaves[j] = d->chaves[j + 1];
+                d->contadores[j] = d->contadores[j + 1];
+            }
+            pai->chaves[i] = d->chaves[0];
+        } else {
+            InternoBMais* f = static_cast<InternoBMais*>(filho);
+            InternoBMais* d = static_cast<InternoBMais*>(dir);
+            f->chaves[f->n] = pai->chaves[i];
+            f->filhos[f->n + 1] = d->filhos[0];
+            pai->chaves[i] = d->chaves[0];
+            for (int j = 0; j < d->n - 1; j++) {
+                d->chaves[j] = d->chaves[j + 1];
+            }
+            for (int j = 0; j < d->n; j++) {
+                d->filhos[j] = d->filhos[j + 1];
+            }
+        }
+        filho->n++;
+        dir->n--;
+        dir->chaves[dir->n] = INT_MAX;
+    }
+
+    /**
+     * @brief Funde o filho i+1 no filho i e retira a separadora i do pai.
+     */
+    void fundir(InternoBMais* pai, int i) {
+        NoBMais* esq = pai->filhos[i];
+        NoBMais* dir = pai->filhos[i + 1];
+        if (esq->folha) {
+            FolhaBMais* e = static_cast<FolhaBMais*>(esq);
+            FolhaBMais* d = static_cast<FolhaBMais*>(dir);
+            for (int j = 0; j < d->n; j++) {
+                e->chaves[e->n + j] = d->chaves[j];
+                e->contadores[e->n + j] = d->contadores[j];
+            }
+            e->n += d->n;
+            e->proxima = d->proxima;
+            delete d;
+        } else {
+            InternoBMais* e = static_cast<InternoBMais*>(esq);
+            InternoBMais* d = static_cast<InternoBMais*>(dir);
+            e->chaves[e->n] = pai->chaves[i];
+            for (int j = 0; j < d->n; j++) {
+                e->chaves[e->n + 1 + j] = d->chaves[j];
+            }
+            for (int j = 0; j <= d->n; j++) {
+                e->filhos[e->n + 1 + j] = d->filhos[j];
+            }
+            e->n += d->n + 1;
+            delete d;
+        }
+        for (int j = i; j < pai->n - 1; j++) {
+            pai->chaves[j] = pai->chaves[j + 1];
+            pai->filhos[j + 1] = pai->filhos[j + 2];
+        }
+        pai->n--;
+        pai->chaves[pai->n] = INT_MAX;
+    }
+
+    // --- Limpeza ---
+
+    void destruirRec(NoBMais* no) {
+        if (no->folha) {
+            delete static_cast<FolhaBMais*>(no);
+            return;
+        }
+        InternoBMais* interno = static_cast<InternoBMais*>(no);
+        for (int j = 0; j <= interno->n; j++) {
+            destruirRec(interno->filhos[j]);
+        }
+        delete interno;
+    }
+
+    const FolhaBMais* encontrarFolha(int x) const {
+        const NoBMais* no = raiz;
+        while (!no->folha) {
+            const InternoBMais* interno = static_cast<const InternoBMais*>(no);
+            no = interno->filhos[contarMenoresOuIguais(interno->chaves, interno->n, x)];
+        }
+        return static_cast<const FolhaBMais*>(no);
+    }
+
+public:
+    /**
+     * @param permitirDuplicatas false: conjunto (como A1); true:
+     * multiconjunto com contador de ocorrências (como A4).
+     */
+    ArvoreBMais(bool permitirDuplicatas = false)
+        : multiconjunto(permitirDuplicatas), total(0) {
+        primeiraFolha = new FolhaBMais();
+        raiz = primeiraFolha;
+    }
+
+    ~ArvoreBMais() {
+        destruirRec(raiz);
+    }
+
+    ArvoreBMais(const ArvoreBMais&) = delete;
+    ArvoreBMais& operator=(const ArvoreBMais&) = delete;
+
+    void inserir(int valor) {
+        Divisao divisao;
+        if (inserirRec(raiz, valor, divisao)) {
+            // A raiz se dividiu: a árvore cresce um nível.
+            InternoBMais* novaRaiz = new InternoBMais();
+            novaRaiz->chaves[0] = divisao.separador;
+            novaRaiz->filhos[0] = raiz;
+            novaRaiz->filhos[1] = divisao.direito;
+            novaRaiz->n = 1;
+            raiz = novaRaiz;
+        }
+    }
+
+    void remover(int valor) {
+        removerRec(raiz, valor);
+        if (!raiz->folha && raiz->n == 0) {
+            // A raiz ficou sem separadoras: a árvore perde um nível.
+            InternoBMais* antiga = static_cast<InternoBMais*>(raiz);
+            raiz = antiga->filhos[0];
+            delete antiga;
+        }
+    }
+
+    // Quantas ocorrências do valor existem (0 se ausente).
+    int contar(int valor) const {
+        const FolhaBMais* f = encontrarFolha(valor);
+        int i = contarMenores(f->chaves, f->n, valor);
+        return (i < f->n && f->chaves[i] == valor) ? f->contadores[i] : 0;
+    }
+
+    bool contem(int valor) const {
+        return contar(valor) > 0;
+    }
+
+    // Total de ocorrências (soma dos contadores).
+    long long tamanho() const {
+        return total;
+    }
+
+    /**
+     * @brief Maior valor da árvore (como encontrarMaiorValor em A2).
+     * Desce sempre pelo último filho até a folha mais à direita.
+     */
+    int encontrarMaiorValor() const {
+        if (total == 0) {
+            throw runtime_error("Erro: A árvore está vazia.");
+        }
+        const NoBMais* no = raiz;
+        while (!no->folha) {
+            const InternoBMais* interno = static_cast<const InternoBMais*>(no);
+            no = interno->filhos[interno->n];
+        }
+        return no->chaves[no->n - 1];
+    }
+
+    /**
+     * @brief Visita (valor, contador) em ordem crescente, seguindo o
+     * encadeamento das folhas (leitura sequencial, sem pilha).
+     */
+    template <typename Visitante>
+    void visitarEmOrdem(Visitante visitar) const {
+        for (const FolhaBMais* f = primeiraFolha; f != nullptr; f = f->proxima) {
+            for (int i = 0; i < f->n; i++) {
+                visitar(f->chaves[i], f->contadores[i]);
+            }
+        }
+    }
+
+    void listarEmOrdem() const {
+        cout << "[Em-Ordem]:   ";
+        if (total == 0) cout << "(Arvore Vazia)";
+        visitarEmOrdem([this](int valor, int contador) {
+            if (multiconjunto) {
+                cout << valor << " (" << contador << "x) ";
+            } else {
+                cout << valor << " ";
+            }
+        });
+        cout << endl;
+    }
+
+    // Número de níveis (1 = só a raiz folha).
+    int altura() const {
+        int h = 1;
+        for (const NoBMais* no = raiz; !no->folha; h++) {
+            no = static_cast<const InternoBMais*>(no)->filhos[0];
+        }
+        return h;
+    }
+};
+
+// --- Função principal (main) para testar o código ---
+int main() {
+    // Define o encoding do console para UTF-8 (para acentos)
+    #ifdef _WIN32
+        system("chcp 65001 > nul");
+    #endif
+
+#if defined(__AVX2__)
+    cout << "Busca no no: AVX2 (8 chaves por comparacao)" << endl;
+#elif defined(__SSE2__)
+    cout << "Busca no no: SSE2 (4 chaves por comparacao)" << endl;
+#else
+    cout << "Busca no no: escalar" << endl;
+#endif
+
+    cout << "\n--- Conjunto (operacoes de A1) ---" << endl;
+    ArvoreBMais conjunto;
+    int valoresA1[] = {20, 5, 12, 36, 27, 45, 9, 2, 6, 17, 40};
+    for (int v : valoresA1) {
+        conjunto.inserir(v);
+    }
+    conjunto.listarEmOrdem();
+    conjunto.remover(9);
+    conjunto.remover(5);
+    conjunto.remover(20);
+    cout << "Apos remover 9, 5 e 20:" << endl;
+    conjunto.listarEmOrdem();
+    cout << "Maior valor (A2): " << conjunto.encontrarMaiorValor() << endl;
+
+    cout << "\n--- Multiconjunto (contadores de A4) ---" << endl;
+    ArvoreBMais multi(true);
+    int valoresA4[] = {20, 10, 30, 5, 15, 20, 10, 5, 20, 40};
+    for (int v : valoresA4) {
+        multi.inserir(v);
+    }
+    multi.listarEmOrdem();
+    int remocoes[] = {5, 20, 5, 30, 20, 20};
+    for (int v : remocoes) {
+        multi.remover(v);
+    }
+    cout << "Apos as remocoes de A4:" << endl;
+    multi.listarEmOrdem();
+
+    cout << "\n--- Arvore vazia (A2) ---" << endl;
+    ArvoreBMais vazia;
+    try {
+        cout << vazia.encontrarMaiorValor() << endl;
+    } catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+
+    // Comparativo com std::multiset (árvore rubro-negra, 1 chave por nó).
+    const int N = 1000000;
+    vector<int> chaves(N);
+    mt19937 gerador(11);
+    for (int i = 0; i < N; i++) {
+        chaves[i] = (int)(gerador() % (N / 2)); // Com duplicatas
+    }
+
+    cout << "\n--- Comparativo com std::multiset (" << N << " chaves, ms) ---" << endl;
+    auto t0 = chrono::steady_clock::now();
+    ArvoreBMais grande(true);
+    for (int v : chaves) grande.inserir(v);
+    auto t1 = chrono::steady_clock::now();
+    long long achados = 0;
+    for (int v : chaves) achados += grande.contar(v + 1);
+    auto t2 = chrono::steady_clock::now();
+    long long soma = 0;
+    grande.visitarEmOrdem([&](int valor, int contador) { soma += (long long)valor * contador; });
+    auto t3 = chrono::steady_clock::now();
+
+    multiset<int> referencia;
+    for (int v : chaves) referencia.insert(v);
+    auto t4 = chrono::steady_clock::now();
+    long long achadosRef = 0;
+    for (int v : chaves) achadosRef += referencia.count(v + 1);
+    auto t5 = chrono::steady_clock::now();
+    long long somaRef = 0;
+    for (int v : referencia) somaRef += v;
+    auto t6 = chrono::steady_clock::now();
+
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    cout << "  Insercao:    B+ " << ms(t0, t1) << " | multiset " << ms(t3, t4) << endl;
+    cout << "  Consulta:    B+ " << ms(t1, t2) << " | multiset " << ms(t4, t5) << endl;
+    cout << "  Varredura:   B+ " << ms(t2, t3) << " | multiset " << ms(t5, t6) << endl;
+    cout << "  Conferencia: " << (achados == achadosRef && soma == somaRef ? "OK" : "DIVERGENTE")
+         << " (altura B+ = " << grande.altura() << ")" << endl;
+
+    for (int v : chaves) grande.remover(v);
+    cout << "  Apos remover tudo: " << grande.tamanho() << " ocorrencias, altura "
+         << grande.altura() << endl;
+
+    return 0;
+}
@@ -1,14 +1,144 @@
 #include <iostream>
 #include <string>
+#include <string_view> // Nomes guardados na arena e consultas sem cópia
 #include <algorithm> // Para std::max
 #include <limits>    // Para std::numeric_limits
+#include <vector>
+#include <set>       // Referência do comparativo de nomes
+#include <cstdint>   // Para uint8_t / uint32_t (colunas)
+#include <cstring>   // Para memcpy
+#include <climits>   // Para INT_MAX / INT_MIN
+#include <cmath>     // Para HUGE_VAL
+#include <random>    // Para gerar pessoas nos comparativos
+#include <chrono>    // Para medir os comparativos
+#include <cstdlib>   // Para atoi
+#include <cstdio>    // Para snprintf
+#include <stdexcept> // Para runtime_error
+#include <new>       // Para align_val_t (controle da tabela de hash)
+#include <charconv>  // Para from_chars (importação)
+#include <thread>    // Leitura do arquivo em paralelo
+#include <fstream>   // Importação fora de sistemas POSIX
+#include <iterator>  // Para istreambuf_iterator
+#include <atomic>    // Servidor: parada e contadores
+#include <shared_mutex> // Servidor: leituras em paralelo, escritas exclusivas
+#include <mutex>     // Diário: confirmação em grupo
+#include <condition_variable> // Diário: espera a gravação em curso
+#include <functional> // Para function (gancho antes de enviar a saída)
+#include <memory>    // Para unique_ptr (persistência opcional)
+#if defined(__SSE2__)
+#include <emmintrin.h> // Varreduras SSE2 nas colunas
+#endif
+#ifndef _WIN32
+#include <fcntl.h>     // Para open
+#include <sys/mman.h>  // Para mmap / munmap
+#include <sys/stat.h>  // Para fstat
+#include <unistd.h>    // Para close / fdatasync
+#include <dirent.h>    // Persistência: achar o snapshot mais novo
+#include <cerrno>      // Para errno
+#endif
+#ifdef __linux__
+#include <sys/epoll.h>   // Servidor: laço de eventos
+#include <sys/socket.h>  // Servidor: socket Unix
+#include <sys/un.h>      // Para sockaddr_un
+#include <signal.h>      // Para parar o servidor com SIGINT/SIGTERM
+#endif
 
 using namespace std;
 
+// --- Nomes: arena única e prefixo de 8 bytes ---
+
+/**
+ * @brief Guarda os nomes uma única vez, em blocos grandes de bytes
+ * contíguos; os nós só apontam para eles (string_view). Evita uma
+ * alocação por nome e mantém os bytes estáveis enquanto a árvore existir.
+ * Nomes removidos não devolvem o espaço (os blocos são liberados juntos
+ * no destrutor).
+ */
+class ArenaDeNomes {
+private:
+    static const size_t TAMANHO_BLOCO = 1 << 20;
+
+    vector<char*> blocos;
+    char* cursor;
+    size_t restante;
+    size_t usados;
+
+public:
+    ArenaDeNomes() : cursor(nullptr), restante(0), usados(0) {}
+
+    ~ArenaDeNomes() {
+        for (char* bloco : blocos) delete[] bloco;
+    }
+
+    ArenaDeNomes(const ArenaDeNomes&) = delete;
+    ArenaDeNomes& operator=(const ArenaDeNomes&) = delete;
+
+    string_view guardar(string_view nome) {
+        if (nome.size() > restante) {
+            size_t tamanho = (nome.size() > TAMANHO_BLOCO) ? nome.size() : TAMANHO_BLOCO;
+            blocos.push_back(new char[tamanho]);
+            cursor = blocos.back();
+            restante = tamanho;
+        }
+        memcpy(cursor, nome.data(), nome.size());
+        string_view guardado(cursor, nome.size());
+        cursor += nome.size();
+        restante -= nome.size();
+        usados += nome.size();
+        return guardado;
+    }
+
+    size_t bytesUsados() const {
+        return usados;
+    }
+};
+
+/**
+ * @brief Os 8 primeiros bytes do nome como inteiro big-endian (completado
+ * com zeros): comparar dois prefixos como inteiros dá a mesma ordem que
+ * comparar os bytes, então a maioria das comparações termina aqui.
+ */
+uint64_t prefixoDoNome(string_view nome) {
+    uint64_t prefixo = 0;
+    for (size_t i = 0; i < 8; i++) {
+        unsigned char c = (i < nome.size()) ? (unsigned char)nome[i] : 0;
+        prefixo = (prefixo << 8) | c;
+    }
+    return prefixo;
+}
+
+// --- Somas da Sub-árvore (estatísticas por faixa de nomes) ---
+
+/**
+ * @brief Contagens e somas de uma sub-árvore inteira (o nó e todos os
+ * descendentes). Cada nó guarda as suas; somar as de O(log n) sub-árvores
+ * responde uma faixa de nomes sem visitar as pessoas uma a uma.
+ */
+struct SomaSubarvore {
+    uint32_t contagem;
+    uint32_t homens, mulheres;
+    long long somaIdade;
+    double somaPeso;
+
+    void somar(const SomaSubarvore& outra) {
+        contagem += outra.contagem;
+        homens += outra.homens;
+        mulheres += outra.mulheres;
+        somaIdade += outra.somaIdade;
+        somaPeso += outra.somaPeso;
+    }
+
+    double mediaIdade() const { return contagem ? (double)somaIdade / contagem : 0.0; }
+    double mediaPeso() const { return contagem ? somaPeso / contagem : 0.0; }
+};
+
 // --- Estrutura do Nó (Modificada para AVL) ---
 struct NoArvore {
+    // Chave: prefixo (comparação rápida) e o nome completo, na arena
+    uint64_t prefixo;
+    string_view nome;
+
     // Dados do nó
-    string nome;
     char sexo; // 'M' ou 'F'
     int idade;
     double peso;
@@ -20,304 +150,2985 @@ struct NoArvore {
     // Campo essencial para AVL: altura do nó
     int altura;
 
-    // Construtor atualizado
-    NoArvore(string n, char s, int i, double p)
-        : nome(n), sexo(s), idade(i), peso(p), 
-          esquerda(nullptr), direita(nullptr), altura(1) {} // Novas folhas têm altura 1
+    // Somas da sub-árvore deste nó (refeitas junto com a altura)
+    SomaSubarvore soma;
+
+    // Linha desta pessoa no armazenamento colunar (ColunasPessoas)
+    uint32_t linha;
+
+    // Construtor atualizado ('n' já deve estar guardado na arena)
+    NoArvore(string_view n, uint64_t pre, char s, int i, double p)
+        : prefixo(pre), nome(n), sexo(s), idade(i), peso(p),
+          esquerda(nullptr), direita(nullptr), altura(1), // Novas folhas têm altura 1
+          soma{1, s == 'M', s == 'F', i, p} {}
 };
 
+/**
+ * @brief Comparação de três vias de (nome, prefixo) com a chave de um nó:
+ * < 0, 0 ou > 0. Só olha o resto dos nomes quando os prefixos empatam.
+ */
+int compararNome(string_view nome, uint64_t prefixo, const NoArvore* no) {
+    if (prefixo != no->prefixo) {
+        return (prefixo < no->prefixo) ? -1 : 1;
+    }
+    if (nome.size() >= 8 && no->nome.size() >= 8) {
+        return nome.substr(8).compare(no->nome.substr(8)); // 8 primeiros iguais
+    }
+    return nome.compare(no->nome);
+}
 
-class ArvoreAVL {
+/**
+ * @brief O nome do nó começa com 'prefixo'? ('chave' = prefixoDoNome(prefixo))
+ * Até 8 bytes, basta comparar os bytes altos dos prefixos inteiros.
+ */
+bool comecaCom(const NoArvore* no, string_view prefixo, uint64_t chave) {
+    if (no->nome.size() < prefixo.size()) {
+        return false;
+    }
+    if (prefixo.size() < 8) {
+        uint64_t mascara = prefixo.empty() ? 0 : ~0ull << (8 * (8 - prefixo.size()));
+        return (no->prefixo & mascara) == chave;
+    }
+    return no->prefixo == chave && memcmp(no->nome.data() + 8, prefixo.data() + 8, prefixo.size() - 8) == 0;
+}
+
+
+// --- Armazenamento Colunar (sexo/idade/peso em arrays contíguos) ---
+
+/**
+ * @brief Filtro de uma varredura analítica: sexo ('M', 'F' ou 0 para
+ * qualquer um) e intervalos fechados de idade e peso.
+ */
+struct FiltroPessoas {
+    char sexo;
+    int idadeMin, idadeMax;
+    double pesoMin, pesoMax;
+};
+
+/**
+ * @brief Resultado de uma varredura: contagem, somas, mínimos e máximos
+ * das linhas que passaram no filtro.
+ */
+struct AgregadoPessoas {
+    size_t contagem;
+    long long somaIdade;
+    int minIdade, maxIdade;
+    double somaPeso;
+    double minPeso, maxPeso;
+
+    double mediaIdade() const { return contagem ? (double)somaIdade / contagem : 0.0; }
+    double mediaPeso() const { return contagem ? somaPeso / contagem : 0.0; }
+};
+
+/**
+ * @brief Cópia colunar dos campos numéricos de cada pessoa.
+ *
+ * Cada pessoa ocupa uma "linha" (o mesmo índice nos três arrays); o nó da
+ * árvore guarda o número da sua linha. Uma varredura como "peso médio das
+ * mulheres de 30 a 40 anos" lê só esses arrays, em sequência, 4 linhas por
+ * instrução SSE2, em vez de seguir ponteiros nó a nó.
+ * Linhas removidas ficam marcadas com sexo = 0 (nunca passam no filtro) e
+ * são reaproveitadas pela próxima inserção.
+ */
+class ColunasPessoas {
 private:
-    NoArvore* raiz;
+    vector<uint8_t> sexo;   // 0 = linha livre
+    vector<int32_t> idade;
+    vector<double> peso;
+    vector<uint32_t> livres;
+    size_t vivas;
 
-    // --- Funções Auxiliares de Balanceamento (Núcleo do AVL) ---
+#if defined(__SSE2__)
+    // Constantes do filtro repetidas nas 4 faixas de um registrador.
+    struct FiltroSSE2 {
+        __m128i sexoAlvo, qualquerSexo, idadeMin, idadeMax;
+        __m128d pesoMin, pesoMax;
 
-    // Retorna a altura de um nó (0 se for nulo)
-    int getAltura(NoArvore* no) {
-        if (no == nullptr) {
-            return 0;
+        explicit FiltroSSE2(const FiltroPessoas& f)
+            : sexoAlvo(_mm_set1_epi32((uint8_t)f.sexo)),
+              qualquerSexo(_mm_set1_epi32(f.sexo == 0 ? -1 : 0)),
+              idadeMin(_mm_set1_epi32(f.idadeMin)), idadeMax(_mm_set1_epi32(f.idadeMax)),
+              pesoMin(_mm_set1_pd(f.pesoMin)), pesoMax(_mm_set1_pd(f.pesoMax)) {}
+    };
+
+    /**
+     * @brief Máscara (4 x 32 bits, tudo 1 = passa) das linhas i..i+3.
+     * Devolve também as idades e pesos carregados, para os agregados.
+     */
+    __m128i mascara(const FiltroSSE2& f, size_t i, __m128i& id, __m128d& p0, __m128d& p1) const {
+        const __m128i zero = _mm_setzero_si128();
+        // Sexo: 4 bytes alargados para 4 inteiros de 32 bits.
+        int32_t quatro;
+        memcpy(&quatro, &sexo[i], 4);
+        __m128i s = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(quatro), zero), zero);
+        __m128i m = _mm_andnot_si128(_mm_cmpeq_epi32(s, zero),
+                                     _mm_or_si128(f.qualquerSexo, _mm_cmpeq_epi32(s, f.sexoAlvo)));
+
+        id = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&idade[i]));
+        __m128i foraIdade = _mm_or_si128(_mm_cmplt_epi32(id, f.idadeMin), _mm_cmpgt_epi32(id, f.idadeMax));
+        m = _mm_andnot_si128(foraIdade, m);
+
+        // Peso: 2 doubles por registrador; as máscaras de 64 bits são
+        // reduzidas a 32 bits para combinar com as outras.
+        p0 = _mm_loadu_pd(&peso[i]);
+        p1 = _mm_loadu_pd(&peso[i + 2]);
+        __m128d ok0 = _mm_and_pd(_mm_cmpge_pd(p0, f.pesoMin), _mm_cmple_pd(p0, f.pesoMax));
+        __m128d ok1 = _mm_and_pd(_mm_cmpge_pd(p1, f.pesoMin), _mm_cmple_pd(p1, f.pesoMax));
+        __m128i okPeso = _mm_castps_si128(_mm_shuffle_ps(_mm_castpd_ps(ok0), _mm_castpd_ps(ok1),
+                                                         _MM_SHUFFLE(2, 0, 2, 0)));
+        return _mm_and_si128(m, okPeso);
+    }
+#endif
+
+    // Versão escalar do filtro (sobras do fim e máquinas sem SSE2).
+    bool passa(const FiltroPessoas& f, size_t i) const {
+        return sexo[i] != 0 && (f.sexo == 0 || sexo[i] == (uint8_t)f.sexo) &&
+               idade[i] >= f.idadeMin && idade[i] <= f.idadeMax &&
+               peso[i] >= f.pesoMin && peso[i] <= f.pesoMax;
+    }
+
+public:
+    ColunasPessoas() : vivas(0) {}
+
+    uint32_t adicionar(char s, int i, double p) {
+        uint32_t linha;
+        if (!livres.empty()) {
+            linha = livres.back();
+            livres.pop_back();
+        } else {
+            linha = (uint32_t)sexo.size();
+            sexo.push_back(0);
+            idade.push_back(0);
+            peso.push_back(0);
         }
-        return no->altura;
+        sexo[linha] = (uint8_t)s;
+        idade[linha] = i;
+        peso[linha] = p;
+        vivas++;
+        return linha;
     }
 
-    // Atualiza a altura de um nó com base em seus filhos
-    void atualizarAltura(NoArvore* no) {
-        if (no != nullptr) {
-            no->altura = 1 + max(getAltura(no->esquerda), getAltura(no->direita));
+    void remover(uint32_t linha) {
+        sexo[linha] = 0;
+        livres.push_back(linha);
+        vivas--;
+    }
+
+    size_t tamanho() const {
+        return vivas;
+    }
+
+    /**
+     * @brief Conta, soma e acha mínimo/máximo de idade e peso das linhas
+     * que passam no filtro, numa única passada sem desvios por linha.
+     */
+    AgregadoPessoas agregar(const FiltroPessoas& f) const {
+        AgregadoPessoas r = {0, 0, INT_MAX, INT_MIN, 0.0, HUGE_VAL, -HUGE_VAL};
+        size_t n = sexo.size();
+        size_t i = 0;
+#if defined(__SSE2__)
+        const FiltroSSE2 filtro(f);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128d infinito = _mm_set1_pd(HUGE_VAL);
+        const __m128d menosInfinito = _mm_set1_pd(-HUGE_VAL);
+        __m128i contagem = zero, somaIdade = zero;
+        __m128i minIdade = _mm_set1_epi32(INT_MAX), maxIdade = _mm_set1_epi32(INT_MIN);
+        __m128d somaPeso = _mm_setzero_pd();
+        __m128d minPeso = infinito, maxPeso = menosInfinito;
+
+        for (; i + 4 <= n; i += 4) {
+            __m128i id;
+            __m128d p0, p1;
+            __m128i m = mascara(filtro, i, id, p0, p1);
+
+            // Agregados: linhas fora do filtro entram como 0 (somas),
+            // +infinito (mínimos) ou -infinito (máximos).
+            contagem = _mm_sub_epi32(contagem, m);
+            __m128i idM = _mm_and_si128(id, m);
+            somaIdade = _mm_add_epi64(somaIdade, _mm_unpacklo_epi32(idM, zero));
+            somaIdade = _mm_add_epi64(somaIdade, _mm_unpackhi_epi32(idM, zero));
+            __m128i menor = _mm_cmplt_epi32(id, minIdade);
+            menor = _mm_and_si128(menor, m);
+            minIdade = _mm_or_si128(_mm_and_si128(menor, id), _mm_andnot_si128(menor, minIdade));
+            __m128i maior = _mm_and_si128(_mm_cmpgt_epi32(id, maxIdade), m);
+            maxIdade = _mm_or_si128(_mm_and_si128(maior, id), _mm_andnot_si128(maior, maxIdade));
+
+            __m128d m0 = _mm_castsi128_pd(_mm_unpacklo_epi32(m, m));
+            __m128d m1 = _mm_castsi128_pd(_mm_unpackhi_epi32(m, m));
+            somaPeso = _mm_add_pd(somaPeso, _mm_add_pd(_mm_and_pd(m0, p0), _mm_and_pd(m1, p1)));
+            minPeso = _mm_min_pd(minPeso, _mm_or_pd(_mm_and_pd(m0, p0), _mm_andnot_pd(m0, infinito)));
+            minPeso = _mm_min_pd(minPeso, _mm_or_pd(_mm_and_pd(m1, p1), _mm_andnot_pd(m1, infinito)));
+            maxPeso = _mm_max_pd(maxPeso, _mm_or_pd(_mm_and_pd(m0, p0), _mm_andnot_pd(m0, menosInfinito)));
+            maxPeso = _mm_max_pd(maxPeso, _mm_or_pd(_mm_and_pd(m1, p1), _mm_andnot_pd(m1, menosInfinito)));
+        }
+
+        // Reduz as faixas do registrador para os escalares.
+        alignas(16) int32_t c32[4], mn32[4], mx32[4];
+        alignas(16) long long s64[2];
+        alignas(16) double sp[2], mnp[2], mxp[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(c32), contagem);
+        _mm_store_si128(reinterpret_cast<__m128i*>(mn32), minIdade);
+        _mm_store_si128(reinterpret_cast<__m128i*>(mx32), maxIdade);
+        _mm_store_si128(reinterpret_cast<__m128i*>(s64), somaIdade);
+        _mm_store_pd(sp, somaPeso);
+        _mm_store_pd(mnp, minPeso);
+        _mm_store_pd(mxp, maxPeso);
+        for (int k = 0; k < 4; k++) {
+            r.contagem += (uint32_t)c32[k];
+            r.minIdade = min(r.minIdade, mn32[k]);
+            r.maxIdade = max(r.maxIdade, mx32[k]);
+        }
+        r.somaIdade = s64[0] + s64[1];
+        r.somaPeso = sp[0] + sp[1];
+        r.minPeso = min(mnp[0], mnp[1]);
+        r.maxPeso = max(mxp[0], mxp[1]);
+#endif
+        // Linhas restantes (ou todas, sem SSE2).
+        for (; i < n; i++) {
+            if (passa(f, i)) {
+                r.contagem++;
+                r.somaIdade += idade[i];
+                r.minIdade = min(r.minIdade, (int)idade[i]);
+                r.maxIdade = max(r.maxIdade, (int)idade[i]);
+                r.somaPeso += peso[i];
+                r.minPeso = min(r.minPeso, peso[i]);
+                r.maxPeso = max(r.maxPeso, peso[i]);
+            }
         }
+        return r;
     }
 
-    // Calcula o Fator de Balanceamento
-    int getFatorBalanceamento(NoArvore* no) {
-        if (no == nullptr) {
-            return 0;
+    /**
+     * @brief Só a contagem das linhas que passam no filtro.
+     */
+    size_t contar(const FiltroPessoas& f) const {
+        size_t n = sexo.size();
+        size_t i = 0, total = 0;
+#if defined(__SSE2__)
+        const FiltroSSE2 filtro(f);
+        for (; i + 4 <= n; i += 4) {
+            __m128i id;
+            __m128d p0, p1;
+            int bits = _mm_movemask_ps(_mm_castsi128_ps(mascara(filtro, i, id, p0, p1)));
+            total += (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
         }
-        // Altura da Esquerda - Altura da Direita
-        return getAltura(no->esquerda) - getAltura(no->direita);
+#endif
+        for (; i < n; i++) {
+            total += passa(f, i);
+        }
+        return total;
     }
 
-    // Rotação Simples à Direita (Caso Esquerda-Esquerda)
-    NoArvore* rotacaoDireita(NoArvore* y) {
-        NoArvore* x = y->esquerda;
-        NoArvore* T2 = x->direita;
+    /**
+     * @brief Números das linhas que passam no filtro, em ordem de linha.
+     */
+    void filtrar(const FiltroPessoas& f, vector<uint32_t>& linhas) const {
+        linhas.clear();
+        size_t n = sexo.size();
+        size_t i = 0;
+#if defined(__SSE2__)
+        const FiltroSSE2 filtro(f);
+        for (; i + 4 <= n; i += 4) {
+            __m128i id;
+            __m128d p0, p1;
+            int bits = _mm_movemask_ps(_mm_castsi128_ps(mascara(filtro, i, id, p0, p1)));
+            for (int k = 0; k < 4; k++) {
+                if (bits & (1 << k)) linhas.push_back((uint32_t)(i + k));
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            if (passa(f, i)) linhas.push_back((uint32_t)i);
+        }
+    }
 
-        // Realiza a rotação
-        x->direita = y;
-        y->esquerda = T2;
+    // Campos de uma linha (para montar resultados).
+    char sexoDa(uint32_t linha) const { return (char)sexo[linha]; }
+    int idadeDa(uint32_t linha) const { return idade[linha]; }
+    double pesoDa(uint32_t linha) const { return peso[linha]; }
+};
 
-        // Atualiza as alturas (IMPORTANTE: primeiro 'y', depois 'x')
-        atualizarAltura(y);
-        atualizarAltura(x);
 
-        // Retorna a nova raiz da sub-árvore
-        return x;
+// --- Índices Secundários (idade / peso) ---
+
+/**
+ * @brief Índice ordenado por um campo numérico do nó (idade, peso): uma
+ * AVL própria de entradas (valor do campo, ponteiro do registro), em que o
+ * ponteiro desempata valores iguais. Guarda uma cópia do valor em cada
+ * entrada, então a descida não precisa visitar os registros.
+ *
+ * Os ponteiros só continuam válidos porque a ArvoreAVL nunca move dados
+ * entre nós (a remoção religa o sucessor em vez de copiá-lo).
+ */
+template <typename Chave, Chave NoArvore::*campo>
+class IndiceSecundario {
+private:
+    struct Entrada {
+        Chave chave;
+        const NoArvore* registro;
+        Entrada* esquerda;
+        Entrada* direita;
+        int altura;
+    };
+
+    Entrada* raiz;
+    size_t quantidade;
+
+    // Ordem (chave, endereço do registro): todas as entradas são distintas.
+    static bool menor(Chave chave, const NoArvore* registro, const Entrada* e) {
+        if (chave != e->chave) return chave < e->chave;
+        return less<const NoArvore*>()(registro, e->registro);
     }
 
-    // Rotação Simples à Esquerda (Caso Direita-Direita)
-    NoArvore* rotacaoEsquerda(NoArvore* x) {
-        NoArvore* y = x->direita;
-        NoArvore* T2 = y->esquerda;
+    static int alturaDe(const Entrada* e) {
+        return e ? e->altura : 0;
+    }
 
-        // Realiza a rotação
-        y->esquerda = x;
-        x->direita = T2;
+    static void atualizar(Entrada* e) {
+        e->altura = 1 + max(alturaDe(e->esquerda), alturaDe(e->direita));
+    }
 
-        // Atualiza as alturas (IMPORTANTE: primeiro 'x', depois 'y')
-        atualizarAltura(x);
-        atualizarAltura(y);
+    static Entrada* girarDireita(Entrada* y) {
+        Entrada* x = y->esquerda;
+        y->esquerda = x->direita;
+        x->direita = y;
+        atualizar(y);
+        atualizar(x);
+        return x;
+    }
 
-        // Retorna a nova raiz da sub-árvore
+    static Entrada* girarEsquerda(Entrada* x) {
+        Entrada* y = x->direita;
+        x->direita = y->esquerda;
+        y->esquerda = x;
+        atualizar(x);
+        atualizar(y);
         return y;
     }
 
-    // Encontra o nó com o menor valor (mais à esquerda)
-    NoArvore* encontrarMinimo(NoArvore* no) {
-        NoArvore* atual = no;
-        while (atual->esquerda != nullptr) {
-            atual = atual->esquerda;
+    static Entrada* balancear(Entrada* e) {
+        atualizar(e);
+        int fator = alturaDe(e->esquerda) - alturaDe(e->direita);
+        if (fator > 1) {
+            if (alturaDe(e->esquerda->esquerda) < alturaDe(e->esquerda->direita)) {
+                e->esquerda = girarEsquerda(e->esquerda);
+            }
+            return girarDireita(e);
         }
-        return atual;
+        if (fator < -1) {
+            if (alturaDe(e->direita->direita) < alturaDe(e->direita->esquerda)) {
+                e->direita = girarDireita(e->direita);
+            }
+            return girarEsquerda(e);
+        }
+        return e;
     }
 
+    static Entrada* _inserir(Entrada* e, Entrada* nova) {
+        if (e == nullptr) {
+            return nova;
+        }
+        if (menor(nova->chave, nova->registro, e)) {
+            e->esquerda = _inserir(e->esquerda, nova);
+        } else {
+            e->direita = _inserir(e->direita, nova);
+        }
+        return balancear(e);
+    }
 
-    // --- F1: Inserção (Recursiva com Balanceamento) ---
-    NoArvore* _inserir(NoArvore* no, string nome, char sexo, int idade, double peso) {
-        // 1. Inserção padrão de BST
-        if (no == nullptr) {
-            return new NoArvore(nome, sexo, idade, peso);
+    // Desliga a menor entrada da subárvore e a devolve em 'minima'.
+    static Entrada* _removerMinima(Entrada* e, Entrada*& minima) {
+        if (e->esquerda == nullptr) {
+            minima = e;
+            return e->direita;
         }
+        e->esquerda = _removerMinima(e->esquerda, minima);
+        return balancear(e);
+    }
 
-        if (nome < no->nome) {
-            no->esquerda = _inserir(no->esquerda, nome, sexo, idade, peso);
-        } else if (nome > no->nome) {
-            no->direita = _inserir(no->direita, nome, sexo, idade, peso);
+    Entrada* _remover(Entrada* e, Chave chave, const NoArvore* registro) {
+        if (e == nullptr) {
+            return nullptr;
+        }
+        if (chave == e->chave && registro == e->registro) {
+            Entrada* resto;
+            if (e->esquerda == nullptr || e->direita == nullptr) {
+                resto = e->esquerda ? e->esquerda : e->direita;
+            } else {
+                Entrada* direita = _removerMinima(e->direita, resto);
+                resto->esquerda = e->esquerda;
+                resto->direita = direita;
+                resto = balancear(resto);
+            }
+            delete e;
+            quantidade--;
+            return resto;
+        }
+        if (menor(chave, registro, e)) {
+            e->esquerda = _remover(e->esquerda, chave, registro);
         } else {
-            // Nomes duplicados não são permitidos (ou podem ser tratados)
-            cout << "Erro: Nome '" << nome << "' ja existe." << endl;
-            return no;
+            e->direita = _remover(e->direita, chave, registro);
         }
+        return balancear(e);
+    }
 
-        // 2. Atualizar a altura do nó atual
-        atualizarAltura(no);
+    // Em ordem, descendo só nos ramos que podem ter chaves em [lo, hi].
+    static void _intervalo(const Entrada* e, Chave lo, Chave hi, vector<const NoArvore*>& saida) {
+        while (e != nullptr) {
+            if (e->chave < lo) {
+                e = e->direita;
+            } else if (e->chave > hi) {
+                e = e->esquerda;
+            } else {
+                _intervalo(e->esquerda, lo, hi, saida);
+                saida.push_back(e->registro);
+                e = e->direita;
+            }
+        }
+    }
 
-        // 3. Obter o fator de balanceamento
-        int fator = getFatorBalanceamento(no);
+    static void _destruir(Entrada* e) {
+        if (e != nullptr) {
+            _destruir(e->esquerda);
+            _destruir(e->direita);
+            delete e;
+        }
+    }
 
-        // 4. Rebalancear a árvore (Os 4 casos)
+public:
+    IndiceSecundario() : raiz(nullptr), quantidade(0) {}
 
-        // Caso Esquerda-Esquerda (LL)
-        if (fator > 1 && nome < no->esquerda->nome) {
-            return rotacaoDireita(no);
+    ~IndiceSecundario() {
+        _destruir(raiz);
+    }
+
+    IndiceSecundario(const IndiceSecundario&) = delete;
+    IndiceSecundario& operator=(const IndiceSecundario&) = delete;
+
+    void inserir(const NoArvore* registro) {
+        raiz = _inserir(raiz, new Entrada{registro->*campo, registro, nullptr, nullptr, 1});
+        quantidade++;
+    }
+
+    void remover(const NoArvore* registro) {
+        raiz = _remover(raiz, registro->*campo, registro);
+    }
+
+    /**
+     * @brief Acrescenta a 'saida' os registros com o campo em [lo, hi],
+     * em ordem crescente do campo: O(log n + k).
+     */
+    void intervalo(Chave lo, Chave hi, vector<const NoArvore*>& saida) const {
+        _intervalo(raiz, lo, hi, saida);
+    }
+
+    void limpar() {
+        _destruir(raiz);
+        raiz = nullptr;
+        quantidade = 0;
+    }
+
+    size_t tamanho() const {
+        return quantidade;
+    }
+};
+
+
+// --- Índice de Hash por Nome (endereçamento aberto, estilo Swiss table) ---
+
+/**
+ * @brief Hash de 64 bits do nome inteiro, lido de 8 em 8 bytes.
+ */
+uint64_t hashDoNome(string_view nome) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ nome.size();
+    size_t i = 0;
+    for (; i + 8 <= nome.size(); i += 8) {
+        uint64_t bloco;
+        memcpy(&bloco, nome.data() + i, 8);
+        h = (h ^ bloco) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 31;
+    }
+    uint64_t resto = 0;
+    if (i < nome.size()) memcpy(&resto, nome.data() + i, nome.size() - i);
+    h = (h ^ resto) * 0x94D049BB133111EBull;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 32);
+}
+
+/**
+ * @brief Tabela nome -> nó para consultas exatas em O(1).
+ *
+ * Cada posição tem um byte de controle: VAZIO, APAGADO ou os 7 bits
+ * baixos do hash (a posição está ocupada). As posições são lidas em
+ * grupos de 16 alinhados: uma comparação SSE2 acha de uma vez as
+ * posições do grupo cujo byte bate, e só essas são conferidas.
+ * A sondagem pula de grupo em grupo (passos 1, 2, 3, ...) e para no
+ * primeiro grupo com uma posição VAZIO.
+ *
+ * Ao lado do ponteiro, cada posição guarda o prefixo de 8 bytes do nome:
+ * candidatos errados caem sem tocar no nó, e nomes de até 8 bytes são
+ * confirmados pelo nó sem ler a arena. As posições do primeiro grupo são
+ * pedidas à memória junto com os bytes de controle (prefetch).
+ */
+class TabelaDeNomes {
+private:
+    static const int GRUPO = 16;
+    static const int8_t VAZIO = -128;  // 0b10000000
+    static const int8_t APAGADO = -2;  // 0b11111110
+
+    struct Posicao {
+        uint64_t prefixo;
+        NoArvore* no;
+    };
+
+    int8_t* controle;
+    Posicao* posicoes;
+    size_t capacidade; // Potência de 2, múltipla de GRUPO (0 = sem memória)
+    size_t ocupadas;
+    size_t apagadas;
+
+    // Bits de cada posição do grupo cujo byte de controle é 'byte'.
+    uint32_t casar(const int8_t* grupo, int8_t byte) const {
+#if defined(__SSE2__)
+        __m128i g = _mm_load_si128(reinterpret_cast<const __m128i*>(grupo));
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(byte)));
+#else
+        uint32_t bits = 0;
+        for (int k = 0; k < GRUPO; k++) {
+            if (grupo[k] == byte) bits |= 1u << k;
         }
+        return bits;
+#endif
+    }
 
-        // Caso Direita-Direita (RR)
-        if (fator < -1 && nome > no->direita->nome) {
-            return rotacaoEsquerda(no);
+    // Bits das posições livres (VAZIO ou APAGADO: bit alto 1, valor < -1).
+    uint32_t livres(const int8_t* grupo) const {
+#if defined(__SSE2__)
+        __m128i g = _mm_load_si128(reinterpret_cast<const __m128i*>(grupo));
+        return (uint32_t)_mm_movemask_epi8(_mm_cmplt_epi8(g, _mm_set1_epi8(-1)));
+#else
+        uint32_t bits = 0;
+        for (int k = 0; k < GRUPO; k++) {
+            if (grupo[k] < -1) bits |= 1u << k;
         }
+        return bits;
+#endif
+    }
 
-        // Caso Esquerda-Direita (LR)
-        if (fator > 1 && nome > no->esquerda->nome) {
-            no->esquerda = rotacaoEsquerda(no->esquerda);
-            return rotacaoDireita(no);
+    static int primeiroBit(uint32_t bits) {
+        return __builtin_ctz(bits);
+    }
+
+    void alocar(size_t novaCapacidade) {
+        capacidade = novaCapacidade;
+        controle = static_cast<int8_t*>(::operator new(capacidade, align_val_t(GRUPO)));
+        memset(controle, VAZIO, capacidade);
+        posicoes = new Posicao[capacidade];
+        ocupadas = 0;
+        apagadas = 0;
+    }
+
+    void liberar() {
+        if (capacidade) {
+            ::operator delete(controle, align_val_t(GRUPO));
+            delete[] posicoes;
         }
+        controle = nullptr;
+        posicoes = nullptr;
+        capacidade = 0;
+    }
 
-        // Caso Direita-Esquerda (RL)
-        if (fator < -1 && nome < no->direita->nome) {
-            no->direita = rotacaoDireita(no->direita);
-            return rotacaoEsquerda(no);
+    // Coloca o nó na primeira posição livre da sua sequência de sondagem
+    // (o nome não pode estar na tabela).
+    void colocar(NoArvore* no, uint64_t hash) {
+        size_t mascaraGrupos = capacidade / GRUPO - 1;
+        size_t g = (hash >> 7) & mascaraGrupos;
+        for (size_t passo = 1;; passo++) {
+            uint32_t bits = livres(controle + g * GRUPO);
+            if (bits) {
+                size_t pos = g * GRUPO + primeiroBit(bits);
+                if (controle[pos] == APAGADO) apagadas--;
+                controle[pos] = (int8_t)(hash & 0x7F);
+                posicoes[pos].prefixo = no->prefixo;
+                posicoes[pos].no = no;
+                ocupadas++;
+                return;
+            }
+            g = (g + passo) & mascaraGrupos;
         }
+    }
 
-        // Retorna o nó (potencialmente balanceado)
-        return no;
+    // Refaz a tabela com 'novaCapacidade' posições (some com os APAGADOs).
+    void redimensionar(size_t novaCapacidade) {
+        int8_t* controleAntigo = controle;
+        Posicao* posicoesAntigas = posicoes;
+        size_t capacidadeAntiga = capacidade;
+        alocar(novaCapacidade);
+        for (size_t i = 0; i < capacidadeAntiga; i++) {
+            if (controleAntigo[i] >= 0) {
+                colocar(posicoesAntigas[i].no, hashDoNome(posicoesAntigas[i].no->nome));
+            }
+        }
+        if (capacidadeAntiga) {
+            ::operator delete(controleAntigo, align_val_t(GRUPO));
+            delete[] posicoesAntigas;
+        }
     }
 
-    // --- F2: Listagem (Recursiva - Em-Ordem) ---
-    // Percurso Em-Ordem (LNR) resulta em listagem alfabética
-    void _listarEmOrdem(NoArvore* no) {
-        if (no == nullptr) {
-            return;
+    // O prefixo já bateu: com o mesmo tamanho, nomes de até 8 bytes são
+    // iguais; os maiores comparam o resto na arena.
+    static bool mesmoNome(const NoArvore* no, string_view nome) {
+        return no->nome.size() == nome.size() &&
+               (nome.size() <= 8 || memcmp(no->nome.data() + 8, nome.data() + 8, nome.size() - 8) == 0);
+    }
+
+    // Posição do nó com este nome (ou do próprio 'alvo', se dado); -1 se não há.
+    ptrdiff_t procurar(string_view nome, uint64_t prefixo, uint64_t hash, const NoArvore* alvo) const {
+        if (capacidade == 0) {
+            return -1;
+        }
+        size_t mascaraGrupos = capacidade / GRUPO - 1;
+        size_t g = (hash >> 7) & mascaraGrupos;
+        int8_t byte = (int8_t)(hash & 0x7F);
+        // As 16 posições do grupo (4 linhas de cache) vêm junto com o controle.
+        const char* linhas = reinterpret_cast<const char*>(posicoes + g * GRUPO);
+        for (size_t b = 0; b < GRUPO * sizeof(Posicao); b += 64) __builtin_prefetch(linhas + b);
+        for (size_t passo = 1;; passo++) {
+            const int8_t* grupo = controle + g * GRUPO;
+            for (uint32_t bits = casar(grupo, byte); bits; bits &= bits - 1) {
+                size_t pos = g * GRUPO + primeiroBit(bits);
+                const Posicao& p = posicoes[pos];
+                if (alvo ? p.no == alvo : (p.prefixo == prefixo && mesmoNome(p.no, nome))) {
+                    return (ptrdiff_t)pos;
+                }
+            }
+            if (casar(grupo, VAZIO)) {
+                return -1; // A sondagem de um nome presente pararia antes
+            }
+            g = (g + passo) & mascaraGrupos;
         }
-        _listarEmOrdem(no->esquerda);
-        cout << "  - Nome: " << no->nome 
-             << " (Sexo: " << no->sexo 
-             << ", Idade: " << no->idade 
-             << ", Peso: " << no->peso << ")" << endl;
-        _listarEmOrdem(no->direita);
     }
 
-    // --- F3: Remoção (Recursiva com Balanceamento) ---
-    NoArvore* _remover(NoArvore* no, string nome) {
-        // 1. Remoção padrão de BST
-        if (no == nullptr) {
-            cout << "Erro: Nome '" << nome << "' nao encontrado." << endl;
-            return no;
+public:
+    TabelaDeNomes() : controle(nullptr), posicoes(nullptr), capacidade(0), ocupadas(0), apagadas(0) {}
+
+    ~TabelaDeNomes() {
+        liberar();
+    }
+
+    TabelaDeNomes(const TabelaDeNomes&) = delete;
+    TabelaDeNomes& operator=(const TabelaDeNomes&) = delete;
+
+    NoArvore* encontrar(string_view nome, uint64_t prefixo, uint64_t hash) const {
+        ptrdiff_t pos = procurar(nome, prefixo, hash, nullptr);
+        return (pos < 0) ? nullptr : posicoes[pos].no;
+    }
+
+    // Acrescenta um nó cujo nome ainda não está na tabela.
+    void inserir(NoArvore* no, uint64_t hash) {
+        // Ocupação máxima (com os APAGADOs) de 7/8.
+        if ((ocupadas + apagadas + 1) * 8 > capacidade * 7) {
+            size_t nova = (capacidade == 0) ? GRUPO : capacidade;
+            if ((ocupadas + 1) * 2 > capacidade) nova *= 2; // Senão, só limpa os APAGADOs
+            redimensionar(nova);
         }
+        colocar(no, hash);
+    }
+
+    // Aumenta a tabela de uma vez para 'total' nomes (evita refazê-la
+    // várias vezes durante uma carga grande).
+    void reservar(size_t total) {
+        size_t nova = (capacidade == 0) ? GRUPO : capacidade;
+        while (total * 8 > nova * 7) nova *= 2;
+        if (nova != capacidade) redimensionar(nova);
+    }
 
-        if (nome < no->nome) {
-            no->esquerda = _remover(no->esquerda, nome);
-        } else if (nome > no->nome) {
-            no->direita = _remover(no->direita, nome);
+    void remover(const NoArvore* no, uint64_t hash) {
+        ptrdiff_t pos = procurar(no->nome, no->prefixo, hash, no);
+        if (pos < 0) {
+            return;
+        }
+        // Se o grupo já tem um VAZIO, nenhuma sondagem passa dele: a
+        // posição pode voltar a VAZIO. Senão vira APAGADO.
+        if (casar(controle + (pos & ~(ptrdiff_t)(GRUPO - 1)), VAZIO)) {
+            controle[pos] = VAZIO;
         } else {
-            // Nó encontrado!
-            // Caso 1: Nó sem filhos ou com um filho
-            if (no->esquerda == nullptr || no->direita == nullptr) {
-                NoArvore* temp = no->esquerda ? no->esquerda : no->direita;
+            controle[pos] = APAGADO;
+            apagadas++;
+        }
+        ocupadas--;
+    }
 
-                if (temp == nullptr) { // Sem filhos
-                    temp = no;
-                    no = nullptr;
-                } else { // Um filho
-                    *no = *temp; // Copia o conteúdo do filho
-                }
-                delete temp;
-                cout << "Info: Nome '" << nome << "' removido." << endl;
-            } else {
-                // Caso 2: Nó com dois filhos
-                // Pega o sucessor em-ordem (menor da sub-árvore direita)
-                NoArvore* temp = encontrarMinimo(no->direita);
+    size_t tamanho() const {
+        return ocupadas;
+    }
+
+    // Memória da tabela: 1 byte de controle + prefixo e ponteiro por posição.
+    size_t bytesUsados() const {
+        return capacidade * (1 + sizeof(Posicao));
+    }
+};
+
+// --- Importação de CSV/TSV (arquivo mapeado, leitura em paralelo) ---
+
+/**
+ * @brief Conteúdo de um arquivo só para leitura: mapeado com mmap (as
+ * páginas vêm do disco sob demanda, sem cópia). Fora de sistemas POSIX,
+ * o arquivo é lido para a memória.
+ */
+class ArquivoMapeado {
+private:
+    const char* inicio;
+    size_t bytes;
+#ifdef _WIN32
+    vector<char> copia;
+#else
+    void* mapa;
+#endif
+
+public:
+    explicit ArquivoMapeado(const string& caminho) : inicio(nullptr), bytes(0) {
+#ifdef _WIN32
+        ifstream entrada(caminho, ios::binary);
+        if (!entrada) {
+            throw runtime_error("Erro: nao foi possivel abrir " + caminho);
+        }
+        copia.assign(istreambuf_iterator<char>(entrada), istreambuf_iterator<char>());
+        inicio = copia.data();
+        bytes = copia.size();
+#else
+        mapa = nullptr;
+        int fd = open(caminho.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Erro: nao foi possivel abrir " + caminho);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw runtime_error("Erro: nao foi possivel ler " + caminho);
+        }
+        bytes = (size_t)info.st_size;
+        if (bytes > 0) {
+            mapa = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapa == MAP_FAILED) {
+                close(fd);
+                throw runtime_error("Erro: falha no mmap de " + caminho);
+            }
+            madvise(mapa, bytes, MADV_SEQUENTIAL);
+            inicio = static_cast<const char*>(mapa);
+        }
+        close(fd); // O mapeamento continua válido sem o descritor
+#endif
+    }
+
+    ~ArquivoMapeado() {
+#ifndef _WIN32
+        if (mapa != nullptr) munmap(mapa, bytes);
+#endif
+    }
+
+    // Dono do mapeamento: não pode ser copiado.
+    ArquivoMapeado(const ArquivoMapeado&) = delete;
+    ArquivoMapeado& operator=(const ArquivoMapeado&) = delete;
 
-                // Copia os dados do sucessor para este nó
-                no->nome = temp->nome;
-                no->sexo = temp->sexo;
-                no->idade = temp->idade;
-                no->peso = temp->peso;
+    const char* dados() const { return inicio; }
+    size_t tamanho() const { return bytes; }
+};
+
+/**
+ * @brief Uma linha válida do arquivo. O nome aponta para dentro do
+ * arquivo mapeado (só é copiado para a arena se for importado).
+ */
+struct PessoaImportada {
+    string_view nome;
+    uint64_t prefixo;
+    char sexo;
+    int idade;
+    double peso;
+    size_t linha; // Número da linha no arquivo (a partir de 1)
+};
+
+// Ordem da importação: por nome e, para nomes repetidos, pela linha (a
+// primeira ocorrência no arquivo vence).
+bool antesNaImportacao(const PessoaImportada& a, const PessoaImportada& b) {
+    if (a.prefixo != b.prefixo) return a.prefixo < b.prefixo;
+    int c = a.nome.compare(b.nome);
+    if (c != 0) return c < 0;
+    return a.linha < b.linha;
+}
+
+/**
+ * @brief Resultado de uma importação: contagens, as primeiras linhas de
+ * cada problema (para o usuário achá-las no arquivo) e os tempos.
+ */
+struct ResumoImportacao {
+    static const size_t MAX_EXEMPLOS = 5;
+
+    size_t linhas;      // Linhas de dados lidas (sem cabeçalho e linhas vazias)
+    size_t importadas;
+    size_t invalidas;   // Falharam na validação
+    size_t duplicadas;  // Nome repetido no arquivo ou já cadastrado
+    vector<size_t> exemplosInvalidas, exemplosDuplicadas;
+    unsigned threads;
+    double msLeitura;    // Mapear, ler e validar
+    double msOrdenacao;  // Ordenar por nome
+    double msConstrucao; // Criar os nós e montar a árvore
+};
+
+/**
+ * @brief Valida sexo, idade e peso em texto com as mesmas regras do menu
+ * (sexo M/F, maiúscula ou minúscula; idade inteira positiva; peso
+ * positivo) e os guarda em 'p'.
+ */
+bool lerCampos(string_view sexo, string_view idade, string_view peso, PessoaImportada& p) {
+    if (sexo.size() != 1) {
+        return false;
+    }
+    p.sexo = (char)toupper((unsigned char)sexo[0]);
+    if (p.sexo != 'M' && p.sexo != 'F') {
+        return false;
+    }
+    const char* fimIdade = idade.data() + idade.size();
+    from_chars_result r = from_chars(idade.data(), fimIdade, p.idade);
+    if (r.ec != errc() || r.ptr != fimIdade || p.idade <= 0) {
+        return false;
+    }
+    const char* fimPeso = peso.data() + peso.size();
+    r = from_chars(peso.data(), fimPeso, p.peso);
+    if (r.ec != errc() || r.ptr != fimPeso || !(p.peso > 0) || !isfinite(p.peso)) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Valida uma linha "nome;sexo;idade;peso" (';' = o separador) com
+ * as mesmas regras do menu: nome não vazio e os campos de lerCampos().
+ * Campos sem aspas.
+ */
+bool lerPessoa(const char* ini, const char* fim, char separador, PessoaImportada& p) {
+    const char* campos[5];
+    const char* finais[4];
+    int n = 0;
+    campos[0] = ini;
+    for (const char* c = ini; c < fim && n < 4; c++) {
+        if (*c == separador) {
+            finais[n++] = c;
+            campos[n] = c + 1;
+        }
+    }
+    if (n != 3) {
+        return false; // Faltam campos ou sobram separadores
+    }
+    finais[3] = fim;
+
+    p.nome = string_view(campos[0], finais[0] - campos[0]);
+    if (p.nome.empty()) {
+        return false;
+    }
+    p.prefixo = prefixoDoNome(p.nome);
+    return lerCampos(string_view(campos[1], finais[1] - campos[1]),
+                     string_view(campos[2], finais[2] - campos[2]),
+                     string_view(campos[3], finais[3] - campos[3]), p);
+}
+
+/**
+ * @brief Lê as linhas de [ini, fim) (que começa no início de uma linha),
+ * guardando as válidas e contando/anotando as inválidas. Números de
+ * linha são locais ao trecho (a partir de 1).
+ */
+struct TrechoImportado {
+    vector<PessoaImportada> pessoas;
+    size_t linhas;        // Todas as linhas do trecho, vazias inclusive
+    size_t dados;         // Linhas não vazias
+    size_t invalidas;
+    vector<size_t> exemplosInvalidas;
+};
+
+void lerTrecho(const char* ini, const char* fim, char separador, TrechoImportado& t) {
+    t.linhas = t.dados = t.invalidas = 0;
+    t.pessoas.reserve((fim - ini) / 24);
+    while (ini < fim) {
+        const char* quebra = static_cast<const char*>(memchr(ini, '\n', fim - ini));
+        const char* fimLinha = quebra ? quebra : fim;
+        t.linhas++;
+        const char* fimDados = fimLinha;
+        if (fimDados > ini && fimDados[-1] == '\r') fimDados--; // CRLF
+        if (fimDados > ini) {
+            t.dados++;
+            PessoaImportada p;
+            if (lerPessoa(ini, fimDados, separador, p)) {
+                p.linha = t.linhas;
+                t.pessoas.push_back(p);
+            } else {
+                t.invalidas++;
+                if (t.exemplosInvalidas.size() < ResumoImportacao::MAX_EXEMPLOS) {
+                    t.exemplosInvalidas.push_back(t.linhas);
+                }
+            }
+        }
+        ini = fimLinha + 1;
+    }
+}
+
+/**
+ * @brief Lê o arquivo inteiro em paralelo (um trecho por núcleo, cortado
+ * em quebras de linha) e devolve as pessoas válidas ordenadas por nome.
+ * Separador ',' (CSV) ou tab (TSV), escolhido pela primeira linha não
+ * vazia; se o primeiro campo da primeira linha for "nome", ela é o
+ * cabeçalho.
+ */
+vector<PessoaImportada> lerPessoasEmParalelo(const ArquivoMapeado& arquivo, ResumoImportacao& resumo) {
+    if (arquivo.tamanho() == 0) {
+        return vector<PessoaImportada>();
+    }
+    const char* ini = arquivo.dados();
+    const char* fim = ini + arquivo.tamanho();
+    size_t linhaInicial = 0;
+
+    const char* quebra = static_cast<const char*>(memchr(ini, '\n', fim - ini));
+    const char* fimPrimeira = quebra ? quebra : fim;
+    // Separador: tab se a primeira linha não vazia tiver um.
+    const char* amostra = ini;
+    while (amostra < fim && (*amostra == '\n' || *amostra == '\r')) amostra++;
+    const char* fimAmostra = static_cast<const char*>(memchr(amostra, '\n', fim - amostra));
+    if (fimAmostra == nullptr) fimAmostra = fim;
+    char separador = memchr(amostra, '\t', fimAmostra - amostra) ? '\t' : ',';
+    bool cabecalho = fimPrimeira - ini >= 5 && ini[4] == separador;
+    for (int k = 0; cabecalho && k < 4; k++) {
+        cabecalho = tolower((unsigned char)ini[k]) == "nome"[k];
+    }
+    if (cabecalho) {
+        ini = (fimPrimeira < fim) ? fimPrimeira + 1 : fim; // Pula o cabeçalho
+        linhaInicial = 1;
+    }
+
+    // Um trecho por núcleo, de pelo menos 1 MB.
+    unsigned nucleos = max(1u, thread::hardware_concurrency());
+    size_t partes = min<size_t>(nucleos, (size_t)(fim - ini) / (1 << 20) + 1);
+    vector<const char*> cortes(partes + 1);
+    cortes[0] = ini;
+    cortes[partes] = fim;
+    for (size_t i = 1; i < partes; i++) {
+        const char* c = ini + (fim - ini) * i / partes;
+        c = max(c, cortes[i - 1]);
+        const char* q = static_cast<const char*>(memchr(c, '\n', fim - c));
+        cortes[i] = q ? q + 1 : fim;
+    }
+
+    vector<TrechoImportado> trechos(partes);
+    vector<thread> threads;
+    for (size_t i = 1; i < partes; i++) {
+        threads.emplace_back([&, i] { lerTrecho(cortes[i], cortes[i + 1], separador, trechos[i]); });
+    }
+    lerTrecho(cortes[0], cortes[1], separador, trechos[0]);
+    for (thread& t : threads) t.join();
+    resumo.threads = (unsigned)partes;
+
+    // Junta os trechos, passando as linhas para a numeração do arquivo.
+    size_t total = 0;
+    for (const TrechoImportado& t : trechos) total += t.pessoas.size();
+    vector<PessoaImportada> pessoas;
+    pessoas.reserve(total);
+    vector<size_t> limites(1, 0);
+    size_t base = linhaInicial;
+    for (TrechoImportado& t : trechos) {
+        for (PessoaImportada& p : t.pessoas) {
+            p.linha += base;
+            pessoas.push_back(p);
+        }
+        limites.push_back(pessoas.size());
+        resumo.linhas += t.dados;
+        resumo.invalidas += t.invalidas;
+        for (size_t linha : t.exemplosInvalidas) {
+            if (resumo.exemplosInvalidas.size() < ResumoImportacao::MAX_EXEMPLOS) {
+                resumo.exemplosInvalidas.push_back(linha + base);
+            }
+        }
+        base += t.linhas;
+        vector<PessoaImportada>().swap(t.pessoas);
+    }
+
+    // Cada trecho é ordenado na sua thread; depois as fatias vizinhas
+    // são mescladas aos pares, também em paralelo.
+    auto inicioOrdenacao = chrono::steady_clock::now();
+    auto ordenar = [&pessoas, &limites](size_t i) {
+        sort(pessoas.begin() + limites[i], pessoas.begin() + limites[i + 1], antesNaImportacao);
+    };
+    threads.clear();
+    for (size_t i = 1; i < partes; i++) threads.emplace_back(ordenar, i);
+    ordenar(0);
+    for (thread& t : threads) t.join();
+    for (size_t largura = 1; largura < partes; largura *= 2) {
+        threads.clear();
+        for (size_t i = 0; i + largura < partes; i += 2 * largura) {
+            size_t meio = limites[i + largura];
+            size_t ate = limites[min(i + 2 * largura, partes)];
+            size_t de = limites[i];
+            threads.emplace_back([&pessoas, de, meio, ate] {
+                inplace_merge(pessoas.begin() + de, pessoas.begin() + meio, pessoas.begin() + ate,
+                              antesNaImportacao);
+            });
+        }
+        for (thread& t : threads) t.join();
+    }
+    resumo.msOrdenacao = chrono::duration<double, milli>(chrono::steady_clock::now() - inicioOrdenacao).count();
+    return pessoas;
+}
+
+// --- Diário de Escrita (WAL) com confirmação em grupo; só POSIX ---
+#ifndef _WIN32
+
+// FNV-1a de 32 bits (checksum de cada registro do diário).
+uint32_t fnv1a32(const char* dados, size_t n, uint32_t h = 2166136261u) {
+    for (size_t i = 0; i < n; i++) {
+        h = (h ^ (unsigned char)dados[i]) * 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief Cabeçalho de cada registro do diário, seguido dos bytes do nome.
+ * O checksum cobre o resto do cabeçalho e o nome: um registro cortado no
+ * meio (queda durante a escrita) é reconhecido e descartado.
+ */
+struct RegistroDiario {
+    uint32_t checksum;
+    uint32_t tamanhoNome;
+    uint8_t tipo; // INSERCAO ou REMOCAO
+    char sexo;
+    uint16_t reservado;
+    int32_t idade;
+    double peso;
+
+    static const uint8_t INSERCAO = 1;
+    static const uint8_t REMOCAO = 2;
+};
+
+/**
+ * @brief Diário só de acréscimos com as inserções e remoções da árvore.
+ *
+ * anotar*() só copia o registro para um buffer em memória e devolve a
+ * posição dele. confirmar(posicao) garante que tudo até ali está no disco:
+ * a primeira thread que chega grava o buffer inteiro com um write e um
+ * fdatasync, e as que chegam enquanto isso esperam e aproveitam a mesma
+ * sincronização (confirmação em grupo). As posições crescem sempre, mesmo
+ * quando o arquivo é trocado (ver Persistencia).
+ *
+ * Uma falha de write ou fdatasync é definitiva: os bytes podem ter ficado
+ * pela metade no arquivo, e um fdatasync repetido depois de um erro de
+ * escrita pode voltar 0 sem os dados. Daí em diante todo anotar*() e
+ * confirmar() lança runtime_error, inclusive nas threads que esperavam.
+ */
+class DiarioDeEscrita {
+private:
+    int fd;
+    mutex trava;
+    condition_variable gravou;
+    vector<char> pendente, gravando;
+    uint64_t anotado;      // Bytes anotados desde a abertura
+    uint64_t duravel;      // Bytes já sincronizados
+    uint64_t noArquivo;    // Tamanho do arquivo atual
+    uint64_t sincronizacoes;
+    bool gravandoAgora;
+    bool falhou;           // Uma gravação falhou: o diário não aceita mais nada
+
+    // Chamada com a trava presa.
+    void exigirSemFalha() const {
+        if (falhou) {
+            throw runtime_error("Erro: falha ao gravar o diario.");
+        }
+    }
+
+    uint64_t anotar(uint8_t tipo, string_view nome, char sexo, int idade, double peso) {
+        RegistroDiario r = {0, (uint32_t)nome.size(), tipo, sexo, 0, idade, peso};
+        const size_t cabecalho = sizeof(RegistroDiario);
+        lock_guard<mutex> guarda(trava);
+        exigirSemFalha();
+        size_t inicio = pendente.size();
+        pendente.resize(inicio + cabecalho + nome.size());
+        memcpy(pendente.data() + inicio, &r, cabecalho);
+        memcpy(pendente.data() + inicio + cabecalho, nome.data(), nome.size());
+        r.checksum = fnv1a32(pendente.data() + inicio + 4, cabecalho - 4 + nome.size());
+        memcpy(pendente.data() + inicio, &r.checksum, 4);
+        anotado += cabecalho + nome.size();
+        return anotado;
+    }
+
+public:
+    DiarioDeEscrita()
+        : fd(-1), anotado(0), duravel(0), noArquivo(0), sincronizacoes(0), gravandoAgora(false), falhou(false) {}
+
+    ~DiarioDeEscrita() {
+        if (fd >= 0) close(fd);
+    }
+
+    DiarioDeEscrita(const DiarioDeEscrita&) = delete;
+    DiarioDeEscrita& operator=(const DiarioDeEscrita&) = delete;
+
+    /**
+     * @brief Passa a acrescentar em 'caminho' (criado se não existe).
+     * O que estava anotado vai antes para o arquivo anterior.
+     */
+    void abrir(const string& caminho) {
+        confirmar(posicao());
+        unique_lock<mutex> guarda(trava);
+        gravou.wait(guarda, [this] { return !gravandoAgora; });
+        exigirSemFalha();
+        int novo = open(caminho.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (novo < 0) {
+            throw runtime_error("Erro: nao foi possivel abrir o diario " + caminho);
+        }
+        struct stat info;
+        fstat(novo, &info);
+        if (fd >= 0) close(fd);
+        fd = novo;
+        noArquivo = (uint64_t)info.st_size;
+    }
+
+    uint64_t anotarInsercao(string_view nome, char sexo, int idade, double peso) {
+        return anotar(RegistroDiario::INSERCAO, nome, sexo, idade, peso);
+    }
+
+    uint64_t anotarRemocao(string_view nome) {
+        return anotar(RegistroDiario::REMOCAO, nome, 0, 0, 0.0);
+    }
+
+    // Posição depois do último registro anotado.
+    uint64_t posicao() {
+        lock_guard<mutex> guarda(trava);
+        return anotado;
+    }
+
+    /**
+     * @brief Volta só quando tudo até 'ate' estiver no disco. Lança
+     * runtime_error se a escrita ou a sincronização falhar (agora ou
+     * em qualquer confirmação anterior).
+     */
+    void confirmar(uint64_t ate) {
+        unique_lock<mutex> guarda(trava);
+        exigirSemFalha();
+        while (duravel < ate) {
+            if (gravandoAgora) {
+                gravou.wait(guarda); // Outra thread está gravando: aproveita a vez dela
+                exigirSemFalha();
+                continue;
+            }
+            gravandoAgora = true;
+            pendente.swap(gravando);
+            uint64_t alvo = anotado;
+            guarda.unlock();
+
+            bool ok = true;
+            for (size_t feito = 0; ok && feito < gravando.size();) {
+                ssize_t n = write(fd, gravando.data() + feito, gravando.size() - feito);
+                if (n < 0 && errno == EINTR) continue;
+                ok = n > 0;
+                if (ok) feito += (size_t)n;
+            }
+#ifdef __APPLE__
+            ok = ok && fsync(fd) == 0;
+#else
+            ok = ok && fdatasync(fd) == 0;
+#endif
+            guarda.lock();
+            gravandoAgora = false;
+            falhou = !ok;
+            gravou.notify_all();
+            exigirSemFalha();
+            noArquivo += gravando.size();
+            gravando.clear();
+            duravel = alvo;
+            sincronizacoes++;
+        }
+    }
+
+    // Bytes no arquivo atual (para decidir quando tirar um snapshot).
+    uint64_t tamanhoDoArquivo() {
+        lock_guard<mutex> guarda(trava);
+        return noArquivo + pendente.size();
+    }
+
+    uint64_t totalDeSincronizacoes() {
+        lock_guard<mutex> guarda(trava);
+        return sincronizacoes;
+    }
+};
+
+#endif // _WIN32
+
+class ArvoreAVL {
+private:
+    NoArvore* raiz;
+    ArenaDeNomes nomes;     // Todos os nomes, guardados uma vez
+    ColunasPessoas colunas; // sexo/idade/peso em arrays, para varreduras
+    TabelaDeNomes porNome;  // nome -> nó, para consultas exatas
+    IndiceSecundario<int, &NoArvore::idade> indiceIdade;   // Opcional
+    IndiceSecundario<double, &NoArvore::peso> indicePeso;  // Opcional
+    bool indexarIdade, indexarPeso;
+    bool mensagens; // Imprime avisos de duplicata/remoção (desligado no comparativo)
+#ifndef _WIN32
+    DiarioDeEscrita* diario; // Se houver, recebe cada inserção/remoção
+#endif
+
+    // --- Funções Auxiliares de Balanceamento (Núcleo do AVL) ---
+
+    // Retorna a altura de um nó (0 se for nulo)
+    int getAltura(NoArvore* no) {
+        if (no == nullptr) {
+            return 0;
+        }
+        return no->altura;
+    }
+
+    // A pessoa do nó sozinha, como SomaSubarvore
+    static SomaSubarvore somaDoNo(const NoArvore* no) {
+        return SomaSubarvore{1, no->sexo == 'M', no->sexo == 'F', no->idade, no->peso};
+    }
+
+    // Atualiza a altura e as somas de um nó com base em seus filhos
+    // (os filhos já devem estar atualizados)
+    void atualizarNo(NoArvore* no) {
+        if (no != nullptr) {
+            no->altura = 1 + max(getAltura(no->esquerda), getAltura(no->direita));
+            no->soma = somaDoNo(no);
+            if (no->esquerda) no->soma.somar(no->esquerda->soma);
+            if (no->direita) no->soma.somar(no->direita->soma);
+        }
+    }
+
+    // Calcula o Fator de Balanceamento
+    int getFatorBalanceamento(NoArvore* no) {
+        if (no == nullptr) {
+            return 0;
+        }
+        // Altura da Esquerda - Altura da Direita
+        return getAltura(no->esquerda) - getAltura(no->direita);
+    }
+
+    // Rotação Simples à Direita (Caso Esquerda-Esquerda)
+    NoArvore* rotacaoDireita(NoArvore* y) {
+        NoArvore* x = y->esquerda;
+        NoArvore* T2 = x->direita;
+
+        // Realiza a rotação
+        x->direita = y;
+        y->esquerda = T2;
+
+        // Atualiza alturas e somas (IMPORTANTE: primeiro 'y', depois 'x')
+        atualizarNo(y);
+        atualizarNo(x);
+
+        // Retorna a nova raiz da sub-árvore
+        return x;
+    }
+
+    // Rotação Simples à Esquerda (Caso Direita-Direita)
+    NoArvore* rotacaoEsquerda(NoArvore* x) {
+        NoArvore* y = x->direita;
+        NoArvore* T2 = y->esquerda;
+
+        // Realiza a rotação
+        y->esquerda = x;
+        x->direita = T2;
+
+        // Atualiza alturas e somas (IMPORTANTE: primeiro 'x', depois 'y')
+        atualizarNo(x);
+        atualizarNo(y);
+
+        // Retorna a nova raiz da sub-árvore
+        return y;
+    }
+
+    // Encontra o nó com o menor valor (mais à esquerda)
+    NoArvore* encontrarMinimo(NoArvore* no) {
+        NoArvore* atual = no;
+        while (atual->esquerda != nullptr) {
+            atual = atual->esquerda;
+        }
+        return atual;
+    }
+
+
+    // --- F1: Inserção (Recursiva com Balanceamento) ---
+    NoArvore* _inserir(NoArvore* no, string_view nome, uint64_t prefixo, char sexo, int idade, double peso) {
+        // 1. Inserção padrão de BST
+        if (no == nullptr) {
+            NoArvore* novo = new NoArvore(nomes.guardar(nome), prefixo, sexo, idade, peso);
+            novo->linha = colunas.adicionar(sexo, idade, peso);
+            porNome.inserir(novo, hashDoNome(nome));
+            if (indexarIdade) indiceIdade.inserir(novo);
+            if (indexarPeso) indicePeso.inserir(novo);
+            return novo;
+        }
+
+        int c = compararNome(nome, prefixo, no);
+        if (c < 0) {
+            no->esquerda = _inserir(no->esquerda, nome, prefixo, sexo, idade, peso);
+        } else if (c > 0) {
+            no->direita = _inserir(no->direita, nome, prefixo, sexo, idade, peso);
+        } else {
+            // Nomes duplicados não são permitidos (ou podem ser tratados)
+            if (mensagens) cout << "Erro: Nome '" << nome << "' ja existe." << endl;
+            return no;
+        }
+
+        // 2. Atualizar a altura e as somas do nó atual
+        atualizarNo(no);
+
+        // 3. Obter o fator de balanceamento
+        int fator = getFatorBalanceamento(no);
+
+        // 4. Rebalancear a árvore (Os 4 casos)
+
+        // Caso Esquerda-Esquerda (LL)
+        if (fator > 1 && compararNome(nome, prefixo, no->esquerda) < 0) {
+            return rotacaoDireita(no);
+        }
+
+        // Caso Direita-Direita (RR)
+        if (fator < -1 && compararNome(nome, prefixo, no->direita) > 0) {
+            return rotacaoEsquerda(no);
+        }
+
+        // Caso Esquerda-Direita (LR)
+        if (fator > 1 && compararNome(nome, prefixo, no->esquerda) > 0) {
+            no->esquerda = rotacaoEsquerda(no->esquerda);
+            return rotacaoDireita(no);
+        }
+
+        // Caso Direita-Esquerda (RL)
+        if (fator < -1 && compararNome(nome, prefixo, no->direita) < 0) {
+            no->direita = rotacaoDireita(no->direita);
+            return rotacaoEsquerda(no);
+        }
+
+        // Retorna o nó (potencialmente balanceado)
+        return no;
+    }
+
+    // --- F2: Listagem (Recursiva - Em-Ordem) ---
+    // Percurso Em-Ordem (LNR) resulta em listagem alfabética
+    void _listarEmOrdem(NoArvore* no) {
+        if (no == nullptr) {
+            return;
+        }
+        _listarEmOrdem(no->esquerda);
+        cout << "  - Nome: " << no->nome 
+             << " (Sexo: " << no->sexo 
+             << ", Idade: " << no->idade 
+             << ", Peso: " << no->peso << ")" << endl;
+        _listarEmOrdem(no->direita);
+    }
+
+    // Recalcula altura e somas e aplica a rotação necessária (os 4 casos),
+    // olhando só para as alturas dos filhos.
+    NoArvore* balancear(NoArvore* no) {
+        // 1. Atualizar a altura e as somas
+        atualizarNo(no);
+
+        // 2. Obter o fator de balanceamento
+        int fator = getFatorBalanceamento(no);
+
+        // 3. Rebalancear
+
+        // Caso Esquerda-Esquerda (LL)
+        if (fator > 1 && getFatorBalanceamento(no->esquerda) >= 0) {
+            return rotacaoDireita(no);
+        }
+
+        // Caso Esquerda-Direita (LR)
+        if (fator > 1 && getFatorBalanceamento(no->esquerda) < 0) {
+            no->esquerda = rotacaoEsquerda(no->esquerda);
+            return rotacaoDireita(no);
+        }
+
+        // Caso Direita-Direita (RR)
+        if (fator < -1 && getFatorBalanceamento(no->direita) <= 0) {
+            return rotacaoEsquerda(no);
+        }
+
+        // Caso Direita-Esquerda (RL)
+        if (fator < -1 && getFatorBalanceamento(no->direita) > 0) {
+            no->direita = rotacaoDireita(no->direita);
+            return rotacaoEsquerda(no);
+        }
+
+        return no;
+    }
+
+    // Desliga o menor nó da sub-árvore (devolvido em 'minimo'),
+    // rebalanceando o caminho.
+    NoArvore* _removerMinimo(NoArvore* no, NoArvore*& minimo) {
+        if (no->esquerda == nullptr) {
+            minimo = no;
+            return no->direita;
+        }
+        no->esquerda = _removerMinimo(no->esquerda, minimo);
+        return balancear(no);
+    }
+
+    // Tira a pessoa das colunas e dos índices e libera o nó.
+    void _descartar(NoArvore* no) {
+        colunas.remover(no->linha);
+        porNome.remover(no, hashDoNome(no->nome));
+        if (indexarIdade) indiceIdade.remover(no);
+        if (indexarPeso) indicePeso.remover(no);
+        delete no;
+    }
+
+    template <typename Visitante>
+    static void _visitarEmOrdem(const NoArvore* no, Visitante& visitar) {
+        if (no == nullptr) {
+            return;
+        }
+        _visitarEmOrdem(no->esquerda, visitar);
+        visitar(no);
+        _visitarEmOrdem(no->direita, visitar);
+    }
+
+    template <typename Visitante>
+    static void _visitarIntervalo(const NoArvore* no, string_view de, uint64_t prefixoDe,
+                                  string_view ate, uint64_t prefixoAte, Visitante& visitar) {
+        while (no != nullptr) {
+            if (compararNome(de, prefixoDe, no) > 0) {
+                no = no->direita;
+            } else if (compararNome(ate, prefixoAte, no) < 0) {
+                no = no->esquerda;
+            } else {
+                _visitarIntervalo(no->esquerda, de, prefixoDe, ate, prefixoAte, visitar);
+                visitar(no);
+                no = no->direita;
+            }
+        }
+    }
+
+    // --- Busca por prefixo (autocompletar) ---
+    // A altura de uma AVL é < 1,45 log2(n + 2): 64 níveis passam de 2^44
+    // nós, então a pilha do percurso cabe num array fixo.
+    static const int MAX_NIVEIS = 64;
+
+    // Desce até o primeiro nome >= prefixo guardando na pilha os nós em que
+    // virou à esquerda (os que ainda faltam visitar, o menor no topo); daí
+    // segue de sucessor em sucessor até k nomes ou até sair do prefixo.
+    // O(log n + k), sem alocar.
+    template <typename Visitante>
+    size_t _visitarPrefixo(string_view prefixo, size_t k, Visitante& visitar) const {
+        const NoArvore* pilha[MAX_NIVEIS];
+        int topo = 0;
+        uint64_t chave = prefixoDoNome(prefixo);
+        for (const NoArvore* no = raiz; no != nullptr;) {
+            if (compararNome(prefixo, chave, no) <= 0) {
+                pilha[topo++] = no;
+                no = no->esquerda;
+            } else {
+                no = no->direita;
+            }
+        }
+        size_t visitados = 0;
+        while (topo > 0 && visitados < k) {
+            const NoArvore* no = pilha[--topo];
+            if (!comecaCom(no, prefixo, chave)) {
+                break; // Passou do último nome com o prefixo
+            }
+            visitar(no);
+            visitados++;
+            for (no = no->direita; no != nullptr; no = no->esquerda) pilha[topo++] = no;
+        }
+        return visitados;
+    }
+
+    // --- F3: Remoção (Recursiva com Balanceamento) ---
+    // O nó removido sai inteiro e o sucessor é religado no lugar dele:
+    // nenhum outro nó muda de conteúdo, então um NoArvore* continua
+    // apontando para a mesma pessoa até ela ser removida (é o que os
+    // índices secundários guardam).
+    NoArvore* _remover(NoArvore* no, string_view nome, uint64_t prefixo) {
+        // 1. Remoção padrão de BST
+        if (no == nullptr) {
+            if (mensagens) cout << "Erro: Nome '" << nome << "' nao encontrado." << endl;
+            return no;
+        }
+
+        int c = compararNome(nome, prefixo, no);
+        if (c < 0) {
+            no->esquerda = _remover(no->esquerda, nome, prefixo);
+        } else if (c > 0) {
+            no->direita = _remover(no->direita, nome, prefixo);
+        } else {
+            // Nó encontrado!
+            NoArvore* alvo = no;
+            if (no->esquerda == nullptr || no->direita == nullptr) {
+                // Caso 1: Nó sem filhos ou com um filho (o filho sobe)
+                no = no->esquerda ? no->esquerda : no->direita;
+            } else {
+                // Caso 2: Nó com dois filhos
+                // O sucessor em-ordem (menor da sub-árvore direita) é
+                // desligado de lá e assume os filhos do nó removido
+                NoArvore* sucessor = nullptr;
+                NoArvore* direita = _removerMinimo(no->direita, sucessor);
+                sucessor->esquerda = no->esquerda;
+                sucessor->direita = direita;
+                no = sucessor;
+            }
+            if (mensagens) cout << "Info: Nome '" << nome << "' removido." << endl;
+            _descartar(alvo);
+        }
+
+        // Se a árvore ficou vazia (após remover o único nó)
+        if (no == nullptr) {
+            return no;
+        }
+
+        // 2. Atualizar altura e somas e rebalancear
+        return balancear(no);
+    }
+
+    // --- F4: Consulta (pela tabela de hash) ---
+    NoArvore* _consultar(string_view nome) const {
+        return porNome.encontrar(nome, prefixoDoNome(nome), hashDoNome(nome));
+    }
+
+    // Consulta descendo a árvore (Iterativa, sem alocação): uma comparação
+    // de três vias por nível; na maioria dos níveis ela se resolve só com
+    // os prefixos.
+    NoArvore* _consultarNaArvore(string_view nome) const {
+        uint64_t prefixo = prefixoDoNome(nome);
+        NoArvore* no = raiz;
+        while (no != nullptr) {
+            int c = compararNome(nome, prefixo, no);
+            if (c == 0) {
+                return no; // Encontrado
+            }
+            no = (c < 0) ? no->esquerda : no->direita;
+        }
+        return nullptr; // Não encontrado
+    }
+
+    // --- Faixas de nomes pelas somas das sub-árvores ---
+    // Desce até o primeiro nó dentro de [de, ate]; daí, pela borda
+    // esquerda soma cada nó >= de com a sub-árvore direita inteira dele,
+    // e pela borda direita cada nó <= ate com a sub-árvore esquerda.
+    // Visita O(log n) nós.
+    SomaSubarvore _agregarNomes(string_view de, string_view ate) const {
+        SomaSubarvore r = {0, 0, 0, 0, 0.0};
+        uint64_t prefixoDe = prefixoDoNome(de), prefixoAte = prefixoDoNome(ate);
+        const NoArvore* divisao = raiz;
+        while (divisao != nullptr) {
+            if (compararNome(de, prefixoDe, divisao) > 0) {
+                divisao = divisao->direita;
+            } else if (compararNome(ate, prefixoAte, divisao) < 0) {
+                divisao = divisao->esquerda;
+            } else {
+                break;
+            }
+        }
+        if (divisao == nullptr) {
+            return r; // Nenhum nome na faixa
+        }
+        r.somar(somaDoNo(divisao));
+        for (const NoArvore* no = divisao->esquerda; no != nullptr;) {
+            if (compararNome(de, prefixoDe, no) <= 0) {
+                r.somar(somaDoNo(no));
+                if (no->direita) r.somar(no->direita->soma);
+                no = no->esquerda;
+            } else {
+                no = no->direita;
+            }
+        }
+        for (const NoArvore* no = divisao->direita; no != nullptr;) {
+            if (compararNome(ate, prefixoAte, no) >= 0) {
+                r.somar(somaDoNo(no));
+                if (no->esquerda) r.somar(no->esquerda->soma);
+                no = no->direita;
+            } else {
+                no = no->esquerda;
+            }
+        }
+        return r;
+    }
+
+    // A mesma faixa percorrendo a árvore inteira em ordem (referência
+    // para o comparativo).
+    void _agregarNomesPercorrendo(const NoArvore* no, string_view de, string_view ate,
+                                  SomaSubarvore& r) const {
+        if (no == nullptr) {
+            return;
+        }
+        _agregarNomesPercorrendo(no->esquerda, de, ate, r);
+        if (no->nome >= de && no->nome <= ate) {
+            r.somar(somaDoNo(no));
+        }
+        _agregarNomesPercorrendo(no->direita, de, ate, r);
+    }
+
+    // --- Construção em lote (importação) ---
+    // Todos os nós da sub-árvore, em ordem alfabética.
+    void _coletar(NoArvore* no, vector<NoArvore*>& saida) {
+        if (no == nullptr) {
+            return;
+        }
+        _coletar(no->esquerda, saida);
+        saida.push_back(no);
+        _coletar(no->direita, saida);
+    }
+
+    // Árvore perfeitamente balanceada com os nós [de, ate) já ordenados:
+    // o do meio é a raiz. O(n), sem comparações nem rotações.
+    NoArvore* _construirBalanceada(const vector<NoArvore*>& nos, size_t de, size_t ate) {
+        if (de >= ate) {
+            return nullptr;
+        }
+        size_t meio = de + (ate - de) / 2;
+        NoArvore* no = nos[meio];
+        no->esquerda = _construirBalanceada(nos, de, meio);
+        no->direita = _construirBalanceada(nos, meio + 1, ate);
+        atualizarNo(no);
+        return no;
+    }
+
+    // --- Varredura pela árvore (referência para as colunas) ---
+    void _agregar(NoArvore* no, const FiltroPessoas& f, AgregadoPessoas& r) {
+        if (no == nullptr) {
+            return;
+        }
+        _agregar(no->esquerda, f, r);
+        if ((f.sexo == 0 || no->sexo == f.sexo) && no->idade >= f.idadeMin &&
+            no->idade <= f.idadeMax && no->peso >= f.pesoMin && no->peso <= f.pesoMax) {
+            r.contagem++;
+            r.somaIdade += no->idade;
+            r.minIdade = min(r.minIdade, no->idade);
+            r.maxIdade = max(r.maxIdade, no->idade);
+            r.somaPeso += no->peso;
+            r.minPeso = min(r.minPeso, no->peso);
+            r.maxPeso = max(r.maxPeso, no->peso);
+        }
+        _agregar(no->direita, f, r);
+    }
+
+    // Coloca no índice todas as pessoas da sub-árvore.
+    template <typename Indice>
+    void _indexar(const NoArvore* no, Indice* indice) {
+        if (no == nullptr) {
+            return;
+        }
+        _indexar(no->esquerda, indice);
+        indice->inserir(no);
+        _indexar(no->direita, indice);
+    }
+
+    // --- Destrutor Auxiliar ---
+    void _destruir(NoArvore* no) {
+        if (no != nullptr) {
+            _destruir(no->esquerda);
+            _destruir(no->direita);
+            delete no;
+        }
+    }
+
+
+public:
+    // Construtor
+    ArvoreAVL() : raiz(nullptr), indexarIdade(false), indexarPeso(false), mensagens(true) {
+#ifndef _WIN32
+        diario = nullptr;
+#endif
+    }
+
+    // Destrutor
+    ~ArvoreAVL() {
+        _destruir(raiz);
+    }
+
+    // F1: Interface pública de Inserção (false se o nome já existe)
+    bool inserir(string_view nome, char sexo, int idade, double peso) {
+        uint64_t prefixo = prefixoDoNome(nome);
+        // Duplicata: a tabela responde sem descer a árvore
+        if (porNome.encontrar(nome, prefixo, hashDoNome(nome)) != nullptr) {
+            if (mensagens) cout << "Erro: Nome '" << nome << "' ja existe." << endl;
+            return false;
+        }
+#ifndef _WIN32
+        // Anota antes de mudar a árvore: se o diário falhou, nada muda
+        if (diario != nullptr) diario->anotarInsercao(nome, sexo, idade, peso);
+#endif
+        raiz = _inserir(raiz, nome, prefixo, sexo, idade, peso);
+        return true;
+    }
+
+    // F2: Interface pública de Listagem (Em-Ordem)
+    void listarEmOrdem() {
+        if (raiz == nullptr) {
+            cout << "A arvore esta vazia." << endl;
+        } else {
+            cout << "--- Listagem Em-Ordem (Alfabetica) ---" << endl;
+            _listarEmOrdem(raiz);
+            cout << "---------------------------------------" << endl;
+        }
+    }
+
+    // F3: Interface pública de Remoção (false se o nome não existe)
+    bool remover(string_view nome) {
+        // Nome ausente: a tabela responde sem descer a árvore
+        if (_consultar(nome) == nullptr) {
+            if (mensagens) cout << "Erro: Nome '" << nome << "' nao encontrado." << endl;
+            return false;
+        }
+#ifndef _WIN32
+        if (diario != nullptr) diario->anotarRemocao(nome);
+#endif
+        raiz = _remover(raiz, nome, prefixoDoNome(nome));
+        return true;
+    }
+
+    /**
+     * @brief Importa pessoas de um arquivo CSV ou TSV (nome,sexo,idade,peso)
+     * mapeado na memória: lê e valida as linhas em paralelo, ordena por
+     * nome, mescla com as pessoas já cadastradas e reconstrói a árvore
+     * perfeitamente balanceada em tempo linear. Linhas inválidas e nomes
+     * repetidos (no arquivo ou já cadastrados) não entram e são só
+     * contados no resumo. Com diário ligado, nomes com tab também são
+     * inválidos (os snapshots são TSV). Lança runtime_error se o arquivo
+     * não abrir ou se o diário falhar (neste caso depois de montar a
+     * árvore, que continua consistente).
+     */
+    ResumoImportacao importar(const string& caminho) {
+        ResumoImportacao resumo = {0, 0, 0, 0, {}, {}, 1, 0.0, 0.0, 0.0};
+        auto t0 = chrono::steady_clock::now();
+        ArquivoMapeado arquivo(caminho);
+        vector<PessoaImportada> pessoas = lerPessoasEmParalelo(arquivo, resumo);
+        auto t1 = chrono::steady_clock::now();
+
+        // Mescla com os nós atuais (em ordem), descartando repetidos, e
+        // monta a árvore nova com todos.
+        vector<NoArvore*> atuais;
+        atuais.reserve(tamanho());
+        _coletar(raiz, atuais);
+        vector<NoArvore*> nos;
+        nos.reserve(atuais.size() + pessoas.size());
+        porNome.reservar(atuais.size() + pessoas.size());
+        size_t a = 0;
+        const PessoaImportada* anterior = nullptr;
+        string falhaDiario;
+        for (const PessoaImportada& p : pessoas) {
+#ifndef _WIN32
+            if (diario != nullptr && p.nome.find('\t') != string_view::npos) {
+                resumo.invalidas++;
+                if (resumo.exemplosInvalidas.size() < ResumoImportacao::MAX_EXEMPLOS) {
+                    resumo.exemplosInvalidas.push_back(p.linha);
+                }
+                continue;
+            }
+#endif
+            int c = -1;
+            while (a < atuais.size() && (c = compararNome(p.nome, p.prefixo, atuais[a])) > 0) {
+                nos.push_back(atuais[a++]);
+            }
+            if (a == atuais.size()) c = -1;
+            if (c == 0 || (anterior != nullptr && anterior->nome == p.nome)) {
+                resumo.duplicadas++;
+                if (resumo.exemplosDuplicadas.size() < ResumoImportacao::MAX_EXEMPLOS) {
+                    resumo.exemplosDuplicadas.push_back(p.linha);
+                }
+                continue;
+            }
+            NoArvore* novo = new NoArvore(nomes.guardar(p.nome), p.prefixo, p.sexo, p.idade, p.peso);
+            novo->linha = colunas.adicionar(p.sexo, p.idade, p.peso);
+            porNome.inserir(novo, hashDoNome(p.nome));
+            if (indexarIdade) indiceIdade.inserir(novo);
+            if (indexarPeso) indicePeso.inserir(novo);
+#ifndef _WIN32
+            if (diario != nullptr && falhaDiario.empty()) {
+                try {
+                    diario->anotarInsercao(p.nome, p.sexo, p.idade, p.peso);
+                } catch (const exception& e) {
+                    falhaDiario = e.what(); // Termina a árvore e só então lança
+                }
+            }
+#endif
+            nos.push_back(novo);
+            anterior = &p;
+            resumo.importadas++;
+        }
+        while (a < atuais.size()) nos.push_back(atuais[a++]);
+        sort(resumo.exemplosInvalidas.begin(), resumo.exemplosInvalidas.end());
+        sort(resumo.exemplosDuplicadas.begin(), resumo.exemplosDuplicadas.end());
+        raiz = _construirBalanceada(nos, 0, nos.size());
+        if (!falhaDiario.empty()) {
+            throw runtime_error(falhaDiario);
+        }
+        auto t3 = chrono::steady_clock::now();
+
+        resumo.msLeitura = chrono::duration<double, milli>(t1 - t0).count() - resumo.msOrdenacao;
+        resumo.msConstrucao = chrono::duration<double, milli>(t3 - t1).count();
+        return resumo;
+    }
+
+    /**
+     * @brief Liga/desliga os índices secundários por idade e por peso.
+     * Um índice ligado agora é montado com as pessoas já cadastradas e
+     * daí em diante acompanha inserir/remover; desligar libera a memória.
+     */
+    void ativarIndices(bool idade, bool peso) {
+        if (idade && !indexarIdade) _indexar(raiz, &indiceIdade);
+        if (peso && !indexarPeso) _indexar(raiz, &indicePeso);
+        if (!idade) indiceIdade.limpar();
+        if (!peso) indicePeso.limpar();
+        indexarIdade = idade;
+        indexarPeso = peso;
+    }
+
+    /**
+     * @brief Pessoas com idade em [lo, hi], em ordem de idade (desempate
+     * sem ordem definida). O(log n + k); exige o índice de idade ligado.
+     * Os ponteiros valem até a pessoa ser removida.
+     */
+    vector<const NoArvore*> porIdade(int lo, int hi) const {
+        if (!indexarIdade) throw runtime_error("Erro: indice de idade desligado (ativarIndices)");
+        vector<const NoArvore*> saida;
+        indiceIdade.intervalo(lo, hi, saida);
+        return saida;
+    }
+
+    // Idem, para peso em [lo, hi]; exige o índice de peso ligado.
+    vector<const NoArvore*> porPeso(double lo, double hi) const {
+        if (!indexarPeso) throw runtime_error("Erro: indice de peso desligado (ativarIndices)");
+        vector<const NoArvore*> saida;
+        indicePeso.intervalo(lo, hi, saida);
+        return saida;
+    }
+
+    // Estatísticas das pessoas que passam no filtro (varredura colunar).
+    AgregadoPessoas agregar(const FiltroPessoas& filtro) const {
+        return colunas.agregar(filtro);
+    }
+
+    // Mesmo resultado de agregar(), percorrendo a árvore nó a nó
+    // (referência para o comparativo).
+    AgregadoPessoas agregarPercorrendo(const FiltroPessoas& filtro) {
+        AgregadoPessoas r = {0, 0, INT_MAX, INT_MIN, 0.0, HUGE_VAL, -HUGE_VAL};
+        _agregar(raiz, filtro, r);
+        return r;
+    }
+
+    /**
+     * @brief Contagem (total e por sexo) e somas de idade e peso das
+     * pessoas com nome em [de, ate] (intervalo fechado, ordem dos bytes),
+     * em O(log n) pelas somas das sub-árvores.
+     */
+    SomaSubarvore agregarNomes(string_view de, string_view ate) const {
+        return _agregarNomes(de, ate);
+    }
+
+    // Mesmo resultado de agregarNomes(), percorrendo todos os nós.
+    SomaSubarvore agregarNomesPercorrendo(string_view de, string_view ate) const {
+        SomaSubarvore r = {0, 0, 0, 0, 0.0};
+        _agregarNomesPercorrendo(raiz, de, ate, r);
+        return r;
+    }
+
+    /**
+     * @brief A k-ésima pessoa em ordem alfabética (k a partir de 1), ou
+     * nullptr se k > tamanho(). O(log n) pelas contagens das sub-árvores.
+     */
+    const NoArvore* kEsimo(size_t k) const {
+        const NoArvore* no = raiz;
+        while (no != nullptr) {
+            size_t aEsquerda = no->esquerda ? no->esquerda->soma.contagem : 0;
+            if (k <= aEsquerda) {
+                no = no->esquerda;
+            } else if (k == aEsquerda + 1) {
+                return no;
+            } else {
+                k -= aEsquerda + 1;
+                no = no->direita;
+            }
+        }
+        return nullptr;
+    }
+
+    // Número de pessoas cadastradas.
+    size_t tamanho() const {
+        return raiz ? raiz->soma.contagem : 0;
+    }
+
+#ifndef _WIN32
+    // Passa a anotar cada inserção/remoção em 'd' (nullptr desliga). Quem
+    // chama decide quando confirmar o diário.
+    void definirDiario(DiarioDeEscrita* d) {
+        diario = d;
+    }
+#endif
+
+    // Liga/desliga os avisos impressos por inserir/remover (devolve o
+    // estado anterior).
+    bool definirMensagens(bool ativas) {
+        bool antes = mensagens;
+        mensagens = ativas;
+        return antes;
+    }
+
+    // Altura da árvore (0 se vazia).
+    int altura() {
+        return getAltura(raiz);
+    }
+
+    // Consulta sem imprimir: o nome está na árvore?
+    bool contem(string_view nome) const {
+        return _consultar(nome) != nullptr;
+    }
+
+    // Consulta sem imprimir: a pessoa com este nome, ou nullptr. O
+    // ponteiro vale até ela ser removida.
+    const NoArvore* buscar(string_view nome) const {
+        return _consultar(nome);
+    }
+
+    // Chama visitar(const NoArvore*) para cada pessoa, em ordem alfabética.
+    template <typename Visitante>
+    void visitarEmOrdem(Visitante&& visitar) const {
+        _visitarEmOrdem(raiz, visitar);
+    }
+
+    // Chama visitar(const NoArvore*) para cada pessoa com nome em
+    // [de, ate], em ordem alfabética: O(log n + k).
+    template <typename Visitante>
+    void visitarIntervalo(string_view de, string_view ate, Visitante&& visitar) const {
+        _visitarIntervalo(raiz, de, prefixoDoNome(de), ate, prefixoDoNome(ate), visitar);
+    }
+
+    /**
+     * @brief Chama visitar(const NoArvore*) para os k primeiros nomes (em
+     * ordem alfabética) que começam com 'prefixo' e devolve quantos foram.
+     * O(log n + k) e sem alocação: serve para autocompletar a cada tecla.
+     */
+    template <typename Visitante>
+    size_t visitarPrefixo(string_view prefixo, size_t k, Visitante&& visitar) const {
+        return _visitarPrefixo(prefixo, k, visitar);
+    }
+
+    // Os k primeiros nomes com o prefixo, como lista (menu).
+    vector<const NoArvore*> completar(string_view prefixo, size_t k) const {
+        vector<const NoArvore*> encontrados;
+        visitarPrefixo(prefixo, k, [&encontrados](const NoArvore* no) { encontrados.push_back(no); });
+        return encontrados;
+    }
+
+    // Mesma consulta, descendo a árvore em vez de usar a tabela
+    // (referência para o comparativo).
+    bool contemNaArvore(string_view nome) const {
+        return _consultarNaArvore(nome) != nullptr;
+    }
+
+    // Memória da tabela de hash por nome, em bytes.
+    size_t bytesTabelaNomes() const {
+        return porNome.bytesUsados();
+    }
+
+    // F4: Interface pública de Consulta
+    void consultar(string_view nome) {
+        NoArvore* resultado = _consultar(nome);
+        if (resultado != nullptr) {
+            cout << "--- Consulta Encontrada ---" << endl;
+            cout << "  Nome: " << resultado->nome << endl;
+            cout << "  Sexo: " << resultado->sexo << endl;
+            cout << "  Idade: " << resultado->idade << endl;
+            cout << "  Peso: " << resultado->peso << endl;
+            cout << "---------------------------" << endl;
+        } else {
+            cout << "Info: Pessoa com nome '" << nome << "' nao encontrada." << endl;
+        }
+    }
+};
+
+
+// --- Modo Lote (um comando por linha, E/S com buffer) ---
+
+/**
+ * @brief Lê linhas de um FILE* em blocos grandes (fread), sem uma
+ * chamada de biblioteca por linha. A linha devolvida (sem '\n' e sem
+ * '\r' final) vale até a próxima chamada.
+ */
+class LeitorDeLinhas {
+private:
+    FILE* arquivo;
+    vector<char> buffer;
+    size_t inicio, fim;
+    bool acabou;
+
+public:
+    explicit LeitorDeLinhas(FILE* f) : arquivo(f), buffer(1 << 20), inicio(0), fim(0), acabou(false) {}
+
+    bool proxima(string_view& linha) {
+        while (true) {
+            const char* base = buffer.data() + inicio;
+            const char* quebra = static_cast<const char*>(memchr(base, '\n', fim - inicio));
+            if (quebra != nullptr || (acabou && inicio < fim)) {
+                size_t tamanho = quebra ? (size_t)(quebra - base) : fim - inicio;
+                inicio += tamanho + (quebra != nullptr);
+                if (tamanho > 0 && base[tamanho - 1] == '\r') tamanho--;
+                linha = string_view(base, tamanho);
+                return true;
+            }
+            if (acabou) {
+                return false;
+            }
+            // Guarda o pedaço de linha que sobrou no começo e lê mais.
+            memmove(buffer.data(), base, fim - inicio);
+            fim -= inicio;
+            inicio = 0;
+            if (fim == buffer.size()) buffer.resize(buffer.size() * 2); // Linha enorme
+            size_t lidos = fread(buffer.data() + fim, 1, buffer.size() - fim, arquivo);
+            if (lidos == 0) acabou = true;
+            fim += lidos;
+        }
+    }
+};
+
+/**
+ * @brief Acumula a saída num buffer grande e só chama fwrite quando ele
+ * enche; fflush uma única vez, em finalizar() (ou no destrutor).
+ * Sem arquivo (nullptr), o buffer só cresce: quem usa lê dados() e
+ * descarta o que já enviou com consumir() (conexões do servidor).
+ */
+class EscritorDeLinhas {
+private:
+    FILE* arquivo;
+    vector<char> buffer;
+    size_t usados;
+
+    void garantir(size_t bytes) {
+        if (usados + bytes > buffer.size()) {
+            if (arquivo != nullptr) {
+                if (antesDeEnviar) antesDeEnviar();
+                fwrite(buffer.data(), 1, usados, arquivo);
+                usados = 0;
+            }
+            if (usados + bytes > buffer.size()) buffer.resize(max(usados + bytes, 2 * buffer.size()));
+        }
+    }
+
+public:
+    // Chamado antes de cada fwrite (ex.: confirmar o diário, para que um
+    // "OK" só saia depois de a operação estar no disco).
+    function<void()> antesDeEnviar;
+
+    explicit EscritorDeLinhas(FILE* f, size_t capacidade = 1 << 20)
+        : arquivo(f), buffer(capacidade), usados(0) {}
+
+    ~EscritorDeLinhas() {
+        finalizar();
+    }
+
+    EscritorDeLinhas& operator<<(string_view texto) {
+        if (texto.empty()) return *this; // memcpy com origem nula é UB
+        garantir(texto.size());
+        memcpy(buffer.data() + usados, texto.data(), texto.size());
+        usados += texto.size();
+        return *this;
+    }
+
+    EscritorDeLinhas& operator<<(char c) {
+        garantir(1);
+        buffer[usados++] = c;
+        return *this;
+    }
+
+    EscritorDeLinhas& operator<<(long long valor) {
+        garantir(24);
+        usados = to_chars(buffer.data() + usados, buffer.data() + buffer.size(), valor).ptr - buffer.data();
+        return *this;
+    }
+
+    EscritorDeLinhas& operator<<(double valor) {
+        garantir(32); // Forma mais curta que relê o mesmo double
+        usados = to_chars(buffer.data() + usados, buffer.data() + buffer.size(), valor).ptr - buffer.data();
+        return *this;
+    }
+
+    void finalizar() {
+        if (arquivo == nullptr) {
+            return;
+        }
+        if (antesDeEnviar) antesDeEnviar();
+        if (usados > 0) fwrite(buffer.data(), 1, usados, arquivo);
+        usados = 0;
+        fflush(arquivo);
+    }
+
+    // Modo memória: bytes ainda não enviados.
+    const char* dados() const { return buffer.data(); }
+    size_t tamanho() const { return usados; }
+
+    // Modo memória: descarta os n primeiros bytes (já enviados).
+    void consumir(size_t n) {
+        memmove(buffer.data(), buffer.data() + n, usados - n);
+        usados -= n;
+    }
+};
+
+// Uma pessoa como linha CSV (o mesmo formato que importar() lê).
+void escreverPessoa(EscritorDeLinhas& saida, const NoArvore* no) {
+    saida << no->nome << ',' << no->sexo << ',' << (long long)no->idade << ',' << no->peso << '\n';
+}
+
+/**
+ * @brief Totais de uma execução em lote.
+ */
+struct ResumoLote {
+    size_t comandos;
+    size_t erros; // Comandos inválidos ou que falharam
+    double ms;
+};
+
+// Separa a primeira palavra (até espaço/tab) do resto da linha.
+string_view primeiraPalavra(string_view& linha) {
+    size_t fimPalavra = linha.find_first_of(" \t");
+    string_view palavra = linha.substr(0, fimPalavra);
+    linha = (fimPalavra == string_view::npos) ? string_view() : linha.substr(fimPalavra);
+    size_t inicio = linha.find_first_not_of(" \t");
+    linha = (inicio == string_view::npos) ? string_view() : linha.substr(inicio);
+    return palavra;
+}
+
+// Tira a última palavra do fim da linha.
+string_view ultimaPalavra(string_view& linha) {
+    size_t fimResto = linha.find_last_not_of(" \t");
+    if (fimResto == string_view::npos) {
+        linha = string_view();
+        return string_view();
+    }
+    linha = linha.substr(0, fimResto + 1);
+    size_t espaco = linha.find_last_of(" \t");
+    string_view palavra = (espaco == string_view::npos) ? linha : linha.substr(espaco + 1);
+    linha = (espaco == string_view::npos) ? string_view() : linha.substr(0, espaco);
+    size_t fimNome = linha.find_last_not_of(" \t");
+    linha = (fimNome == string_view::npos) ? string_view() : linha.substr(0, fimNome + 1);
+    return palavra;
+}
+
+// Separa "de ate" (por tab, se houver; senão pelo primeiro espaço).
+bool separarFaixa(string_view args, string_view& de, string_view& ate) {
+    size_t corte = args.find('\t');
+    if (corte == string_view::npos) corte = args.find(' ');
+    if (corte == string_view::npos) {
+        return false;
+    }
+    de = args.substr(0, corte);
+    string_view resto = args.substr(corte + 1);
+    size_t inicio = resto.find_first_not_of(" \t");
+    ate = (inicio == string_view::npos) ? string_view() : resto.substr(inicio);
+    return !de.empty() && !ate.empty();
+}
+
+/**
+ * @brief Executa um comando (a linha já sem espaços nas pontas) e escreve
+ * a resposta; devolve false se o comando era inválido ou falhou.
+ *
+ *   INSERT <nome> <sexo> <idade> <peso>  ->  OK | ERRO ...
+ *   REMOVE <nome>                        ->  OK | ERRO ...
+ *   GET <nome>                           ->  nome,sexo,idade,peso | ERRO ...
+ *   LIST                                 ->  uma linha CSV por pessoa, e "FIM <n>"
+ *   RANGE <de> <ate>                     ->  idem, só os nomes em [de, ate]
+ *   PREFIX <k> <prefixo>                 ->  idem, os k primeiros nomes com o prefixo
+ *
+ * O nome é tudo entre o comando e os últimos argumentos (pode ter
+ * espaços); em RANGE, os dois nomes são separados por tab (ou pelo
+ * primeiro espaço). Cada comando responde ao menos uma linha.
+ */
+bool executarComando(ArvoreAVL& avl, string_view linha, EscritorDeLinhas& saida) {
+    string_view comando = primeiraPalavra(linha);
+
+    if (comando == "GET") {
+        const NoArvore* no = linha.empty() ? nullptr : avl.buscar(linha);
+        if (no != nullptr) {
+            escreverPessoa(saida, no);
+            return true;
+        }
+        saida << "ERRO nao encontrado: " << linha << '\n';
+        return false;
+    }
+    if (comando == "INSERT") {
+        PessoaImportada p;
+        string_view peso = ultimaPalavra(linha);
+        string_view idade = ultimaPalavra(linha);
+        string_view sexo = ultimaPalavra(linha);
+        // Sem tab no nome: os snapshots são gravados em TSV.
+        if (linha.empty() || linha.find('\t') != string_view::npos || !lerCampos(sexo, idade, peso, p)) {
+            saida << "ERRO uso: INSERT <nome> <M|F> <idade> <peso>\n";
+            return false;
+        }
+        if (!avl.inserir(linha, p.sexo, p.idade, p.peso)) {
+            saida << "ERRO ja existe: " << linha << '\n';
+            return false;
+        }
+        saida << "OK\n";
+        return true;
+    }
+    if (comando == "REMOVE") {
+        if (!linha.empty() && avl.remover(linha)) {
+            saida << "OK\n";
+            return true;
+        }
+        saida << "ERRO nao encontrado: " << linha << '\n';
+        return false;
+    }
+    if (comando == "LIST") {
+        avl.visitarEmOrdem([&saida](const NoArvore* no) { escreverPessoa(saida, no); });
+        saida << "FIM " << (long long)avl.tamanho() << '\n';
+        return true;
+    }
+    if (comando == "RANGE") {
+        string_view de, ate;
+        if (!separarFaixa(linha, de, ate)) {
+            saida << "ERRO uso: RANGE <de> <ate>\n";
+            return false;
+        }
+        long long n = 0;
+        avl.visitarIntervalo(de, ate, [&saida, &n](const NoArvore* no) {
+            escreverPessoa(saida, no);
+            n++;
+        });
+        saida << "FIM " << n << '\n';
+        return true;
+    }
+    if (comando == "PREFIX") {
+        size_t k = 0;
+        string_view limite = primeiraPalavra(linha);
+        from_chars_result r = from_chars(limite.data(), limite.data() + limite.size(), k);
+        if (r.ec != errc() || r.ptr != limite.data() + limite.size() || k == 0) {
+            saida << "ERRO uso: PREFIX <k> <prefixo>\n";
+            return false;
+        }
+        long long n = (long long)avl.visitarPrefixo(linha, k, [&saida](const NoArvore* no) {
+            escreverPessoa(saida, no);
+        });
+        saida << "FIM " << n << '\n';
+        return true;
+    }
+    saida << "ERRO comando desconhecido: " << comando << '\n';
+    return false;
+}
+
+// Comandos que só leem a árvore (podem rodar ao mesmo tempo no servidor).
+bool comandoDeLeitura(string_view linha) {
+    string_view comando = primeiraPalavra(linha);
+    return comando == "GET" || comando == "LIST" || comando == "RANGE" || comando == "PREFIX";
+}
+
+// Tira espaços/tabs das pontas; devolve false para linhas vazias e
+// comentários ('#').
+bool prepararLinha(string_view& linha) {
+    size_t inicio = linha.find_first_not_of(" \t");
+    if (inicio == string_view::npos || linha[inicio] == '#') {
+        return false;
+    }
+    linha = linha.substr(inicio, linha.find_last_not_of(" \t") + 1 - inicio);
+    return true;
+}
+
+/**
+ * @brief Executa comandos, um por linha, sem prompts (ver
+ * executarComando()); linhas vazias e começadas por '#' são ignoradas.
+ * Entrada e saída passam por buffers de 1 MB, com um único fflush no fim.
+ * 'antesDeEnviar', se dado, roda antes de cada bloco de respostas sair.
+ */
+ResumoLote executarLote(ArvoreAVL& avl, FILE* entrada, FILE* saidaArquivo,
+                        function<void()> antesDeEnviar = nullptr) {
+    auto t0 = chrono::steady_clock::now();
+    ResumoLote resumo = {0, 0, 0.0};
+    LeitorDeLinhas leitor(entrada);
+    EscritorDeLinhas saida(saidaArquivo);
+    saida.antesDeEnviar = antesDeEnviar;
+    bool mensagens = avl.definirMensagens(false);
+
+    string_view linha;
+    while (leitor.proxima(linha)) {
+        if (!prepararLinha(linha)) {
+            continue;
+        }
+        resumo.comandos++;
+        if (!executarComando(avl, linha, saida)) {
+            resumo.erros++;
+        }
+    }
+    saida.finalizar();
+    avl.definirMensagens(mensagens);
+    resumo.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    return resumo;
+}
+
+
+// --- Persistência (snapshot ordenado + diário; só POSIX) ---
+#ifndef _WIN32
+
+/**
+ * @brief O que recuperar() encontrou e quanto tempo levou.
+ */
+struct ResumoRecuperacao {
+    uint64_t geracao;
+    size_t noSnapshot;        // Pessoas carregadas do snapshot
+    size_t invalidasSnapshot; // Linhas do snapshot rejeitadas (não deveria haver)
+    size_t reaplicados;       // Registros do diário reaplicados
+    uint64_t bytesDescartados; // Final do diário cortado no meio ou corrompido
+    double msSnapshot;
+    double msDiario;
+};
+
+/**
+ * @brief Guarda a árvore numa pasta com um snapshot e um diário por
+ * geração: "snapshot-<g>.tsv" (as pessoas em ordem de nome, no formato
+ * que importar() lê) e "wal-<g>.log" (as operações feitas depois dele).
+ *
+ * tirarSnapshot() grava a geração g+1 num ".tmp", sincroniza, renomeia e
+ * sincroniza a pasta; só então abre o diário novo e apaga a geração g.
+ * Uma queda em qualquer ponto deixa uma geração completa: a maior com
+ * snapshot (ou g = 0, sem snapshot, na primeira execução).
+ */
+class Persistencia {
+private:
+    string pasta;
+    uint64_t limiteDiario; // Tamanho do diário que pede um snapshot novo
+    uint64_t geracao;
+    DiarioDeEscrita diario;
+    mutex travaSnapshot;
+
+    string caminhoSnapshot(uint64_t g) const {
+        return pasta + "/snapshot-" + to_string(g) + ".tsv";
+    }
+
+    string caminhoDiario(uint64_t g) const {
+        return pasta + "/wal-" + to_string(g) + ".log";
+    }
+
+    // fsync da pasta: torna visíveis (após uma queda) os renames e
+    // criações de arquivos feitos nela.
+    void sincronizarPasta() const {
+        int fd = open(pasta.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0 || fsync(fd) != 0) {
+            if (fd >= 0) close(fd);
+            throw runtime_error("Erro: nao foi possivel sincronizar a pasta " + pasta);
+        }
+        close(fd);
+    }
+
+    // Apaga os arquivos de gerações anteriores a 'atual' e ".tmp" que sobraram.
+    void apagarAntigos(uint64_t atual) const {
+        DIR* d = opendir(pasta.c_str());
+        if (d == nullptr) {
+            return;
+        }
+        vector<string> apagar;
+        while (dirent* e = readdir(d)) {
+            string nome = e->d_name;
+            uint64_t g;
+            bool temporario = nome.size() > 4 && nome.compare(nome.size() - 4, 4, ".tmp") == 0;
+            if ((lerGeracao(nome, g) && g < atual) || temporario) {
+                apagar.push_back(pasta + "/" + nome);
+            }
+        }
+        closedir(d);
+        for (const string& caminho : apagar) unlink(caminho.c_str());
+    }
+
+    // "snapshot-<g>.tsv" ou "wal-<g>.log" -> g.
+    static bool lerGeracao(const string& nome, uint64_t& g) {
+        string_view s = nome;
+        string_view sufixo;
+        if (s.substr(0, 9) == "snapshot-") {
+            s.remove_prefix(9);
+            sufixo = ".tsv";
+        } else if (s.substr(0, 4) == "wal-") {
+            s.remove_prefix(4);
+            sufixo = ".log";
+        } else {
+            return false;
+        }
+        if (s.size() <= sufixo.size() || s.substr(s.size() - sufixo.size()) != sufixo) {
+            return false;
+        }
+        s.remove_suffix(sufixo.size());
+        from_chars_result r = from_chars(s.data(), s.data() + s.size(), g);
+        return r.ec == errc() && r.ptr == s.data() + s.size();
+    }
+
+    /**
+     * @brief Reaplica os registros de 'caminho' na árvore. Para no primeiro
+     * registro incompleto ou com checksum errado e corta o arquivo ali.
+     */
+    void reaplicar(ArvoreAVL& avl, const string& caminho, ResumoRecuperacao& resumo) const {
+        struct stat info;
+        if (stat(caminho.c_str(), &info) != 0) {
+            return; // Geração sem diário ainda
+        }
+        ArquivoMapeado arquivo(caminho);
+        const char* dados = arquivo.dados();
+        const size_t cabecalho = sizeof(RegistroDiario);
+        size_t pos = 0;
+        while (arquivo.tamanho() - pos >= cabecalho) {
+            RegistroDiario r;
+            memcpy(&r, dados + pos, cabecalho);
+            if (r.tamanhoNome > arquivo.tamanho() - pos - cabecalho ||
+                r.checksum != fnv1a32(dados + pos + 4, cabecalho - 4 + r.tamanhoNome)) {
+                break;
+            }
+            string_view nome(dados + pos + cabecalho, r.tamanhoNome);
+            if (r.tipo == RegistroDiario::INSERCAO) {
+                avl.inserir(nome, r.sexo, r.idade, r.peso);
+            } else if (r.tipo == RegistroDiario::REMOCAO) {
+                avl.remover(nome);
+            } else {
+                break;
+            }
+            pos += cabecalho + r.tamanhoNome;
+            resumo.reaplicados++;
+        }
+        if (pos < arquivo.tamanho()) {
+            resumo.bytesDescartados = arquivo.tamanho() - pos;
+            if (truncate(caminho.c_str(), (off_t)pos) != 0) {
+                throw runtime_error("Erro: nao foi possivel cortar o diario " + caminho);
+            }
+        }
+    }
+
+public:
+    explicit Persistencia(const string& caminhoPasta, uint64_t limite = 64ull << 20)
+        : pasta(caminhoPasta), limiteDiario(limite), geracao(0) {}
+
+    Persistencia(const Persistencia&) = delete;
+    Persistencia& operator=(const Persistencia&) = delete;
+
+    /**
+     * @brief Carrega a última geração em 'avl' (vazia): o snapshot pela
+     * construção balanceada de importar() e o diário por inserir/remover.
+     * Depois liga o diário à árvore. Cria a pasta se não existir; lança
+     * runtime_error se ela não puder ser lida ou escrita.
+     */
+    ResumoRecuperacao recuperar(ArvoreAVL& avl) {
+        ResumoRecuperacao resumo = {0, 0, 0, 0, 0, 0.0, 0.0};
+        if (mkdir(pasta.c_str(), 0755) != 0 && errno != EEXIST) {
+            throw runtime_error("Erro: nao foi possivel criar a pasta " + pasta);
+        }
+        DIR* d = opendir(pasta.c_str());
+        if (d == nullptr) {
+            throw runtime_error("Erro: nao foi possivel ler a pasta " + pasta);
+        }
+        while (dirent* e = readdir(d)) {
+            uint64_t g;
+            if (lerGeracao(e->d_name, g)) geracao = max(geracao, g);
+        }
+        closedir(d);
+        apagarAntigos(geracao);
+        resumo.geracao = geracao;
+
+        avl.definirDiario(nullptr);
+        bool mensagens = avl.definirMensagens(false);
+        auto t0 = chrono::steady_clock::now();
+        struct stat info;
+        if (stat(caminhoSnapshot(geracao).c_str(), &info) == 0) {
+            ResumoImportacao carga = avl.importar(caminhoSnapshot(geracao));
+            resumo.noSnapshot = carga.importadas;
+            resumo.invalidasSnapshot = carga.invalidas + carga.duplicadas;
+        }
+        auto t1 = chrono::steady_clock::now();
+        reaplicar(avl, caminhoDiario(geracao), resumo);
+        auto t2 = chrono::steady_clock::now();
+        avl.definirMensagens(mensagens);
+
+        diario.abrir(caminhoDiario(geracao));
+        sincronizarPasta(); // O diário pode ter acabado de ser criado
+        avl.definirDiario(&diario);
+        resumo.msSnapshot = chrono::duration<double, milli>(t1 - t0).count();
+        resumo.msDiario = chrono::duration<double, milli>(t2 - t1).count();
+        return resumo;
+    }
+
+    // Grava e sincroniza tudo o que já foi anotado (confirmação em grupo
+    // entre threads: ver DiarioDeEscrita::confirmar()).
+    void confirmar() {
+        diario.confirmar(diario.posicao());
+    }
+
+    bool precisaSnapshot() {
+        return diario.tamanhoDoArquivo() > limiteDiario;
+    }
+
+    /**
+     * @brief Grava a árvore inteira (percurso em ordem, já ordenada por
+     * nome) como a geração seguinte e começa um diário vazio. A árvore
+     * não pode mudar durante a chamada. Com 'soSePreciso', não faz nada
+     * se outra thread acabou de tirar um snapshot.
+     */
+    void tirarSnapshot(const ArvoreAVL& avl, bool soSePreciso = false) {
+        lock_guard<mutex> guarda(travaSnapshot);
+        if (soSePreciso && !precisaSnapshot()) {
+            return;
+        }
+        confirmar();
+        uint64_t proxima = geracao + 1;
+        string temporario = caminhoSnapshot(proxima) + ".tmp";
+        FILE* arquivo = fopen(temporario.c_str(), "w");
+        if (arquivo == nullptr) {
+            throw runtime_error("Erro: nao foi possivel criar " + temporario);
+        }
+        bool ok;
+        {
+            EscritorDeLinhas saida(arquivo);
+            saida << "nome\tsexo\tidade\tpeso\n";
+            avl.visitarEmOrdem([&saida](const NoArvore* no) {
+                saida << no->nome << '\t' << no->sexo << '\t' << (long long)no->idade << '\t' << no->peso << '\n';
+            });
+            saida.finalizar();
+            ok = !ferror(arquivo) && fsync(fileno(arquivo)) == 0;
+        }
+        ok = fclose(arquivo) == 0 && ok;
+        if (!ok || rename(temporario.c_str(), caminhoSnapshot(proxima).c_str()) != 0) {
+            unlink(temporario.c_str());
+            throw runtime_error("Erro: falha ao gravar o snapshot " + caminhoSnapshot(proxima));
+        }
+        sincronizarPasta();
+        diario.abrir(caminhoDiario(proxima));
+        sincronizarPasta();
+        geracao = proxima;
+        apagarAntigos(geracao);
+    }
+
+    uint64_t geracaoAtual() {
+        lock_guard<mutex> guarda(travaSnapshot);
+        return geracao;
+    }
+
+    uint64_t totalDeSincronizacoes() {
+        return diario.totalDeSincronizacoes();
+    }
+};
+
+#endif // _WIN32
+
+// --- Servidor (socket Unix + epoll; só Linux) ---
+#ifdef __linux__
+
+// Desligado por SIGINT/SIGTERM; os laços olham a cada volta do epoll.
+atomic<bool> servidorAtivo(true);
+
+void pararServidor(int) {
+    servidorAtivo = false;
+}
+
+/**
+ * @brief Estado de uma conexão: bytes recebidos que ainda não foram
+ * executados e respostas ainda não enviadas.
+ */
+struct ConexaoServidor {
+    int fd;
+    vector<char> entrada;
+    EscritorDeLinhas saida;
+    uint32_t interesse; // Eventos pedidos ao epoll no momento
+    bool fimDaEntrada;  // O cliente fechou a escrita (shutdown(SHUT_WR))
+
+    explicit ConexaoServidor(int f)
+        : fd(f), saida(nullptr, 16 << 10), interesse(EPOLLIN), fimDaEntrada(false) {}
+
+    bool temLinhaCompleta() const {
+        return memchr(entrada.data(), '\n', entrada.size()) != nullptr;
+    }
+};
+
+/**
+ * @brief Serve a árvore por um socket Unix com o protocolo de linhas do
+ * modo lote (executarComando): cada cliente pode mandar muitos comandos
+ * sem esperar as respostas (pipelining), que voltam na mesma ordem.
+ *
+ * Cada thread tem seu próprio epoll, e todas esperam no socket de escuta
+ * (EPOLLEXCLUSIVE: só uma acorda por conexão nova). A árvore fica atrás
+ * de um shared_mutex: GET/LIST/RANGE rodam ao mesmo tempo em threads
+ * diferentes; INSERT/REMOVE têm acesso exclusivo. Comandos seguidos do
+ * mesmo tipo, vindos da mesma leitura, passam por uma única trava.
+ *
+ * Um cliente que fecha só a escrita (shutdown(SHUT_WR)) ainda recebe as
+ * respostas de tudo o que mandou; a conexão só fecha depois disso.
+ * LIMITE_SAIDA é conferido entre comandos: um LIST ou RANGE é montado
+ * inteiro na saída da conexão, então cada cliente pode segurar até o
+ * tamanho do registro em CSV além do limite.
+ *
+ * Com Persistencia, as respostas de uma leitura do socket só saem depois
+ * de o diário confirmar tudo o que estava anotado ao fim dela: as
+ * escritas da própria conexão e também as de outras que um GET/LIST/RANGE
+ * possa ter visto (nenhuma resposta mostra dado que ainda não está no
+ * disco). As threads que confirmam ao mesmo tempo dividem um único
+ * fdatasync; sem escritas pendentes, confirmar só toma uma trava. Se o
+ * diário falhar, nenhuma resposta pendente sai e o servidor para.
+ */
+class ServidorRegistro {
+private:
+    static const size_t LIMITE_SAIDA = 4 << 20;   // Para de ler o cliente que não lê as respostas
+    static const size_t LIMITE_LINHA = 16 << 20;  // Linha maior que isso derruba a conexão
+    static const size_t BLOCO_LEITURA = 64 << 10;
+
+    ArvoreAVL& avl;
+    Persistencia* persistencia; // nullptr: só em memória
+    shared_mutex trava;
+    string caminho;
+    int escuta;
+    atomic<size_t> comandos;
+
+    // Executa as linhas completas recebidas (enquanto a saída pendente
+    // couber no limite).
+    void processar(ConexaoServidor& c) {
+        enum { SOLTA, LEITURA, ESCRITA } travada = SOLTA;
+        size_t lidos = 0;
+        size_t executados = 0;
+        bool escreveu = false;
+        string falha; // Erro do diário: nenhuma resposta sai e o servidor para
+        try {
+            while (c.saida.tamanho() < LIMITE_SAIDA) {
+                const char* ini = c.entrada.data() + lidos;
+                const char* quebra = static_cast<const char*>(memchr(ini, '\n', c.entrada.size() - lidos));
+                if (quebra == nullptr) {
+                    break;
+                }
+                string_view linha(ini, quebra - ini);
+                lidos += linha.size() + 1;
+                if (!linha.empty() && linha.back() == '\r') linha.remove_suffix(1);
+                if (!prepararLinha(linha)) {
+                    continue;
+                }
+                bool leitura = comandoDeLeitura(linha);
+                if (travada != (leitura ? LEITURA : ESCRITA)) {
+                    if (travada == LEITURA) trava.unlock_shared();
+                    if (travada == ESCRITA) trava.unlock();
+                    if (leitura) {
+                        trava.lock_shared();
+                        travada = LEITURA;
+                    } else {
+                        trava.lock();
+                        travada = ESCRITA;
+                    }
+                }
+                escreveu = escreveu || !leitura;
+                executarComando(avl, linha, c.saida); // Lança se o diário já falhou
+                executados++;
+            }
+        } catch (const exception& e) {
+            falha = e.what();
+        }
+        if (travada == LEITURA) trava.unlock_shared();
+        if (travada == ESCRITA) trava.unlock();
+        c.entrada.erase(c.entrada.begin(), c.entrada.begin() + lidos);
+        comandos.fetch_add(executados, memory_order_relaxed);
+        if (falha.empty() && executados > 0 && persistencia != nullptr) {
+            try {
+                persistencia->confirmar();
+                if (escreveu && persistencia->precisaSnapshot()) {
+                    shared_lock<shared_mutex> leitura(trava); // Segura as escritas
+                    persistencia->tirarSnapshot(avl, true);
+                }
+            } catch (const exception& e) {
+                falha = e.what();
+            }
+        }
+        if (!falha.empty()) {
+            cerr << falha << endl;
+            c.saida.consumir(c.saida.tamanho());
+            servidorAtivo = false;
+        }
+    }
 
-                // Remove o sucessor (que agora é duplicado)
-                no->direita = _remover(no->direita, temp->nome);
+    // Envia o que der sem bloquear; false se a conexão caiu.
+    bool enviar(ConexaoServidor& c) {
+        size_t enviados = 0;
+        while (enviados < c.saida.tamanho()) {
+            ssize_t n = send(c.fd, c.saida.dados() + enviados, c.saida.tamanho() - enviados, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
             }
+            enviados += (size_t)n;
         }
+        c.saida.consumir(enviados);
+        return true;
+    }
 
-        // Se a árvore ficou vazia (após remover o único nó)
-        if (no == nullptr) {
-            return no;
+    // Lê tudo o que já chegou; false se houve erro. No fim da entrada,
+    // uma última linha sem '\n' ainda é executada.
+    bool receber(ConexaoServidor& c) {
+        while (c.entrada.size() < LIMITE_LINHA) {
+            size_t antes = c.entrada.size();
+            c.entrada.resize(antes + BLOCO_LEITURA);
+            ssize_t n = recv(c.fd, c.entrada.data() + antes, BLOCO_LEITURA, 0);
+            c.entrada.resize(antes + (n > 0 ? (size_t)n : 0));
+            if (n > 0) continue;
+            if (n == 0) {
+                c.fimDaEntrada = true;
+                if (!c.entrada.empty() && c.entrada.back() != '\n') c.entrada.push_back('\n');
+                return true;
+            }
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
         }
+        return c.temLinhaCompleta();
+    }
 
-        // 2. Atualizar a altura
-        atualizarAltura(no);
+    void fechar(int epoll, ConexaoServidor* c) {
+        epoll_ctl(epoll, EPOLL_CTL_DEL, c->fd, nullptr);
+        close(c->fd);
+        delete c;
+    }
 
-        // 3. Obter o fator de balanceamento
-        int fator = getFatorBalanceamento(no);
+    void aceitar(int epoll, vector<ConexaoServidor*>& abertas) {
+        while (true) {
+            int fd = accept4(escuta, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return; // EAGAIN: outra thread pegou, ou não há mais
+            }
+            ConexaoServidor* c = new ConexaoServidor(fd);
+            epoll_event evento = {};
+            evento.events = c->interesse;
+            evento.data.ptr = c;
+            epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &evento);
+            abertas.push_back(c);
+        }
+    }
 
-        // 4. Rebalancear (Os 4 casos, ligeiramente diferentes na lógica)
+    void laco() {
+        int epoll = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event evento = {};
+        evento.events = EPOLLIN | EPOLLEXCLUSIVE;
+        evento.data.ptr = nullptr; // nullptr = socket de escuta
+        epoll_ctl(epoll, EPOLL_CTL_ADD, escuta, &evento);
 
-        // Caso Esquerda-Esquerda (LL)
-        if (fator > 1 && getFatorBalanceamento(no->esquerda) >= 0) {
-            return rotacaoDireita(no);
+        vector<ConexaoServidor*> abertas;
+        epoll_event eventos[64];
+        while (servidorAtivo) {
+            int prontos = epoll_wait(epoll, eventos, 64, 200);
+            for (int i = 0; i < prontos; i++) {
+                ConexaoServidor* c = static_cast<ConexaoServidor*>(eventos[i].data.ptr);
+                if (c == nullptr) {
+                    aceitar(epoll, abertas);
+                    continue;
+                }
+                bool viva = !(eventos[i].events & EPOLLERR);
+                if (viva && !c->fimDaEntrada && (eventos[i].events & (EPOLLIN | EPOLLHUP))) {
+                    viva = receber(*c);
+                }
+                // Executa e envia até o socket encher ou acabarem as linhas.
+                while (viva) {
+                    processar(*c);
+                    if (!enviar(*c)) {
+                        viva = false;
+                    } else if (c->saida.tamanho() > 0 || !c->temLinhaCompleta()) {
+                        break;
+                    }
+                }
+                // Cliente fechou a escrita e já recebeu todas as respostas.
+                bool terminou = c->fimDaEntrada && c->saida.tamanho() == 0 && !c->temLinhaCompleta();
+                if (!viva || terminou) {
+                    abertas.erase(find(abertas.begin(), abertas.end(), c));
+                    fechar(epoll, c);
+                    continue;
+                }
+                // Só lê mais quando a saída pendente cabe no limite.
+                bool ler = !c->fimDaEntrada && c->saida.tamanho() < LIMITE_SAIDA;
+                uint32_t interesse = ler ? (uint32_t)EPOLLIN : 0u;
+                if (c->saida.tamanho() > 0) interesse |= EPOLLOUT;
+                if (interesse != c->interesse) {
+                    c->interesse = interesse;
+                    epoll_event mudanca = {};
+                    mudanca.events = interesse;
+                    mudanca.data.ptr = c;
+                    epoll_ctl(epoll, EPOLL_CTL_MOD, c->fd, &mudanca);
+                }
+            }
         }
+        for (ConexaoServidor* c : abertas) fechar(epoll, c);
+        close(epoll);
+    }
 
-        // Caso Esquerda-Direita (LR)
-        if (fator > 1 && getFatorBalanceamento(no->esquerda) < 0) {
-            no->esquerda = rotacaoEsquerda(no->esquerda);
-            return rotacaoDireita(no);
+public:
+    ServidorRegistro(ArvoreAVL& a, const string& caminhoSocket, Persistencia* p = nullptr)
+        : avl(a), persistencia(p), caminho(caminhoSocket), comandos(0) {
+        sockaddr_un endereco = {};
+        endereco.sun_family = AF_UNIX;
+        if (caminho.size() >= sizeof(endereco.sun_path)) {
+            throw runtime_error("Erro: caminho do socket muito longo: " + caminho);
         }
-
-        // Caso Direita-Direita (RR)
-        if (fator < -1 && getFatorBalanceamento(no->direita) <= 0) {
-            return rotacaoEsquerda(no);
+        memcpy(endereco.sun_path, caminho.c_str(), caminho.size() + 1);
+        escuta = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (escuta < 0) {
+            throw runtime_error("Erro: nao foi possivel criar o socket.");
         }
-
-        // Caso Direita-Esquerda (RL)
-        if (fator < -1 && getFatorBalanceamento(no->direita) > 0) {
-            no->direita = rotacaoDireita(no->direita);
-            return rotacaoEsquerda(no);
+        unlink(caminho.c_str()); // Socket que sobrou de uma execução anterior
+        if (bind(escuta, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) != 0 ||
+            listen(escuta, SOMAXCONN) != 0) {
+            close(escuta);
+            throw runtime_error("Erro: nao foi possivel escutar em " + caminho);
         }
-
-        return no;
     }
 
-    // --- F4: Consulta (Recursiva) ---
-    NoArvore* _consultar(NoArvore* no, string nome) {
-        if (no == nullptr) {
-            return nullptr; // Não encontrado
-        }
+    ~ServidorRegistro() {
+        close(escuta);
+        unlink(caminho.c_str());
+    }
 
-        if (nome == no->nome) {
-            return no; // Encontrado
-        }
+    ServidorRegistro(const ServidorRegistro&) = delete;
+    ServidorRegistro& operator=(const ServidorRegistro&) = delete;
 
-        if (nome < no->nome) {
-            return _consultar(no->esquerda, nome);
-        } else {
-            return _consultar(no->direita, nome);
-        }
+    // Atende até servidorAtivo ser desligado (SIGINT/SIGTERM).
+    void executar(unsigned threads) {
+        avl.definirMensagens(false);
+        vector<thread> outras;
+        for (unsigned i = 1; i < threads; i++) outras.emplace_back(&ServidorRegistro::laco, this);
+        laco();
+        for (thread& t : outras) t.join();
     }
 
-    // --- Destrutor Auxiliar ---
-    void _destruir(NoArvore* no) {
-        if (no != nullptr) {
-            _destruir(no->esquerda);
-            _destruir(no->direita);
-            delete no;
-        }
+    size_t totalDeComandos() const {
+        return comandos.load();
     }
+};
 
+// Conecta ao socket do servidor (bloqueante); -1 se falhar.
+int conectarRegistro(const string& caminho) {
+    sockaddr_un endereco = {};
+    endereco.sun_family = AF_UNIX;
+    if (caminho.size() >= sizeof(endereco.sun_path)) {
+        return -1;
+    }
+    memcpy(endereco.sun_path, caminho.c_str(), caminho.size() + 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
 
-public:
-    // Construtor
-    ArvoreAVL() : raiz(nullptr) {}
-
-    // Destrutor
-    ~ArvoreAVL() {
-        _destruir(raiz);
+/**
+ * @brief Uma conexão do gerador de carga: manda lotes de 'profundidade'
+ * comandos sem esperar (pipelining) e mede, para cada um, o tempo do
+ * envio do lote até a chegada da sua resposta.
+ */
+void conexaoDeCarga(const string& caminho, int id, int requisicoes, int profundidade,
+                    vector<float>& latenciasUs, size_t& erros) {
+    int fd = conectarRegistro(caminho);
+    if (fd < 0) {
+        erros += requisicoes;
+        return;
     }
+    mt19937 gerador(1000 + id);
+    vector<char> recebido(1 << 16);
+    size_t pendentes = 0, inicioLinha = 0, fimDados = 0;
+    string lote;
+    char nome[48];
+
+    // Manda o lote e espera as 'quantos' respostas, anotando latências.
+    auto trocar = [&](int quantos, bool medir) {
+        auto enviado = chrono::steady_clock::now();
+        for (size_t feito = 0; feito < lote.size();) {
+            ssize_t n = send(fd, lote.data() + feito, lote.size() - feito, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            feito += (size_t)n;
+        }
+        pendentes = quantos;
+        while (pendentes > 0) {
+            if (fimDados == recebido.size()) {
+                memmove(recebido.data(), recebido.data() + inicioLinha, fimDados - inicioLinha);
+                fimDados -= inicioLinha;
+                inicioLinha = 0;
+                if (fimDados == recebido.size()) recebido.resize(recebido.size() * 2);
+            }
+            ssize_t n = recv(fd, recebido.data() + fimDados, recebido.size() - fimDados, 0);
+            if (n <= 0) return false;
+            auto chegou = chrono::steady_clock::now();
+            fimDados += (size_t)n;
+            while (pendentes > 0) {
+                const char* ini = recebido.data() + inicioLinha;
+                const char* quebra = static_cast<const char*>(memchr(ini, '\n', fimDados - inicioLinha));
+                if (quebra == nullptr) break;
+                if (quebra - ini >= 4 && memcmp(ini, "ERRO", 4) == 0) erros++;
+                if (medir) latenciasUs.push_back(chrono::duration<float, micro>(chegou - enviado).count());
+                inicioLinha += quebra - ini + 1;
+                pendentes--;
+            }
+        }
+        return true;
+    };
 
-    // F1: Interface pública de Inserção
-    void inserir(string nome, char sexo, int idade, double peso) {
-        raiz = _inserir(raiz, nome, sexo, idade, peso);
+    // Aquecimento: cada conexão cadastra seus próprios nomes (com o pid,
+    // para não repetir os de outra execução do cliente).
+    const int execucao = (int)getpid();
+    const int proprios = 1000;
+    int cadastrados = 0;
+    for (int k = 0; k < proprios; k += profundidade) {
+        lote.clear();
+        int quantos = min(profundidade, proprios - k);
+        for (int j = 0; j < quantos; j++) {
+            snprintf(nome, sizeof(nome), "Carga %d-%d-%d", execucao, id, cadastrados++);
+            lote += string("INSERT ") + nome + " F 30 60.5\n";
+        }
+        if (!trocar(quantos, false)) break;
     }
 
-    // F2: Interface pública de Listagem (Em-Ordem)
-    void listarEmOrdem() {
-        if (raiz == nullptr) {
-            cout << "A arvore esta vazia." << endl;
-        } else {
-            cout << "--- Listagem Em-Ordem (Alfabetica) ---" << endl;
-            _listarEmOrdem(raiz);
-            cout << "---------------------------------------" << endl;
+    // Medição: 90% GET de nomes próprios, 10% INSERT de nomes novos.
+    for (int k = 0; k < requisicoes; k += profundidade) {
+        lote.clear();
+        int quantos = min(profundidade, requisicoes - k);
+        for (int j = 0; j < quantos; j++) {
+            if (gerador() % 10 == 0) {
+                snprintf(nome, sizeof(nome), "Carga %d-%d-%d", execucao, id, cadastrados++);
+                lote += string("INSERT ") + nome + " M 40 80\n";
+            } else {
+                snprintf(nome, sizeof(nome), "Carga %d-%d-%d", execucao, id, (int)(gerador() % cadastrados));
+                lote += string("GET ") + nome + "\n";
+            }
+        }
+        if (!trocar(quantos, true)) {
+            erros += requisicoes - k;
+            break;
         }
     }
+    close(fd);
+}
 
-    // F3: Interface pública de Remoção
-    void remover(string nome) {
-        raiz = _remover(raiz, nome);
+/**
+ * @brief Gerador de carga: 'conexoes' clientes em paralelo, cada um com
+ * 'requisicoes' comandos em lotes de 'profundidade'. Imprime QPS e as
+ * latências p50/p99/p99.9/máxima.
+ */
+void clienteDeCarga(const string& caminho, int conexoes, int requisicoes, int profundidade) {
+    vector<vector<float>> latencias(conexoes);
+    vector<size_t> erros(conexoes, 0);
+    vector<thread> threads;
+    auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < conexoes; i++) {
+        latencias[i].reserve(requisicoes);
+        threads.emplace_back(conexaoDeCarga, caminho, i, requisicoes, profundidade,
+                             ref(latencias[i]), ref(erros[i]));
     }
+    for (thread& t : threads) t.join();
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
 
-    // F4: Interface pública de Consulta
-    void consultar(string nome) {
-        NoArvore* resultado = _consultar(raiz, nome);
-        if (resultado != nullptr) {
-            cout << "--- Consulta Encontrada ---" << endl;
-            cout << "  Nome: " << resultado->nome << endl;
-            cout << "  Sexo: " << resultado->sexo << endl;
-            cout << "  Idade: " << resultado->idade << endl;
-            cout << "  Peso: " << resultado->peso << endl;
-            cout << "---------------------------" << endl;
-        } else {
-            cout << "Info: Pessoa com nome '" << nome << "' nao encontrada." << endl;
-        }
+    vector<float> todas;
+    size_t totalErros = 0;
+    for (int i = 0; i < conexoes; i++) {
+        todas.insert(todas.end(), latencias[i].begin(), latencias[i].end());
+        totalErros += erros[i];
     }
-};
+    if (todas.empty()) {
+        cout << "Erro: nenhuma resposta (o servidor esta rodando em " << caminho << "?)" << endl;
+        return;
+    }
+    sort(todas.begin(), todas.end());
+    auto percentil = [&todas](double p) { return todas[min(todas.size() - 1, (size_t)(p * todas.size()))]; };
+    cout << conexoes << " conexoes x " << requisicoes << " comandos (lotes de " << profundidade
+         << "): " << todas.size() / segundos << " comandos/s, " << totalErros << " erros" << endl;
+    cout << "Latencia (us): p50 " << percentil(0.50) << " | p99 " << percentil(0.99) << " | p99.9 "
+         << percentil(0.999) << " | max " << todas.back() << endl;
+}
+
+#endif // __linux__
 
 
 // --- Funções Auxiliares para o Menu (Validação de Entrada) ---
@@ -386,20 +3197,817 @@ double getDouble(const string& prompt) {
 }
 
 
+// Solicita um filtro de sexo: 'M', 'F' ou 'T' (todos, devolvido como 0)
+char getFiltroSexo(const string& prompt) {
+    char entrada;
+    while (true) {
+        cout << prompt;
+        cin >> entrada;
+        entrada = toupper(entrada);
+        if (entrada == 'M' || entrada == 'F' || entrada == 'T') {
+            limparBufferEntrada();
+            return (entrada == 'T') ? 0 : entrada;
+        }
+        cout << "Entrada invalida. Digite 'M', 'F' ou 'T'." << endl;
+        limparBufferEntrada();
+    }
+}
+
+void imprimirAgregado(const AgregadoPessoas& r) {
+    cout << "  Pessoas: " << r.contagem << endl;
+    if (r.contagem > 0) {
+        cout << "  Idade: media " << r.mediaIdade() << ", min " << r.minIdade
+             << ", max " << r.maxIdade << endl;
+        cout << "  Peso:  media " << r.mediaPeso() << ", min " << r.minPeso
+             << ", max " << r.maxPeso << endl;
+    }
+}
+
+void imprimirSoma(const SomaSubarvore& s) {
+    cout << "  Pessoas: " << s.contagem << " (" << s.homens << " M, " << s.mulheres << " F)" << endl;
+    if (s.contagem > 0) {
+        cout << "  Idade media: " << s.mediaIdade() << " | Peso total: " << s.somaPeso
+             << " kg, medio " << s.mediaPeso() << " kg" << endl;
+    }
+}
+
+void imprimirResumo(const ResumoImportacao& r) {
+    auto imprimirLinhas = [](const vector<size_t>& linhas, size_t total) {
+        if (linhas.empty()) return;
+        cout << " (linhas";
+        for (size_t linha : linhas) cout << " " << linha;
+        if (total > linhas.size()) cout << " ...";
+        cout << ")";
+    };
+    cout << "--- Resumo da Importacao ---" << endl;
+    cout << "  Linhas lidas: " << r.linhas << endl;
+    cout << "  Importadas:   " << r.importadas << endl;
+    cout << "  Invalidas:    " << r.invalidas;
+    imprimirLinhas(r.exemplosInvalidas, r.invalidas);
+    cout << endl;
+    cout << "  Duplicadas:   " << r.duplicadas;
+    imprimirLinhas(r.exemplosDuplicadas, r.duplicadas);
+    cout << endl;
+    cout << "  Tempo: leitura " << r.msLeitura << " ms (" << r.threads << " threads), ordenacao "
+         << r.msOrdenacao << " ms, construcao " << r.msConstrucao << " ms" << endl;
+    cout << "----------------------------" << endl;
+}
+
+void imprimirRegistros(const vector<const NoArvore*>& registros) {
+    if (registros.empty()) {
+        cout << "Nenhuma pessoa na faixa." << endl;
+        return;
+    }
+    for (const NoArvore* no : registros) {
+        cout << "  - Nome: " << no->nome
+             << " (Sexo: " << no->sexo
+             << ", Idade: " << no->idade
+             << ", Peso: " << no->peso << ")" << endl;
+    }
+}
+
+#ifndef _WIN32
+void imprimirRecuperacao(ostream& saida, const ResumoRecuperacao& r) {
+    saida << "Recuperado (geracao " << r.geracao << "): " << r.noSnapshot << " pessoas do snapshot em "
+          << r.msSnapshot << " ms, " << r.reaplicados << " registros do diario em " << r.msDiario << " ms";
+    if (r.bytesDescartados > 0) saida << ", " << r.bytesDescartados << " bytes finais descartados";
+    if (r.invalidasSnapshot > 0) saida << ", " << r.invalidasSnapshot << " linhas invalidas no snapshot";
+    saida << "." << endl;
+}
+#endif
+
+// --- Comparativos (executados por linha de comando, fora do menu) ---
+
+/**
+ * @brief "Peso médio das mulheres de 30 a 40 anos" sobre n pessoas:
+ * percorrendo a árvore x varrendo as colunas.
+ */
+void comparativoColunas(int n) {
+    ArvoreAVL avl;
+    avl.definirMensagens(false);
+    mt19937 gerador(42);
+    char nome[16];
+    for (int i = 0; i < n; i++) {
+        snprintf(nome, sizeof(nome), "P%09u", (unsigned)gerador());
+        avl.inserir(nome, (gerador() % 2) ? 'M' : 'F', 18 + (int)(gerador() % 63),
+                    45.0 + (gerador() % 700) / 10.0);
+    }
+    FiltroPessoas filtro = {'F', 30, 40, 0.0, HUGE_VAL};
+
+    auto t0 = chrono::steady_clock::now();
+    AgregadoPessoas pelaArvore = avl.agregarPercorrendo(filtro);
+    auto t1 = chrono::steady_clock::now();
+    AgregadoPessoas pelasColunas = avl.agregar(filtro);
+    auto t2 = chrono::steady_clock::now();
+
+    cout << "Mulheres de 30 a 40 anos entre " << n << " pessoas:" << endl;
+    imprimirAgregado(pelasColunas);
+    cout << "Percorrendo a arvore: " << chrono::duration<double, milli>(t1 - t0).count()
+         << " ms (" << pelaArvore.contagem << " pessoas, peso medio " << pelaArvore.mediaPeso() << ")"
+         << endl;
+    cout << "Varrendo as colunas:  " << chrono::duration<double, milli>(t2 - t1).count()
+         << " ms" << endl;
+}
+
+/**
+ * @brief Insere e consulta n nomes aleatórios de 10 letras na AVL (arena +
+ * prefixos) e num std::set<string> de referência.
+ */
+void comparativoNomes(int n) {
+    mt19937 gerador(7);
+    vector<string> nomesGerados(n);
+    for (string& nome : nomesGerados) {
+        nome.resize(10);
+        nome[0] = (char)('A' + gerador() % 26);
+        for (int k = 1; k < 10; k++) nome[k] = (char)('a' + gerador() % 26);
+    }
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+
+    {
+        ArvoreAVL avl;
+        avl.definirMensagens(false);
+        auto t0 = chrono::steady_clock::now();
+        for (const string& nome : nomesGerados) avl.inserir(nome, 'F', 30, 60.0);
+        auto t1 = chrono::steady_clock::now();
+        size_t achados = 0;
+        for (const string& nome : nomesGerados) achados += avl.contem(nome);
+        auto t2 = chrono::steady_clock::now();
+        cout << "AVL (arena + prefixo): inserir " << ms(t0, t1) << " ms | consultar "
+             << ms(t1, t2) << " ms (" << achados << " achados, altura " << avl.altura() << ")"
+             << endl;
+    }
+    {
+        set<string> referencia;
+        auto t0 = chrono::steady_clock::now();
+        for (const string& nome : nomesGerados) referencia.insert(nome);
+        auto t1 = chrono::steady_clock::now();
+        size_t achados = 0;
+        for (const string& nome : nomesGerados) achados += referencia.count(nome);
+        auto t2 = chrono::steady_clock::now();
+        cout << "std::set<string>:      inserir " << ms(t0, t1) << " ms | consultar "
+             << ms(t1, t2) << " ms (" << achados << " achados)" << endl;
+    }
+}
+
+/**
+ * @brief Custo dos índices secundários sobre n pessoas: inserir e remover
+ * com e sem os índices (a diferença é a manutenção deles), e consultas
+ * por faixa de idade/peso pelo índice x varredura colunar.
+ */
+void comparativoIndices(int n) {
+    mt19937 gerador(11);
+    vector<string> nomesGerados(n);
+    vector<char> sexos(n);
+    vector<int> idades(n);
+    vector<double> pesos(n);
+    char nome[16];
+    for (int i = 0; i < n; i++) {
+        snprintf(nome, sizeof(nome), "P%09u", (unsigned)gerador());
+        nomesGerados[i] = nome;
+        sexos[i] = (gerador() % 2) ? 'M' : 'F';
+        idades[i] = 18 + (int)(gerador() % 63);
+        pesos[i] = 45.0 + (gerador() % 700) / 10.0;
+    }
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+
+    double inserir[2], remover[2];
+    for (int comIndices = 0; comIndices < 2; comIndices++) {
+        ArvoreAVL avl;
+        avl.definirMensagens(false);
+        avl.ativarIndices(comIndices, comIndices);
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) avl.inserir(nomesGerados[i], sexos[i], idades[i], pesos[i]);
+        auto t1 = chrono::steady_clock::now();
+        inserir[comIndices] = ms(t0, t1);
+
+        if (comIndices) {
+            // Consultas por faixa: 1 ano de idade / 1 kg de peso.
+            const int consultas = 200;
+            size_t peloIndice = 0, pelasColunas = 0;
+            auto q0 = chrono::steady_clock::now();
+            for (int q = 0; q < consultas; q++) {
+                int idade = 18 + q % 63;
+                double peso = 45.0 + q % 70;
+                peloIndice += avl.porIdade(idade, idade).size();
+                peloIndice += avl.porPeso(peso, peso + 1.0).size();
+            }
+            auto q1 = chrono::steady_clock::now();
+            for (int q = 0; q < consultas; q++) {
+                int idade = 18 + q % 63;
+                double peso = 45.0 + q % 70;
+                FiltroPessoas porIdade = {0, idade, idade, -HUGE_VAL, HUGE_VAL};
+                FiltroPessoas porPeso = {0, INT_MIN, INT_MAX, peso, peso + 1.0};
+                pelasColunas += avl.agregar(porIdade).contagem;
+                pelasColunas += avl.agregar(porPeso).contagem;
+            }
+            auto q2 = chrono::steady_clock::now();
+            cout << 2 * consultas << " consultas por faixa (" << peloIndice << " resultados):" << endl;
+            cout << "  Pelo indice:         " << ms(q0, q1) << " ms (devolve os registros)" << endl;
+            cout << "  Varrendo as colunas: " << ms(q1, q2) << " ms (so agrega, "
+                 << pelasColunas << " resultados)" << endl;
+        }
+
+        auto t2 = chrono::steady_clock::now();
+        for (int i = 0; i < n; i += 2) avl.remover(nomesGerados[i]);
+        auto t3 = chrono::steady_clock::now();
+        remover[comIndices] = ms(t2, t3);
+    }
+
+    cout << "Inserir " << n << " pessoas: " << inserir[0] << " ms sem indices, " << inserir[1]
+         << " ms com indices" << endl;
+    cout << "Remover " << (n + 1) / 2 << " pessoas: " << remover[0] << " ms sem indices, "
+         << remover[1] << " ms com indices" << endl;
+    cout << "Manutencao dos indices: " << (inserir[1] - inserir[0]) * 1e6 / n
+         << " ns por insercao, " << (remover[1] - remover[0]) * 1e6 / ((n + 1) / 2)
+         << " ns por remocao" << endl;
+}
+
+/**
+ * @brief Consultas exatas por nome sobre n pessoas: tabela de hash x
+ * descida na AVL, com acertos e com nomes ausentes, e a memória extra da
+ * tabela.
+ */
+void comparativoHash(int n) {
+    mt19937 gerador(13);
+    auto gerarNome = [&gerador]() {
+        string nome(10, ' ');
+        nome[0] = (char)('A' + gerador() % 26);
+        for (int k = 1; k < 10; k++) nome[k] = (char)('a' + gerador() % 26);
+        return nome;
+    };
+    vector<string> presentes(n), ausentes(n);
+    for (string& nome : presentes) nome = gerarNome();
+    for (string& nome : ausentes) nome = gerarNome() + "#"; // Nunca inseridos
+    vector<string> embaralhados = presentes;
+    shuffle(embaralhados.begin(), embaralhados.end(), gerador);
+
+    ArvoreAVL avl;
+    avl.definirMensagens(false);
+    for (const string& nome : presentes) avl.inserir(nome, 'F', 30, 60.0);
+
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    auto t0 = chrono::steady_clock::now();
+    size_t achadosHash = 0;
+    for (const string& nome : embaralhados) achadosHash += avl.contem(nome);
+    auto t1 = chrono::steady_clock::now();
+    size_t achadosArvore = 0;
+    for (const string& nome : embaralhados) achadosArvore += avl.contemNaArvore(nome);
+    auto t2 = chrono::steady_clock::now();
+    size_t falsosHash = 0;
+    for (const string& nome : ausentes) falsosHash += avl.contem(nome);
+    auto t3 = chrono::steady_clock::now();
+    size_t falsosArvore = 0;
+    for (const string& nome : ausentes) falsosArvore += avl.contemNaArvore(nome);
+    auto t4 = chrono::steady_clock::now();
+
+    cout << n << " pessoas (altura da AVL " << avl.altura() << ")" << endl;
+    cout << "Acertos:  tabela " << ms(t0, t1) * 1e6 / n << " ns/consulta | arvore "
+         << ms(t1, t2) * 1e6 / n << " ns/consulta (" << achadosHash << " / " << achadosArvore
+         << " achados)" << endl;
+    cout << "Ausentes: tabela " << ms(t2, t3) * 1e6 / n << " ns/consulta | arvore "
+         << ms(t3, t4) * 1e6 / n << " ns/consulta (" << falsosHash + falsosArvore
+         << " achados)" << endl;
+    cout << "Memoria da tabela: " << avl.bytesTabelaNomes() / 1048576.0 << " MB ("
+         << (double)avl.bytesTabelaNomes() / n << " bytes por pessoa)" << endl;
+}
+
+/**
+ * @brief Estatísticas por faixa de nomes sobre n pessoas: somas das
+ * sub-árvores x percorrer a árvore inteira; e a k-ésima pessoa.
+ */
+void comparativoAgregados(int n) {
+    mt19937 gerador(17);
+    ArvoreAVL avl;
+    avl.definirMensagens(false);
+    char nome[16];
+    for (int i = 0; i < n; i++) {
+        snprintf(nome, sizeof(nome), "%c%08u", 'A' + (int)(gerador() % 26), (unsigned)gerador());
+        avl.inserir(nome, (gerador() % 2) ? 'M' : 'F', 18 + (int)(gerador() % 63),
+                    45.0 + (gerador() % 700) / 10.0);
+    }
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+
+    // Faixas de letras: "B" a "M~" pega todo nome que começa com B..M.
+    const int consultas = 20;
+    SomaSubarvore pelasSomas = {0, 0, 0, 0, 0.0}, percorrendo = {0, 0, 0, 0, 0.0};
+    auto t0 = chrono::steady_clock::now();
+    for (int q = 0; q < consultas; q++) {
+        string de(1, (char)('A' + q)), ate = string(1, (char)('F' + q)) + "~";
+        pelasSomas.somar(avl.agregarNomes(de, ate));
+    }
+    auto t1 = chrono::steady_clock::now();
+    for (int q = 0; q < consultas; q++) {
+        string de(1, (char)('A' + q)), ate = string(1, (char)('F' + q)) + "~";
+        percorrendo.somar(avl.agregarNomesPercorrendo(de, ate));
+    }
+    auto t2 = chrono::steady_clock::now();
+    size_t verificacao = 0;
+    for (int q = 0; q < 100000; q++) {
+        verificacao += avl.kEsimo(1 + gerador() % avl.tamanho())->idade;
+    }
+    auto t3 = chrono::steady_clock::now();
+
+    cout << consultas << " faixas de nomes sobre " << n << " pessoas (" << pelasSomas.contagem
+         << " / " << percorrendo.contagem << " pessoas somadas):" << endl;
+    cout << "  Somas das sub-arvores: " << ms(t0, t1) * 1000 / consultas << " us por faixa" << endl;
+    cout << "  Percorrendo a arvore:  " << ms(t1, t2) * 1000 / consultas << " us por faixa" << endl;
+    cout << "k-esima pessoa: " << ms(t2, t3) * 10 << " ns por consulta (verificacao "
+         << verificacao << ")" << endl;
+}
+
+/**
+ * @brief Grava um CSV com n pessoas (com algumas linhas inválidas e nomes
+ * repetidos) e compara importar() com n chamadas de inserir().
+ */
+void comparativoImportacao(int n) {
+    const string caminho = "comparativo_importacao.csv";
+    mt19937 gerador(19);
+    {
+        FILE* arquivo = fopen(caminho.c_str(), "w");
+        if (arquivo == nullptr) {
+            cout << "Erro: nao foi possivel criar " << caminho << endl;
+            return;
+        }
+        vector<char> buffer(1 << 20);
+        setvbuf(arquivo, buffer.data(), _IOFBF, buffer.size());
+        fprintf(arquivo, "nome,sexo,idade,peso\n");
+        for (int i = 0; i < n; i++) {
+            if (i % 1000 == 999) {
+                fprintf(arquivo, "P%09u,X,30,70.0\n", (unsigned)gerador()); // Sexo inválido
+                continue;
+            }
+            fprintf(arquivo, "P%09u,%c,%d,%.1f\n", (unsigned)gerador() % 1000000000u,
+                    (gerador() % 2) ? 'M' : 'F', 18 + (int)(gerador() % 63),
+                    45.0 + (gerador() % 700) / 10.0);
+        }
+        fclose(arquivo);
+    }
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+
+    ArvoreAVL importada;
+    importada.definirMensagens(false);
+    auto t0 = chrono::steady_clock::now();
+    ResumoImportacao resumo = importada.importar(caminho);
+    auto t1 = chrono::steady_clock::now();
+    imprimirResumo(resumo);
+    cout << "importar(): " << ms(t0, t1) << " ms (altura " << importada.altura() << ")" << endl;
+
+    // Referência: as mesmas linhas, uma chamada de inserir() por pessoa.
+    ArquivoMapeado arquivo(caminho);
+    ResumoImportacao descartado = {0, 0, 0, 0, {}, {}, 1, 0.0, 0.0, 0.0};
+    vector<PessoaImportada> pessoas = lerPessoasEmParalelo(arquivo, descartado);
+    shuffle(pessoas.begin(), pessoas.end(), gerador); // Ordem do arquivo, sem a ordenação
+    ArvoreAVL inserida;
+    inserida.definirMensagens(false);
+    auto t2 = chrono::steady_clock::now();
+    for (const PessoaImportada& p : pessoas) inserida.inserir(p.nome, p.sexo, p.idade, p.peso);
+    auto t3 = chrono::steady_clock::now();
+    cout << "inserir() um a um: " << ms(t2, t3) << " ms (altura " << inserida.altura() << ", "
+         << inserida.tamanho() << " pessoas)" << endl;
+    remove(caminho.c_str());
+}
+
+/**
+ * @brief Gera n comandos (metade INSERT, 30% GET, 20% REMOVE) num arquivo
+ * e mede executarLote() sobre ele, com a saída num arquivo temporário;
+ * depois mede n GETs sobre o resultado (só consultas pela tabela de hash).
+ */
+void comparativoLote(int n) {
+    const string comandos = "comparativo_lote.txt", respostas = "comparativo_lote.saida";
+    mt19937 gerador(23);
+    {
+        FILE* arquivo = fopen(comandos.c_str(), "w");
+        if (arquivo == nullptr) {
+            cout << "Erro: nao foi possivel criar " << comandos << endl;
+            return;
+        }
+        vector<char> buffer(1 << 20);
+        setvbuf(arquivo, buffer.data(), _IOFBF, buffer.size());
+        int inseridos = 0;
+        for (int i = 0; i < n; i++) {
+            unsigned sorteio = gerador() % 10;
+            if (sorteio < 5 || inseridos == 0) {
+                fprintf(arquivo, "INSERT Pessoa %08d %c %d %.1f\n", inseridos++,
+                        (gerador() % 2) ? 'M' : 'F', 18 + (int)(gerador() % 63),
+                        45.0 + (gerador() % 700) / 10.0);
+            } else if (sorteio < 8) {
+                fprintf(arquivo, "GET Pessoa %08d\n", (int)(gerador() % inseridos));
+            } else {
+                fprintf(arquivo, "REMOVE Pessoa %08d\n", (int)(gerador() % inseridos));
+            }
+        }
+        fclose(arquivo);
+    }
+
+    FILE* entrada = fopen(comandos.c_str(), "r");
+    FILE* saida = fopen(respostas.c_str(), "w");
+    if (entrada == nullptr || saida == nullptr) {
+        cout << "Erro: nao foi possivel abrir os arquivos do comparativo." << endl;
+        if (entrada) fclose(entrada);
+        if (saida) fclose(saida);
+        return;
+    }
+    ArvoreAVL avl;
+    ResumoLote resumo = executarLote(avl, entrada, saida);
+    fclose(entrada);
+    fclose(saida);
+    cout << "Misto:    " << resumo.comandos << " comandos em " << resumo.ms << " ms ("
+         << resumo.comandos / (resumo.ms / 1000.0) << " comandos/s, " << resumo.erros
+         << " erros, " << avl.tamanho() << " pessoas no fim)" << endl;
+
+    // Só GETs de nomes cadastrados.
+    vector<const NoArvore*> cadastrados;
+    avl.visitarEmOrdem([&cadastrados](const NoArvore* no) { cadastrados.push_back(no); });
+    entrada = fopen(comandos.c_str(), "w");
+    for (int i = 0; i < n && !cadastrados.empty(); i++) {
+        string_view nome = cadastrados[gerador() % cadastrados.size()]->nome;
+        fprintf(entrada, "GET %.*s\n", (int)nome.size(), nome.data());
+    }
+    fclose(entrada);
+    entrada = fopen(comandos.c_str(), "r");
+    saida = fopen(respostas.c_str(), "w");
+    resumo = executarLote(avl, entrada, saida);
+    fclose(entrada);
+    fclose(saida);
+    cout << "Consulta: " << resumo.comandos << " comandos em " << resumo.ms << " ms ("
+         << resumo.comandos / (resumo.ms / 1000.0) << " comandos/s)" << endl;
+    remove(comandos.c_str());
+    remove(respostas.c_str());
+}
+
+/**
+ * @brief Autocompletar: latência de visitarPrefixo() (10 primeiros nomes)
+ * para prefixos de 1 a 3 letras tirados de nomes cadastrados, comparada
+ * com visitarIntervalo(), que percorre a faixa inteira do prefixo.
+ */
+void comparativoPrefixo(int n) {
+    const string caminho = "comparativo_prefixo.csv";
+    mt19937 gerador(31);
+    {
+        FILE* arquivo = fopen(caminho.c_str(), "w");
+        if (arquivo == nullptr) {
+            cout << "Erro: nao foi possivel criar " << caminho << endl;
+            return;
+        }
+        vector<char> buffer(1 << 20);
+        setvbuf(arquivo, buffer.data(), _IOFBF, buffer.size());
+        char nome[16];
+        for (int i = 0; i < n; i++) {
+            int letras = 4 + (int)(gerador() % 6);
+            nome[0] = (char)('A' + gerador() % 26);
+            for (int j = 1; j < letras; j++) nome[j] = (char)('a' + gerador() % 26);
+            nome[letras] = '\0';
+            fprintf(arquivo, "%s %d,%c,%d,%.1f\n", nome, i, (gerador() % 2) ? 'M' : 'F',
+                    18 + (int)(gerador() % 63), 45.0 + (gerador() % 700) / 10.0);
+        }
+        fclose(arquivo);
+    }
+    ArvoreAVL avl;
+    avl.definirMensagens(false);
+    auto t0 = chrono::steady_clock::now();
+    avl.importar(caminho);
+    auto t1 = chrono::steady_clock::now();
+    remove(caminho.c_str());
+    cout << avl.tamanho() << " nomes importados em " << chrono::duration<double, milli>(t1 - t0).count()
+         << " ms (altura " << avl.altura() << ")" << endl;
+    if (avl.tamanho() == 0) {
+        return;
+    }
+
+    const size_t k = 10;
+    const int consultas = 200000;
+    for (size_t letras = 1; letras <= 3; letras++) {
+        vector<string> prefixos(consultas);
+        for (string& p : prefixos) p = string(avl.kEsimo(1 + gerador() % avl.tamanho())->nome.substr(0, letras));
+
+        vector<float> latencias;
+        latencias.reserve(consultas);
+        size_t encontrados = 0;
+        for (const string& p : prefixos) {
+            auto a = chrono::steady_clock::now();
+            encontrados += avl.visitarPrefixo(p, k, [](const NoArvore* no) { (void)no; });
+            auto b = chrono::steady_clock::now();
+            latencias.push_back(chrono::duration<float, micro>(b - a).count());
+        }
+        sort(latencias.begin(), latencias.end());
+        auto percentil = [&latencias](double q) { return latencias[(size_t)(q * (latencias.size() - 1))]; };
+
+        // Referência: a faixa inteira do prefixo (não para nos k primeiros).
+        int repeticoes = (letras == 1) ? 20 : 200;
+        size_t naFaixa = 0;
+        auto c = chrono::steady_clock::now();
+        for (int i = 0; i < repeticoes; i++) {
+            const string& p = prefixos[i];
+            avl.visitarIntervalo(p, p + string(16, '\xff'), [&naFaixa](const NoArvore* no) {
+                (void)no;
+                naFaixa++;
+            });
+        }
+        auto d = chrono::steady_clock::now();
+        cout << "Prefixo de " << letras << " letra(s): p50 " << percentil(0.50) << " us | p99 "
+             << percentil(0.99) << " us | max " << latencias.back() << " us ("
+             << (double)encontrados / consultas << " nomes por consulta)" << endl;
+        cout << "  faixa inteira: " << chrono::duration<double, micro>(d - c).count() / repeticoes
+             << " us por consulta (" << naFaixa / repeticoes << " nomes)" << endl;
+    }
+}
+
+#ifndef _WIN32
+// Apaga a pasta de dados do comparativo (só arquivos, sem subpastas).
+void apagarPastaDeDados(const string& pasta) {
+    DIR* d = opendir(pasta.c_str());
+    if (d == nullptr) {
+        return;
+    }
+    vector<string> arquivos;
+    while (dirent* e = readdir(d)) {
+        if (e->d_name[0] != '.') arquivos.push_back(pasta + "/" + e->d_name);
+    }
+    closedir(d);
+    for (const string& caminho : arquivos) unlink(caminho.c_str());
+    rmdir(pasta.c_str());
+}
+
+/**
+ * @brief Escritas duráveis: inserções confirmadas a cada 1, 100 e 10000
+ * operações, e com 4 threads confirmando cada operação (a confirmação
+ * em grupo junta as que chegam juntas). Depois mede a recuperação só
+ * pelo diário e por snapshot + final do diário.
+ */
+void comparativoDiario(int n) {
+    const string pasta = "comparativo_diario";
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    char nome[32];
+    mt19937 gerador(29);
+    auto inserirPessoa = [&nome, &gerador](ArvoreAVL& avl, int i) {
+        snprintf(nome, sizeof(nome), "Pessoa %08d", i);
+        avl.inserir(nome, (gerador() % 2) ? 'M' : 'F', 18 + (int)(gerador() % 63), 45.0 + (gerador() % 700) / 10.0);
+    };
+    apagarPastaDeDados(pasta);
+
+    for (int grupo : {1, 100, 10000}) {
+        int total = (grupo == 1) ? min(n, 2000) : n; // Um fdatasync por operação é lento
+        ArvoreAVL avl;
+        avl.definirMensagens(false);
+        Persistencia persistencia(pasta);
+        persistencia.recuperar(avl);
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < total; i++) {
+            inserirPessoa(avl, i);
+            if ((i + 1) % grupo == 0) persistencia.confirmar();
+        }
+        persistencia.confirmar();
+        auto t1 = chrono::steady_clock::now();
+        cout << "Grupo de " << grupo << ": " << total << " insercoes em " << ms(t0, t1) << " ms ("
+             << total / (ms(t0, t1) / 1000.0) << " ops/s, " << persistencia.totalDeSincronizacoes()
+             << " fdatasync)" << endl;
+        apagarPastaDeDados(pasta);
+    }
+
+    // Cada thread só segue depois de a sua operação estar no disco.
+    {
+        const int threads = 4;
+        ArvoreAVL avl;
+        avl.definirMensagens(false);
+        Persistencia persistencia(pasta);
+        persistencia.recuperar(avl);
+        mutex travaArvore;
+        int total = min(n, 20000);
+        auto t0 = chrono::steady_clock::now();
+        vector<thread> trabalhadoras;
+        for (int t = 0; t < threads; t++) {
+            trabalhadoras.emplace_back([&, t] {
+                char meu[32];
+                for (int i = t; i < total; i += threads) {
+                    snprintf(meu, sizeof(meu), "Pessoa %08d", i);
+                    {
+                        lock_guard<mutex> guarda(travaArvore);
+                        avl.inserir(meu, 'F', 30, 60.0);
+                    }
+                    persistencia.confirmar();
+                }
+            });
+        }
+        for (thread& t : trabalhadoras) t.join();
+        auto t1 = chrono::steady_clock::now();
+        cout << threads << " threads, confirmando cada operacao: " << total << " insercoes em " << ms(t0, t1)
+             << " ms (" << total / (ms(t0, t1) / 1000.0) << " ops/s, " << persistencia.totalDeSincronizacoes()
+             << " fdatasync)" << endl;
+        apagarPastaDeDados(pasta);
+    }
+
+    // Recuperação: n operações só no diário; depois snapshot + n/10 no diário.
+    {
+        ArvoreAVL avl;
+        avl.definirMensagens(false);
+        Persistencia persistencia(pasta);
+        persistencia.recuperar(avl);
+        for (int i = 0; i < n; i++) {
+            inserirPessoa(avl, i);
+            if (i % 10 == 9) avl.remover(nome); // 10% de remoções
+        }
+        persistencia.confirmar();
+    }
+    {
+        ArvoreAVL avl;
+        avl.definirMensagens(false);
+        Persistencia persistencia(pasta);
+        ResumoRecuperacao r = persistencia.recuperar(avl);
+        cout << "So diario:           ";
+        imprimirRecuperacao(cout, r);
+        auto t0 = chrono::steady_clock::now();
+        persistencia.tirarSnapshot(avl);
+        auto t1 = chrono::steady_clock::now();
+        cout << "Snapshot de " << avl.tamanho() << " pessoas: " << ms(t0, t1) << " ms" << endl;
+        for (int i = n; i < n + n / 10; i++) inserirPessoa(avl, i);
+        persistencia.confirmar();
+    }
+    {
+        ArvoreAVL avl;
+        avl.definirMensagens(false);
+        Persistencia persistencia(pasta);
+        ResumoRecuperacao r = persistencia.recuperar(avl);
+        cout << "Snapshot + diario:   ";
+        imprimirRecuperacao(cout, r);
+        cout << "(" << avl.tamanho() << " pessoas, altura " << avl.altura() << ")" << endl;
+    }
+    apagarPastaDeDados(pasta);
+}
+#endif
+
 // --- Função Principal (Menu de Opções) ---
-int main() {
+int main(int argc, char** argv) {
+    // --dados <pasta> (modos lote e servidor): tira o par de argv.
+    const char* pastaDados = nullptr;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--dados") {
+            pastaDados = argv[i + 1];
+            for (int j = i; j + 2 <= argc; j++) argv[j] = argv[j + 2];
+            argc -= 2;
+            break;
+        }
+    }
+    // Modo comparativo: ./B1_2 --benchmark-colunas [n]
+    if (argc > 1 && string(argv[1]) == "--benchmark-colunas") {
+        comparativoColunas(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    // Modo comparativo: ./B1_2 --benchmark-nomes [n]
+    if (argc > 1 && string(argv[1]) == "--benchmark-nomes") {
+        comparativoNomes(argc > 2 ? atoi(argv[2]) : 10000000);
+        return 0;
+    }
+    // Modo comparativo: ./B1_2 --benchmark-hash [n]
+    if (argc > 1 && string(argv[1]) == "--benchmark-hash") {
+        comparativoHash(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    // Modo comparativo: ./B1_2 --benchmark-agregados [n]
+    if (argc > 1 && string(argv[1]) == "--benchmark-agregados") {
+        comparativoAgregados(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    // Modo comparativo: ./B1_2 --benchmark-importacao [n]
+    if (argc > 1 && string(argv[1]) == "--benchmark-importacao") {
+        comparativoImportacao(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    // Modo comparativo: ./B1_2 --benchmark-lote [n]
+    if (argc > 1 && string(argv[1]) == "--benchmark-lote") {
+        comparativoLote(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    // Modo comparativo: ./B1_2 --benchmark-prefixo [n]
+    if (argc > 1 && string(argv[1]) == "--benchmark-prefixo") {
+        comparativoPrefixo(argc > 2 ? atoi(argv[2]) : 10000000);
+        return 0;
+    }
+#ifndef _WIN32
+    // Modo comparativo: ./B1_2 --benchmark-diario [n]
+    if (argc > 1 && string(argv[1]) == "--benchmark-diario") {
+        comparativoDiario(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+#endif
+#ifdef __linux__
+    // Servidor: ./B1_2 --servidor <socket> [threads] [carga.csv] [--dados <pasta>]
+    if (argc > 2 && string(argv[1]) == "--servidor") {
+        ArvoreAVL avl;
+        unique_ptr<Persistencia> persistencia;
+        unsigned threads = (argc > 3) ? (unsigned)max(1, atoi(argv[3])) : max(1u, thread::hardware_concurrency());
+        try {
+            if (pastaDados != nullptr) {
+                persistencia.reset(new Persistencia(pastaDados));
+                imprimirRecuperacao(cout, persistencia->recuperar(avl));
+            }
+            if (argc > 4) {
+                imprimirResumo(avl.importar(argv[4]));
+                if (persistencia) persistencia->confirmar();
+            }
+            ServidorRegistro servidor(avl, argv[2], persistencia.get());
+            struct sigaction acao = {};
+            acao.sa_handler = pararServidor;
+            sigaction(SIGINT, &acao, nullptr);
+            sigaction(SIGTERM, &acao, nullptr);
+            cout << "Servidor em " << argv[2] << " (" << threads << " threads). Ctrl+C para parar." << endl;
+            servidor.executar(threads);
+            cout << "Servidor parado: " << servidor.totalDeComandos() << " comandos, "
+                 << avl.tamanho() << " pessoas." << endl;
+        } catch (const exception& e) {
+            cout << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    // Gerador de carga: ./B1_2 --cliente <socket> [conexoes] [requisicoes] [profundidade]
+    if (argc > 2 && string(argv[1]) == "--cliente") {
+        clienteDeCarga(argv[2], argc > 3 ? max(1, atoi(argv[3])) : 4,
+                       argc > 4 ? max(1, atoi(argv[4])) : 200000,
+                       argc > 5 ? max(1, atoi(argv[5])) : 32);
+        return 0;
+    }
+#endif
+    // Modo lote: ./B1_2 --lote [arquivo] [--dados <pasta>] (sem arquivo ou "-": stdin)
+    if (argc > 1 && string(argv[1]) == "--lote") {
+        FILE* entrada = stdin;
+        if (argc > 2 && string(argv[2]) != "-") {
+            entrada = fopen(argv[2], "r");
+            if (entrada == nullptr) {
+                fprintf(stderr, "Erro: nao foi possivel abrir %s\n", argv[2]);
+                return 1;
+            }
+        }
+        ArvoreAVL avl;
+        function<void()> antesDeEnviar;
+#ifndef _WIN32
+        unique_ptr<Persistencia> persistencia;
+        if (pastaDados != nullptr) {
+            try {
+                persistencia.reset(new Persistencia(pastaDados));
+                imprimirRecuperacao(cerr, persistencia->recuperar(avl));
+            } catch (const exception& e) {
+                fprintf(stderr, "%s\n", e.what());
+                return 1;
+            }
+            // Cada bloco de respostas só sai depois de confirmado no diário;
+            // se o disco falhar, sai sem mostrar as respostas pendentes.
+            antesDeEnviar = [&persistencia, &avl] {
+                try {
+                    persistencia->confirmar();
+                    if (persistencia->precisaSnapshot()) persistencia->tirarSnapshot(avl);
+                } catch (const exception& e) {
+                    fprintf(stderr, "%s\n", e.what());
+                    exit(1);
+                }
+            };
+        }
+#endif
+        ResumoLote resumo = executarLote(avl, entrada, stdout, antesDeEnviar);
+        if (entrada != stdin) fclose(entrada);
+        fprintf(stderr, "%zu comandos, %zu erros, %.1f ms\n", resumo.comandos, resumo.erros, resumo.ms);
+        return resumo.erros ? 2 : 0;
+    }
+    // Modo comparativo: ./B1_2 --benchmark-indices [n]
+    if (argc > 1 && string(argv[1]) == "--benchmark-indices") {
+        comparativoIndices(argc > 2 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+
     ArvoreAVL avl;
+    avl.ativarIndices(true, true); // Consultas por faixa de idade/peso
     int opcao = -1;
 
-    // Dados de exemplo para popular a árvore
-    avl.inserir("Mario", 'M', 30, 80.5);
-    avl.inserir("Ana", 'F', 25, 60.0);
-    avl.inserir("Bruno", 'M', 40, 90.1);
-    avl.inserir("Silvia", 'F', 22, 55.3);
-    avl.inserir("Carlos", 'M', 50, 78.0);
-    avl.inserir("Zelia", 'F', 45, 70.0); // Causa rotação
-    
-    cout << "Arvore AVL populada com dados iniciais." << endl;
+    if (argc > 2 && string(argv[1]) == "--importar") {
+        // Carga inicial: ./B1_2 --importar pessoas.csv
+        try {
+            imprimirResumo(avl.importar(argv[2]));
+        } catch (const exception& e) {
+            cout << e.what() << endl;
+            return 1;
+        }
+    } else {
+        // Dados de exemplo para popular a árvore
+        avl.inserir("Mario", 'M', 30, 80.5);
+        avl.inserir("Ana", 'F', 25, 60.0);
+        avl.inserir("Bruno", 'M', 40, 90.1);
+        avl.inserir("Silvia", 'F', 22, 55.3);
+        avl.inserir("Carlos", 'M', 50, 78.0);
+        avl.inserir("Zelia", 'F', 45, 70.0); // Causa rotação
+
+        cout << "Arvore AVL populada com dados iniciais." << endl;
+    }
 
     while (opcao != 0) {
         cout << "\n========== Menu Arvore AVL ==========" << endl;
@@ -407,6 +4015,13 @@ int main() {
         cout << "2. Listar (F2 - Em-Ordem)" << endl;
         cout << "3. Remover (F3)" << endl;
         cout << "4. Consultar (F4)" << endl;
+        cout << "5. Estatisticas (filtro por sexo/idade/peso)" << endl;
+        cout << "6. Listar por faixa de idade" << endl;
+        cout << "7. Listar por faixa de peso" << endl;
+        cout << "8. Estatisticas por faixa de nomes" << endl;
+        cout << "9. k-esima pessoa em ordem alfabetica" << endl;
+        cout << "10. Importar arquivo CSV/TSV" << endl;
+        cout << "11. Buscar por prefixo do nome" << endl;
         cout << "0. Sair" << endl;
         cout << "=====================================" << endl;
         cout << "Escolha uma opcao: ";
@@ -425,8 +4040,9 @@ int main() {
                 char sexo = getChar("Sexo (M/F): ");
                 int idade = getInt("Idade: ");
                 double peso = getDouble("Peso (kg): ");
-                avl.inserir(nome, sexo, idade, peso);
-                cout << "Info: " << nome << " inserido(a) com sucesso." << endl;
+                if (avl.inserir(nome, sexo, idade, peso)) {
+                    cout << "Info: " << nome << " inserido(a) com sucesso." << endl;
+                }
                 break;
             }
             case 2: { // Listagem
@@ -446,6 +4062,66 @@ int main() {
                 avl.consultar(nome);
                 break;
             }
+            case 5: { // Estatísticas pelas colunas
+                cout << "\n--- Estatisticas ---" << endl;
+                FiltroPessoas filtro;
+                filtro.sexo = getFiltroSexo("Sexo (M/F, T para todos): ");
+                filtro.idadeMin = getInt("Idade minima: ");
+                filtro.idadeMax = getInt("Idade maxima: ");
+                filtro.pesoMin = getDouble("Peso minimo (kg): ");
+                filtro.pesoMax = getDouble("Peso maximo (kg): ");
+                imprimirAgregado(avl.agregar(filtro));
+                break;
+            }
+            case 6: { // Faixa de idade (índice secundário)
+                cout << "\n--- Listar por Idade ---" << endl;
+                int lo = getInt("Idade minima: ");
+                int hi = getInt("Idade maxima: ");
+                imprimirRegistros(avl.porIdade(lo, hi));
+                break;
+            }
+            case 7: { // Faixa de peso (índice secundário)
+                cout << "\n--- Listar por Peso ---" << endl;
+                double lo = getDouble("Peso minimo (kg): ");
+                double hi = getDouble("Peso maximo (kg): ");
+                imprimirRegistros(avl.porPeso(lo, hi));
+                break;
+            }
+            case 8: { // Faixa de nomes (somas das sub-árvores)
+                cout << "\n--- Estatisticas por Nome ---" << endl;
+                string de = getString("Do nome: ");
+                string ate = getString("Ate o nome: ");
+                imprimirSoma(avl.agregarNomes(de, ate));
+                break;
+            }
+            case 9: { // k-ésima pessoa
+                cout << "\n--- k-esima Pessoa ---" << endl;
+                int k = getInt("Posicao (1 = primeira): ");
+                const NoArvore* no = avl.kEsimo(k);
+                if (no != nullptr) {
+                    imprimirRegistros(vector<const NoArvore*>(1, no));
+                } else {
+                    cout << "Info: ha apenas " << avl.tamanho() << " pessoas." << endl;
+                }
+                break;
+            }
+            case 10: { // Importação em lote
+                cout << "\n--- Importar Arquivo ---" << endl;
+                string caminho = getString("Arquivo (nome,sexo,idade,peso): ");
+                try {
+                    imprimirResumo(avl.importar(caminho));
+                } catch (const exception& e) {
+                    cout << e.what() << endl;
+                }
+                break;
+            }
+            case 11: { // Autocompletar
+                cout << "\n--- Buscar por Prefixo ---" << endl;
+                string prefixo = getString("Comeco do nome: ");
+                int k = getInt("Quantos nomes (no maximo): ");
+                imprimirRegistros(avl.completar(prefixo, (size_t)max(k, 0)));
+                break;
+            }
             case 0:
                 cout << "Saindo do programa..." << endl;
                 break;
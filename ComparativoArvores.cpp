@@ -0,0 +1,632 @@
+/**
+ * Comparativo de desempenho entre as árvores do projeto.
+ *
+ * Todas as árvores (A1, A2, A4, A5, B1_2 e a B+) e, como referência,
+ * std::set / std::multiset recebem exatamente a mesma sequência de
+ * operações em quatro cargas:
+ *  - aleatoria: n inserções de chaves uniformes, depois n consultas;
+ *  - ordenada:  n inserções crescentes (pior caso das árvores sem
+ *               balanceamento), depois n consultas;
+ *  - zipf:      n inserções e n consultas com chaves repetidas seguindo
+ *               uma distribuição de Zipf (poucas chaves muito frequentes);
+ *  - mista:     árvore pré-carregada com n/2 chaves, depois n operações
+ *               (50% consultas, 25% inserções, 25% remoções).
+ * Para cada (árvore, carga, n) são medidos: ns por operação, latências
+ * p50/p99 (por amostragem), pico de memória alocada e altura final.
+ *
+ * Os programas originais são incluídos aqui, cada um no seu namespace,
+ * com o 'main' renomeado. Compilar na raiz do repositório:
+ *   g++ -O2 -std=c++17 -pthread ComparativoArvores.cpp -o comparativo
+ * Uso:
+ *   ./comparativo [--tamanhos 1000,10000,100000] [--csv saida.csv]
+ *                 [--json saida.json] [--limite-degenerada 20000]
+ */
+
+// Cabeçalhos usados pelos programas incluídos: precisam vir antes, fora
+// dos namespaces, para que os #include de dentro deles não tenham efeito.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <climits>
+#include <thread>
+#include <iterator>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <charconv>
+#include <string_view>
+#include <shared_mutex>
+#include <cerrno>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <dirent.h>
+#endif
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <signal.h>
+#endif
+
+// -----------------------------------------------------------------
+// CONTAGEM DE MEMÓRIA (substitui o operator new global)
+// -----------------------------------------------------------------
+
+/**
+ * Toda alocação feita com new (inclusive a dos contêineres da std e dos
+ * pools) guarda o próprio tamanho num prefixo de 16 bytes, o que permite
+ * saber quantos bytes estão em uso e o pico desde a última medição.
+ */
+namespace memoria {
+std::atomic<long long> emUso(0);
+std::atomic<long long> pico(0);
+
+const size_t PREFIXO = 16; // Mantém o alinhamento de malloc
+
+void registrar(long long delta) {
+    long long atual = emUso.fetch_add(delta, std::memory_order_relaxed) + delta;
+    long long anterior = pico.load(std::memory_order_relaxed);
+    while (atual > anterior &&
+           !pico.compare_exchange_weak(anterior, atual, std::memory_order_relaxed)) {
+    }
+}
+} // namespace memoria
+
+void* operator new(size_t n) {
+    char* p = static_cast<char*>(std::malloc(n + memoria::PREFIXO));
+    if (p == nullptr) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(p) = n;
+    memoria::registrar((long long)n);
+    return p + memoria::PREFIXO;
+}
+
+void operator delete(void* p) noexcept {
+    if (p == nullptr) return;
+    char* base = static_cast<char*>(p) - memoria::PREFIXO;
+    memoria::registrar(-(long long)*reinterpret_cast<size_t*>(base));
+    std::free(base);
+}
+
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+// Tipos com alignas maior que 16 (nós da B+) usam as versões alinhadas.
+// Só malloc/free (aligned_alloc não existe no MinGW): sobra espaço para
+// alinhar, e os 16 bytes antes do ponteiro devolvido guardam o tamanho e
+// o endereço que o malloc devolveu.
+void* operator new(size_t n, std::align_val_t alinhamento) {
+    size_t a = std::max(memoria::PREFIXO, (size_t)alinhamento);
+    char* base = static_cast<char*>(std::malloc(n + memoria::PREFIXO + a));
+    if (base == nullptr) throw std::bad_alloc();
+    uintptr_t inicio = reinterpret_cast<uintptr_t>(base) + memoria::PREFIXO;
+    char* p = reinterpret_cast<char*>((inicio + a - 1) / a * a);
+    reinterpret_cast<size_t*>(p)[-2] = n;
+    reinterpret_cast<char**>(p)[-1] = base;
+    memoria::registrar((long long)n);
+    return p;
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    if (p == nullptr) return;
+    memoria::registrar(-(long long)static_cast<size_t*>(p)[-2]);
+    std::free(static_cast<char**>(p)[-1]);
+}
+
+void* operator new[](size_t n, std::align_val_t a) { return operator new(n, a); }
+void operator delete[](void* p, std::align_val_t a) noexcept { operator delete(p, a); }
+void operator delete(void* p, size_t, std::align_val_t a) noexcept { operator delete(p, a); }
+void operator delete[](void* p, size_t, std::align_val_t a) noexcept { operator delete(p, a); }
+
+void* operator new(size_t n, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(n);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](size_t n, const std::nothrow_t&) noexcept {
+    return operator new(n, std::nothrow);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept { operator delete(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { operator delete(p); }
+
+// -----------------------------------------------------------------
+// PROGRAMAS INCLUÍDOS (cada um no seu namespace)
+// -----------------------------------------------------------------
+
+namespace a1 {
+#define main main_a1
+#include "A1.cpp"
+#undef main
+}
+
+namespace a2 {
+#define main main_a2
+#include "A2.cpp"
+#undef main
+}
+
+namespace a4 {
+#define main main_a4
+#include "A4.cpp"
+#undef main
+}
+
+namespace a5 {
+#define main main_a5
+#include "A5.cpp"
+#undef main
+}
+
+namespace b12 {
+#define main main_b12
+#include "B1_2.cpp"
+#undef main
+}
+
+namespace bmais {
+#define main main_bmais
+#include "ArvoreBMais.cpp"
+#undef main
+}
+
+using namespace std;
+
+// -----------------------------------------------------------------
+// ADAPTADORES (mesma interface para todas as árvores)
+// -----------------------------------------------------------------
+//
+// Cada motor expõe inserir/remover/contem/altura e três propriedades:
+//  - temRemocao: a árvore oferece remoção (A2 e A5 não oferecem);
+//  - balanceada: garante altura O(log n) (as outras degeneram na carga
+//    ordenada e são limitadas a --limite-degenerada chaves);
+//  - repeticoesEmCadeia: cada repetição vira um nó novo à direita (A2 e
+//    A5), o que também degenera na carga zipf.
+// altura() = -1 quando a estrutura não expõe a altura (std::set).
+
+struct MotorSet {
+    static const bool temRemocao = true;
+    static const bool balanceada = true;
+    static const bool repeticoesEmCadeia = false;
+    set<int> s;
+    void inserir(int v) { s.insert(v); }
+    void remover(int v) { s.erase(v); }
+    bool contem(int v) { return s.find(v) != s.end(); }
+    int altura() { return -1; }
+};
+
+struct MotorMultiset {
+    static const bool temRemocao = true;
+    static const bool balanceada = true;
+    static const bool repeticoesEmCadeia = false;
+    multiset<int> s;
+    void inserir(int v) { s.insert(v); }
+    void remover(int v) {
+        auto it = s.find(v);
+        if (it != s.end()) s.erase(it); // Remove uma ocorrência, como A4
+    }
+    bool contem(int v) { return s.find(v) != s.end(); } // count() seria O(repetições)
+    int altura() { return -1; }
+};
+
+// Árvores que já têm inserir/remover/contem/altura (A1, B+).
+template <typename Arvore, bool Balanceada>
+struct MotorPadrao {
+    static const bool temRemocao = true;
+    static const bool balanceada = Balanceada;
+    static const bool repeticoesEmCadeia = false;
+    Arvore a;
+    void inserir(int v) { a.inserir(v); }
+    void remover(int v) { a.remover(v); }
+    bool contem(int v) { return a.contem(v); }
+    int altura() { return a.altura(); }
+};
+
+// B+ no modo multiconjunto (contador por chave, como A4).
+struct MotorBMaisMulti {
+    static const bool temRemocao = true;
+    static const bool balanceada = true;
+    static const bool repeticoesEmCadeia = false;
+    bmais::ArvoreBMais a{true};
+    void inserir(int v) { a.inserir(v); }
+    void remover(int v) { a.remover(v); }
+    bool contem(int v) { return a.contem(v); }
+    int altura() { return a.altura(); }
+};
+
+// Exercícios que só implementam inserção (A2, A5).
+template <typename Arvore>
+struct MotorSemRemocao {
+    static const bool temRemocao = false;
+    static const bool balanceada = false;
+    static const bool repeticoesEmCadeia = true;
+    Arvore a;
+    void inserir(int v) { a.inserir(v); }
+    void remover(int) {}
+    bool contem(int v) { return a.contem(v); }
+    int altura() { return a.altura(); }
+};
+
+// Árvores com contador de ocorrências (A4).
+template <typename Arvore>
+struct MotorContador {
+    static const bool temRemocao = true;
+    static const bool balanceada = false;
+    static const bool repeticoesEmCadeia = false;
+    Arvore a;
+    void inserir(int v) { a.inserir(v); }
+    void remover(int v) { a.remover(v); }
+    bool contem(int v) { return a.contar(v) > 0; }
+    int altura() { return a.altura(); }
+};
+
+/**
+ * AVL de pessoas do B1_2, indexada por nome: a chave inteira vira um nome
+ * de 10 dígitos com zeros à esquerda, que preserva a ordem numérica.
+ * A conversão faz parte do custo medido (é o que um chamador pagaria).
+ */
+struct MotorAVLNomes {
+    static const bool temRemocao = true;
+    static const bool balanceada = true;
+    static const bool repeticoesEmCadeia = false;
+    b12::ArvoreAVL a;
+    MotorAVLNomes() { a.definirMensagens(false); }
+    static string nome(int v) {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%010d", v);
+        return buffer;
+    }
+    void inserir(int v) { a.inserir(nome(v), 'M', 30, 70.0); }
+    void remover(int v) { a.remover(nome(v)); }
+    bool contem(int v) { return a.contem(nome(v)); }
+    int altura() { return a.altura(); }
+};
+
+// -----------------------------------------------------------------
+// CARGAS DE TRABALHO
+// -----------------------------------------------------------------
+
+enum TipoOperacao : uint8_t { INSERIR, REMOVER, CONSULTAR };
+
+struct Operacao {
+    TipoOperacao tipo;
+    int chave;
+};
+
+struct Carga {
+    string nome;
+    size_t n;
+    bool temRemocoes;
+    vector<Operacao> preparo; // Executadas antes da medição
+    vector<Operacao> medidas; // Executadas e medidas
+};
+
+/**
+ * @brief Sorteia postos 0..m-1 com P(k) proporcional a 1/(k+1)^s, por
+ * busca binária na distribuição acumulada.
+ */
+class GeradorZipf {
+private:
+    vector<double> acumulada;
+    uniform_real_distribution<double> uniforme;
+
+public:
+    GeradorZipf(size_t m, double s) : acumulada(m), uniforme(0.0, 1.0) {
+        double soma = 0;
+        for (size_t k = 0; k < m; k++) {
+            soma += 1.0 / pow((double)(k + 1), s);
+            acumulada[k] = soma;
+        }
+        for (double& a : acumulada) a /= soma;
+    }
+
+    template <typename Gerador>
+    size_t sortear(Gerador& g) {
+        double u = uniforme(g);
+        size_t k = lower_bound(acumulada.begin(), acumulada.end(), u) - acumulada.begin();
+        return min(k, acumulada.size() - 1);
+    }
+};
+
+Carga cargaAleatoria(size_t n) {
+    Carga c{"aleatoria", n, false, {}, {}};
+    mt19937 g(42);
+    uniform_int_distribution<int> chave(0, (int)min<size_t>(4 * n, INT_MAX));
+    vector<int> inseridas(n);
+    for (size_t i = 0; i < n; i++) {
+        inseridas[i] = chave(g);
+        c.medidas.push_back({INSERIR, inseridas[i]});
+    }
+    // Metade das consultas acerta chaves inseridas, metade é uniforme.
+    for (size_t i = 0; i < n; i++) {
+        int v = (i % 2 == 0) ? inseridas[g() % n] : chave(g);
+        c.medidas.push_back({CONSULTAR, v});
+    }
+    return c;
+}
+
+Carga cargaOrdenada(size_t n) {
+    Carga c{"ordenada", n, false, {}, {}};
+    mt19937 g(42);
+    for (size_t i = 0; i < n; i++) {
+        c.medidas.push_back({INSERIR, (int)i});
+    }
+    for (size_t i = 0; i < n; i++) {
+        c.medidas.push_back({CONSULTAR, (int)(g() % (2 * n))});
+    }
+    return c;
+}
+
+Carga cargaZipf(size_t n) {
+    Carga c{"zipf", n, false, {}, {}};
+    mt19937 g(42);
+    // n/10 chaves distintas, espalhadas por uma permutação aleatória para
+    // que as mais frequentes não sejam as menores.
+    size_t m = max<size_t>(1, n / 10);
+    vector<int> chaveDoPosto(m);
+    for (size_t k = 0; k < m; k++) chaveDoPosto[k] = (int)(k * 7);
+    shuffle(chaveDoPosto.begin(), chaveDoPosto.end(), g);
+    GeradorZipf zipf(m, 0.99);
+    for (size_t i = 0; i < n; i++) {
+        c.medidas.push_back({INSERIR, chaveDoPosto[zipf.sortear(g)]});
+    }
+    for (size_t i = 0; i < n; i++) {
+        c.medidas.push_back({CONSULTAR, chaveDoPosto[zipf.sortear(g)]});
+    }
+    return c;
+}
+
+Carga cargaMista(size_t n) {
+    Carga c{"mista", n, true, {}, {}};
+    mt19937 g(42);
+    uniform_int_distribution<int> chave(0, (int)min<size_t>(2 * n, INT_MAX));
+    for (size_t i = 0; i < n / 2; i++) {
+        c.preparo.push_back({INSERIR, chave(g)});
+    }
+    for (size_t i = 0; i < n; i++) {
+        unsigned sorteio = g() % 4;
+        TipoOperacao tipo = (sorteio < 2) ? CONSULTAR : (sorteio == 2 ? INSERIR : REMOVER);
+        c.medidas.push_back({tipo, chave(g)});
+    }
+    return c;
+}
+
+// -----------------------------------------------------------------
+// MEDIÇÃO
+// -----------------------------------------------------------------
+
+struct Resultado {
+    string motor;
+    string carga;
+    size_t n;
+    size_t operacoes;
+    double nsPorOperacao;
+    double p50;
+    double p99;
+    long long picoBytes;
+    int altura;
+    long long encontrados; // Consultas com sucesso (confere motores entre si)
+    string situacao;       // "ok" ou o motivo de ter sido pulado
+};
+
+// Número máximo de latências individuais guardadas por medição.
+const size_t MAX_AMOSTRAS = 100000;
+
+template <typename Motor>
+inline void aplicar(Motor& m, const Operacao& op, long long& encontrados) {
+    switch (op.tipo) {
+        case INSERIR: m.inserir(op.chave); break;
+        case REMOVER: m.remover(op.chave); break;
+        case CONSULTAR: encontrados += m.contem(op.chave); break;
+    }
+}
+
+/**
+ * @brief Executa a carga num motor novo. O tempo total dá ns/op; uma em
+ * cada 'passo' operações é cronometrada sozinha para as latências, de modo
+ * que o custo do relógio quase não entra no total.
+ */
+template <typename Motor>
+Resultado medir(const string& nomeMotor, const Carga& carga, size_t limiteDegenerada) {
+    Resultado r{nomeMotor, carga.nome, carga.n, carga.medidas.size(), 0, 0, 0, 0, -1, 0, "ok"};
+    if (carga.temRemocoes && !Motor::temRemocao) {
+        r.situacao = "pulado: sem remocao";
+        return r;
+    }
+    bool degenera = (!Motor::balanceada && carga.nome == "ordenada") ||
+                    (Motor::repeticoesEmCadeia && carga.nome == "zipf");
+    if (degenera && carga.n > limiteDegenerada) {
+        r.situacao = "pulado: degenerada (O(n^2))";
+        return r;
+    }
+
+    size_t passo = max<size_t>(1, carga.medidas.size() / MAX_AMOSTRAS);
+    vector<double> amostras;
+    amostras.reserve(carga.medidas.size() / passo + 1);
+
+    long long base = memoria::emUso.load();
+    memoria::pico.store(base);
+    {
+        Motor motor;
+        long long ignorados = 0;
+        for (const Operacao& op : carga.preparo) aplicar(motor, op, ignorados);
+
+        auto inicio = chrono::steady_clock::now();
+        for (size_t i = 0; i < carga.medidas.size(); i++) {
+            if (i % passo == 0) {
+                auto a = chrono::steady_clock::now();
+                aplicar(motor, carga.medidas[i], r.encontrados);
+                auto b = chrono::steady_clock::now();
+                amostras.push_back(chrono::duration<double, nano>(b - a).count());
+            } else {
+                aplicar(motor, carga.medidas[i], r.encontrados);
+            }
+        }
+        auto fim = chrono::steady_clock::now();
+
+        r.nsPorOperacao = chrono::duration<double, nano>(fim - inicio).count() /
+                          max<size_t>(1, carga.medidas.size());
+        r.altura = motor.altura();
+        r.picoBytes = memoria::pico.load() - base;
+    }
+
+    sort(amostras.begin(), amostras.end());
+    if (!amostras.empty()) {
+        r.p50 = amostras[amostras.size() / 2];
+        r.p99 = amostras[min(amostras.size() - 1, amostras.size() * 99 / 100)];
+    }
+    return r;
+}
+
+void medirTodos(const Carga& c, size_t limite, vector<Resultado>& saida) {
+    saida.push_back(medir<MotorSet>("std::set", c, limite));
+    saida.push_back(medir<MotorMultiset>("std::multiset", c, limite));
+    saida.push_back(medir<MotorPadrao<a1::ArvoreBinariaBusca, false>>("A1 BST", c, limite));
+    saida.push_back(medir<MotorPadrao<a1::ArvoreIndexada, false>>("A1 Indexada", c, limite));
+    saida.push_back(medir<MotorPadrao<a1::ArvoreBalanceada, true>>("A1 Treap", c, limite));
+    saida.push_back(medir<MotorSemRemocao<a2::ArvoreBinariaBusca>>("A2 BST", c, limite));
+    saida.push_back(medir<MotorContador<a4::ArvoreBinariaBusca>>("A4 BST contador", c, limite));
+    saida.push_back(medir<MotorContador<a4::ArvoreIndexada>>("A4 Indexada contador", c, limite));
+    saida.push_back(medir<MotorSemRemocao<a5::ArvoreBinariaBusca>>("A5 BST", c, limite));
+    saida.push_back(medir<MotorAVLNomes>("B1_2 AVL (nomes)", c, limite));
+    saida.push_back(medir<MotorPadrao<bmais::ArvoreBMais, true>>("B+ conjunto", c, limite));
+    saida.push_back(medir<MotorBMaisMulti>("B+ multiconjunto", c, limite));
+}
+
+// -----------------------------------------------------------------
+// SAÍDA (tabela, CSV e JSON)
+// -----------------------------------------------------------------
+
+void imprimirTabela(const vector<Resultado>& resultados) {
+    printf("%-22s %-10s %10s %10s %10s %10s %12s %7s  %s\n", "motor", "carga", "n", "ns/op",
+           "p50 ns", "p99 ns", "pico KB", "altura", "situacao");
+    for (const Resultado& r : resultados) {
+        if (r.situacao != "ok") {
+            printf("%-22s %-10s %10zu %10s %10s %10s %12s %7s  %s\n", r.motor.c_str(),
+                   r.carga.c_str(), r.n, "-", "-", "-", "-", "-", r.situacao.c_str());
+            continue;
+        }
+        printf("%-22s %-10s %10zu %10.1f %10.0f %10.0f %12lld %7d  %s\n", r.motor.c_str(),
+               r.carga.c_str(), r.n, r.nsPorOperacao, r.p50, r.p99, r.picoBytes / 1024,
+               r.altura, r.situacao.c_str());
+    }
+}
+
+void gravarCSV(const string& caminho, const vector<Resultado>& resultados) {
+    ofstream f(caminho);
+    if (!f) throw runtime_error("Erro: nao foi possivel criar " + caminho);
+    f << "motor,carga,n,operacoes,ns_por_op,p50_ns,p99_ns,pico_bytes,altura,encontrados,situacao\n";
+    for (const Resultado& r : resultados) {
+        f << '"' << r.motor << "\"," << r.carga << ',' << r.n << ',' << r.operacoes << ','
+          << r.nsPorOperacao << ',' << r.p50 << ',' << r.p99 << ',' << r.picoBytes << ','
+          << r.altura << ',' << r.encontrados << ",\"" << r.situacao << "\"\n";
+    }
+}
+
+void gravarJSON(const string& caminho, const vector<Resultado>& resultados) {
+    ofstream f(caminho);
+    if (!f) throw runtime_error("Erro: nao foi possivel criar " + caminho);
+    f << "[\n";
+    for (size_t i = 0; i < resultados.size(); i++) {
+        const Resultado& r = resultados[i];
+        bool ok = (r.situacao == "ok");
+        f << "  {\"motor\": \"" << r.motor << "\", \"carga\": \"" << r.carga
+          << "\", \"n\": " << r.n << ", \"operacoes\": " << r.operacoes;
+        if (ok) {
+            f << ", \"ns_por_op\": " << r.nsPorOperacao << ", \"p50_ns\": " << r.p50
+              << ", \"p99_ns\": " << r.p99 << ", \"pico_bytes\": " << r.picoBytes
+              << ", \"altura\": ";
+            if (r.altura >= 0) f << r.altura; else f << "null";
+            f << ", \"encontrados\": " << r.encontrados;
+        }
+        f << ", \"situacao\": \"" << r.situacao << "\"}" << (i + 1 < resultados.size() ? "," : "")
+          << "\n";
+    }
+    f << "]\n";
+}
+
+vector<size_t> lerTamanhos(const string& lista) {
+    vector<size_t> tamanhos;
+    stringstream ss(lista);
+    string item;
+    while (getline(ss, item, ',')) {
+        double v = atof(item.c_str()); // Aceita 1e6
+        if (v < 1) throw runtime_error("Erro: tamanho invalido: " + item);
+        tamanhos.push_back((size_t)v);
+    }
+    return tamanhos;
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> tamanhos = {1000, 10000, 100000, 1000000};
+    string caminhoCSV, caminhoJSON;
+    size_t limiteDegenerada = 20000;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            bool temValor = (i + 1 < argc);
+            if (arg == "--tamanhos" && temValor) {
+                tamanhos = lerTamanhos(argv[++i]);
+            } else if (arg == "--csv" && temValor) {
+                caminhoCSV = argv[++i];
+            } else if (arg == "--json" && temValor) {
+                caminhoJSON = argv[++i];
+            } else if (arg == "--limite-degenerada" && temValor) {
+                limiteDegenerada = (size_t)atof(argv[++i]);
+            } else {
+                cout << "Uso: " << argv[0] << " [--tamanhos 1000,1e4,...] [--csv arquivo]"
+                     << " [--json arquivo] [--limite-degenerada n]" << endl;
+                return 1;
+            }
+        }
+
+        vector<Resultado> resultados;
+        for (size_t n : tamanhos) {
+            if (n > 10000000) {
+                cout << "Aviso: n = " << n << " precisa de varios GB de memoria." << endl;
+            }
+            Carga (*geradores[])(size_t) = {cargaAleatoria, cargaOrdenada, cargaZipf, cargaMista};
+            for (auto gerar : geradores) {
+                Carga c = gerar(n);
+                medirTodos(c, limiteDegenerada, resultados);
+                cout << "Concluido: " << c.nome << ", n = " << n << endl;
+            }
+        }
+
+        cout << endl;
+        imprimirTabela(resultados);
+        if (!caminhoCSV.empty()) gravarCSV(caminhoCSV, resultados);
+        if (!caminhoJSON.empty()) gravarJSON(caminhoJSON, resultados);
+    } catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}